@@ -0,0 +1,23 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+#pragma once
+
+#include <cstdint>
+
+#include <benchmark/benchmark.h>
+
+namespace yolovr_bench {
+
+// Heap allocations made through any form of operator new (plain, array,
+// nothrow, aligned) since the program started. Linking allocation_counter.cpp
+// into a benchmark replaces the global operators to count them.
+uint64_t AllocationCount();
+
+// Report the allocations since allocations_before, per iteration, as the
+// counter named name
+inline void ReportAllocations(benchmark::State& state, uint64_t allocations_before,
+                              const char* name = "allocs_per_iter") {
+    state.counters[name] = benchmark::Counter(
+        static_cast<double>(AllocationCount() - allocations_before), benchmark::Counter::kAvgIterations);
+}
+
+} // namespace yolovr_bench
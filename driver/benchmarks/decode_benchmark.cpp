@@ -0,0 +1,236 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+// Compares the cost of turning one serialized TrackerFrame datagram into the
+// TrackerFrameSnapshot the driver publishes:
+//   BM_DecodeMessage - previous path: fresh yolovr::TrackerFrame + ParseFromArray + copy
+//   BM_DecodeDirect  - TrackerFrameDecoder walking the wire format into the snapshot
+//   BM_DecodeBinary  - TrackerFrameDecoder on the fixed-layout binary format
+//   BM_DecodeQuantizedKeyframe - TrackerFrameDecoder on a quantized keyframe, kept for its deltas
+//   BM_DecodeQuantizedDelta    - a quantized delta frame carrying a quarter of
+//       the trackers, rebuilt on top of its keyframe
+// All of them report heap allocations per frame.
+
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "allocation_counter.h"
+#include "tracker_data.pb.h"
+#include "tracker_frame_decoder.h"
+#include "tracker_wire_format.h"
+
+namespace {
+
+const char* kTrackerNames[] = {
+    "LeftLeg", "RightLeg", "LeftThigh", "RightThigh",
+    "Hip", "Waist", "Chest", "LeftUpperArm", "RightUpperArm",
+    "LeftForearm", "RightForearm", "Head"
+};
+
+// A frame shaped like the ones the Python client sends
+std::string MakeFrame(int tracker_count) {
+    yolovr::TrackerFrame frame;
+    frame.set_frame_id(123456);
+    frame.set_timestamp(1700000000000000ULL);
+    frame.set_source_id(1);
+    frame.set_system_name("YoloVr Python Client");
+    frame.set_system_fps(60.0f);
+    frame.set_is_calibrated(true);
+
+    for (int i = 0; i < tracker_count; i++) {
+        yolovr::TrackerPose* pose = frame.add_trackers();
+        pose->set_tracker_id(static_cast<uint32_t>(i));
+        pose->set_tracker_name(kTrackerNames[i % 12]);
+        pose->mutable_position()->set_x(0.1f * i);
+        pose->mutable_position()->set_y(-1.2f);
+        pose->mutable_position()->set_z(0.05f);
+        pose->mutable_rotation()->set_x(0.0f);
+        pose->mutable_rotation()->set_y(0.7071f);
+        pose->mutable_rotation()->set_z(0.0f);
+        pose->mutable_rotation()->set_w(0.7071f);
+        pose->mutable_velocity()->set_x(0.3f);
+        pose->mutable_velocity()->set_y(0.0f);
+        pose->mutable_velocity()->set_z(-0.1f);
+        pose->mutable_angular_velocity()->set_y(1.5f);
+        pose->set_is_tracking(true);
+        pose->set_confidence(0.9f);
+        pose->set_timestamp(1700000000000000ULL + i);
+    }
+    return frame.SerializeAsString();
+}
+
+void CopyToSnapshot(const yolovr::TrackerFrame& frame, yolovr::TrackerFrameSnapshot& out) {
+    out.frame_id = frame.frame_id();
+    out.timestamp_us = frame.timestamp();
+    out.source_id = frame.source_id();
+    out.is_calibrated = frame.is_calibrated();
+    out.system_fps = frame.system_fps();
+    out.tracker_count = static_cast<uint32_t>(frame.trackers_size());
+
+    yolovr::TrackerPoseArrays& poses = out.poses;
+    for (uint32_t i = 0; i < out.tracker_count; i++) {
+        const yolovr::TrackerPose& pose = frame.trackers(i);
+        poses.tracker_id[i] = pose.tracker_id();
+        poses.is_tracking[i] = pose.is_tracking();
+        poses.has_velocity[i] = pose.has_velocity();
+        poses.has_angular_velocity[i] = pose.has_angular_velocity();
+        poses.confidence[i] = pose.confidence();
+        poses.timestamp_us[i] = pose.timestamp();
+        poses.position[0][i] = pose.position().x();
+        poses.position[1][i] = pose.position().y();
+        poses.position[2][i] = pose.position().z();
+        poses.rotation[0][i] = pose.rotation().x();
+        poses.rotation[1][i] = pose.rotation().y();
+        poses.rotation[2][i] = pose.rotation().z();
+        poses.rotation[3][i] = pose.rotation().w();
+        poses.velocity[0][i] = pose.velocity().x();
+        poses.velocity[1][i] = pose.velocity().y();
+        poses.velocity[2][i] = pose.velocity().z();
+        poses.angular_velocity[0][i] = pose.angular_velocity().x();
+        poses.angular_velocity[1][i] = pose.angular_velocity().y();
+        poses.angular_velocity[2][i] = pose.angular_velocity().z();
+    }
+}
+
+// The same frame as MakeFrame, in the fixed-layout binary format
+std::string MakeBinaryFrame(int tracker_count) {
+    yolovr::TrackerFrame message;
+    const std::string data = MakeFrame(tracker_count);
+    message.ParseFromArray(data.data(), static_cast<int>(data.size()));
+
+    yolovr::TrackerFrameSnapshot snapshot{};
+    CopyToSnapshot(message, snapshot);
+
+    std::string binary(yolovr::BinaryFrameSize(snapshot.tracker_count), '\0');
+    yolovr::EncodeBinaryFrame(snapshot, reinterpret_cast<uint8_t*>(&binary[0]), binary.size());
+    return binary;
+}
+
+// The same frame as MakeFrame in the quantized format: a keyframe, or a delta
+// frame carrying every fourth tracker on top of keyframe 1
+std::string MakeQuantizedFrame(int tracker_count, bool keyframe) {
+    yolovr::TrackerFrame message;
+    const std::string data = MakeFrame(tracker_count);
+    message.ParseFromArray(data.data(), static_cast<int>(data.size()));
+
+    yolovr::TrackerFrameSnapshot snapshot{};
+    CopyToSnapshot(message, snapshot);
+    snapshot.frame_id = keyframe ? 1 : 2;
+    if (!keyframe) {
+        yolovr::TrackerFrameSnapshot delta = snapshot;
+        delta.tracker_count = 0;
+        for (uint32_t i = 0; i < snapshot.tracker_count; i += 4) {
+            yolovr::TrackerPoseSnapshot pose;
+            snapshot.poses.GetPose(i, pose);
+            const uint32_t index = delta.tracker_count++;
+            delta.poses.tracker_id[index] = pose.tracker_id;
+            delta.poses.is_tracking[index] = pose.is_tracking;
+            delta.poses.has_velocity[index] = pose.has_velocity;
+            delta.poses.has_angular_velocity[index] = pose.has_angular_velocity;
+            delta.poses.confidence[index] = pose.confidence;
+            delta.poses.timestamp_us[index] = pose.timestamp_us;
+            for (int axis = 0; axis < 3; axis++) {
+                delta.poses.position[axis][index] = pose.position[axis];
+                delta.poses.velocity[axis][index] = pose.velocity[axis];
+                delta.poses.angular_velocity[axis][index] = pose.angular_velocity[axis];
+            }
+            for (int axis = 0; axis < 4; axis++) {
+                delta.poses.rotation[axis][index] = pose.rotation[axis];
+            }
+        }
+        snapshot = delta;
+    }
+
+    std::string quantized(yolovr::QuantizedFrameSize(snapshot.tracker_count), '\0');
+    yolovr::EncodeQuantizedFrame(snapshot, 1, yolovr::QuantizationSteps(),
+                                 reinterpret_cast<uint8_t*>(&quantized[0]), quantized.size());
+    return quantized;
+}
+
+void BM_DecodeMessage(benchmark::State& state) {
+    const std::string data = MakeFrame(static_cast<int>(state.range(0)));
+    yolovr::TrackerFrameSnapshot snapshot{};
+
+    uint64_t allocations_before = yolovr_bench::AllocationCount();
+    for (auto _ : state) {
+        yolovr::TrackerFrame frame;
+        bool ok = frame.ParseFromArray(data.data(), static_cast<int>(data.size()));
+        benchmark::DoNotOptimize(ok);
+        CopyToSnapshot(frame, snapshot);
+        benchmark::DoNotOptimize(snapshot);
+    }
+    yolovr_bench::ReportAllocations(state, allocations_before, "allocs_per_frame");
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * data.size()));
+}
+BENCHMARK(BM_DecodeMessage)->Arg(12)->Arg(24)->Arg(32);
+
+void BM_DecodeDirect(benchmark::State& state) {
+    const std::string data = MakeFrame(static_cast<int>(state.range(0)));
+    yolovr::TrackerFrameSnapshot snapshot{};
+    yolovr::TrackerFrameDecoder decoder;
+
+    uint64_t allocations_before = yolovr_bench::AllocationCount();
+    for (auto _ : state) {
+        auto result = decoder.Decode(reinterpret_cast<const uint8_t*>(data.data()), data.size(), snapshot);
+        benchmark::DoNotOptimize(result);
+        benchmark::DoNotOptimize(snapshot);
+    }
+    yolovr_bench::ReportAllocations(state, allocations_before, "allocs_per_frame");
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * data.size()));
+}
+BENCHMARK(BM_DecodeDirect)->Arg(12)->Arg(24)->Arg(32);
+
+void BM_DecodeBinary(benchmark::State& state) {
+    const std::string data = MakeBinaryFrame(static_cast<int>(state.range(0)));
+    yolovr::TrackerFrameSnapshot snapshot{};
+    yolovr::TrackerFrameDecoder decoder;
+
+    uint64_t allocations_before = yolovr_bench::AllocationCount();
+    for (auto _ : state) {
+        auto result = decoder.Decode(reinterpret_cast<const uint8_t*>(data.data()), data.size(), snapshot);
+        benchmark::DoNotOptimize(result);
+        benchmark::DoNotOptimize(snapshot);
+    }
+    yolovr_bench::ReportAllocations(state, allocations_before, "allocs_per_frame");
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * data.size()));
+}
+BENCHMARK(BM_DecodeBinary)->Arg(12)->Arg(24)->Arg(32);
+
+void BM_DecodeQuantizedKeyframe(benchmark::State& state) {
+    const std::string data = MakeQuantizedFrame(static_cast<int>(state.range(0)), true);
+    yolovr::TrackerFrameSnapshot snapshot{};
+    yolovr::TrackerFrameDecoder decoder;
+
+    uint64_t allocations_before = yolovr_bench::AllocationCount();
+    for (auto _ : state) {
+        auto result = decoder.Decode(reinterpret_cast<const uint8_t*>(data.data()), data.size(), snapshot);
+        decoder.CommitKeyframe(snapshot);
+        benchmark::DoNotOptimize(result);
+        benchmark::DoNotOptimize(snapshot);
+    }
+    yolovr_bench::ReportAllocations(state, allocations_before, "allocs_per_frame");
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * data.size()));
+}
+BENCHMARK(BM_DecodeQuantizedKeyframe)->Arg(12)->Arg(24)->Arg(32);
+
+void BM_DecodeQuantizedDelta(benchmark::State& state) {
+    const std::string keyframe = MakeQuantizedFrame(static_cast<int>(state.range(0)), true);
+    const std::string data = MakeQuantizedFrame(static_cast<int>(state.range(0)), false);
+    yolovr::TrackerFrameSnapshot snapshot{};
+    yolovr::TrackerFrameDecoder decoder;
+    decoder.Decode(reinterpret_cast<const uint8_t*>(keyframe.data()), keyframe.size(), snapshot);
+    decoder.CommitKeyframe(snapshot);
+
+    uint64_t allocations_before = yolovr_bench::AllocationCount();
+    for (auto _ : state) {
+        auto result = decoder.Decode(reinterpret_cast<const uint8_t*>(data.data()), data.size(), snapshot);
+        benchmark::DoNotOptimize(result);
+        benchmark::DoNotOptimize(snapshot);
+    }
+    yolovr_bench::ReportAllocations(state, allocations_before, "allocs_per_frame");
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * data.size()));
+}
+BENCHMARK(BM_DecodeQuantizedDelta)->Arg(12)->Arg(24)->Arg(32);
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,77 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+// Cost of PoseFilterBank::Apply on one frame, for a typical and a full tracker
+// count. BM_FilterSmoothed runs every tracker through the One Euro filter,
+// BM_FilterBypassed has every tracker above the bypass confidence. Each
+// iteration includes copying the input frame, one TrackerFrameSnapshot.
+
+#include <cmath>
+
+#include <benchmark/benchmark.h>
+
+#include "pose_filter_bank.h"
+
+namespace {
+
+// A jittery frame; phase moves the trackers between calls
+void FillFrame(yolovr::TrackerFrameSnapshot& frame, int tracker_count, float confidence, int phase) {
+    frame.tracker_count = static_cast<uint32_t>(tracker_count);
+    frame.timestamp_us = 1700000000000000ULL + static_cast<uint64_t>(phase) * 16667;
+    frame.arrival_time_ns = static_cast<int64_t>(phase) * 16667000;
+
+    yolovr::TrackerPoseArrays& poses = frame.poses;
+    for (int i = 0; i < tracker_count; i++) {
+        const float t = 0.016667f * phase + 0.1f * i;
+        poses.tracker_id[i] = static_cast<uint32_t>(i);
+        poses.is_tracking[i] = 1;
+        poses.confidence[i] = confidence;
+        poses.position[0][i] = 0.1f * i + 0.01f * std::sin(37.0f * t);
+        poses.position[1][i] = -1.2f + 0.3f * std::sin(t);
+        poses.position[2][i] = 0.05f + 0.01f * std::cos(53.0f * t);
+        poses.rotation[0][i] = 0.0f;
+        poses.rotation[1][i] = std::sin(0.5f * t);
+        poses.rotation[2][i] = 0.0f;
+        poses.rotation[3][i] = std::cos(0.5f * t);
+    }
+}
+
+void RunFilter(benchmark::State& state, float confidence) {
+    const int tracker_count = static_cast<int>(state.range(0));
+
+    // Precomputed input frames so the timed loop is copy + Apply
+    constexpr int kFrames = 64;
+    static yolovr::TrackerFrameSnapshot inputs[kFrames];
+    for (int phase = 0; phase < kFrames; phase++) {
+        inputs[phase] = {};
+        FillFrame(inputs[phase], tracker_count, confidence, phase + 1);
+    }
+
+    yolovr::PoseFilterBank filter_bank;
+    yolovr::TrackerFrameSnapshot frame{};
+    int phase = 0;
+    uint64_t timestamp_us = inputs[0].timestamp_us;
+    for (auto _ : state) {
+        frame = inputs[phase];
+        // Keep time moving forward across laps of the input frames
+        timestamp_us += 16667;
+        frame.timestamp_us = timestamp_us;
+        phase = (phase + 1) % kFrames;
+
+        filter_bank.Apply(frame);
+        benchmark::DoNotOptimize(frame);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * tracker_count);
+}
+
+void BM_FilterSmoothed(benchmark::State& state) {
+    RunFilter(state, 0.6f);
+}
+BENCHMARK(BM_FilterSmoothed)->Arg(12)->Arg(24)->Arg(32);
+
+void BM_FilterBypassed(benchmark::State& state) {
+    RunFilter(state, 0.99f);
+}
+BENCHMARK(BM_FilterBypassed)->Arg(12)->Arg(24)->Arg(32);
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,293 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+// Cost of each hot-path step a datagram goes through after the socket, outside
+// vrserver (see stub_driver_host.h):
+//   BM_InjectBinary / BM_InjectProtobuf - TrackerDataReceiver::InjectDatagram:
+//       decode, sequence, per-source stats and publish
+//   BM_GetLatestFrame      - copying the newest frame out of the receiver
+//   BM_SlotTableDemux      - TrackerSlotTable::Demux of one frame
+//   BM_GetPoseUdp          - MyTrackerDeviceDriver::GetPose from its slot, with prediction
+//   BM_GetPoseFallback     - MyTrackerDeviceDriver::GetPose following the stub HMD,
+//       fetching the HMD pose itself (no publisher)
+//   BM_GetPoseFallbackShared - the same from the publisher's shared HMD sample
+//   BM_FallbackTransform   - HmdPoseCache::TransformOffsets for every tracker type
+// TrackerFrame::ParseFromArray itself is BM_DecodeMessage in decode_benchmark.cpp.
+// All of them report heap allocations per iteration, which should stay 0.
+
+#include <chrono>
+#include <climits>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "allocation_counter.h"
+#include "hmd_pose_cache.h"
+#include "pose_publisher.h"
+#include "stub_driver_host.h"
+#include "tracker_data.pb.h"
+#include "tracker_data_receiver.h"
+#include "tracker_device_driver.h"
+#include "tracker_slot_table.h"
+#include "tracker_wire_format.h"
+
+namespace {
+
+// Distinct frame_ids cycled through by the inject benchmarks. Going back to the
+// first one is a jump of more than FrameSequencer::kRestartGap, which the
+// sequencer accepts as a sender restart, so every injected datagram is a new frame.
+constexpr size_t kFrameCycle = 2048;
+
+// A frame shaped like the ones the Python client sends
+void FillFrame(yolovr::TrackerFrameSnapshot& frame, int tracker_count, uint64_t frame_id) {
+    frame = {};
+    frame.frame_id = frame_id;
+    frame.timestamp_us = 1700000000000000ULL + frame_id * 16667;
+    frame.source_id = 1;
+    frame.is_calibrated = true;
+    frame.system_fps = 60.0f;
+    frame.tracker_count = static_cast<uint32_t>(tracker_count);
+
+    yolovr::TrackerPoseArrays& poses = frame.poses;
+    for (int i = 0; i < tracker_count; i++) {
+        poses.tracker_id[i] = static_cast<uint32_t>(i);
+        poses.is_tracking[i] = 1;
+        poses.has_velocity[i] = 1;
+        poses.has_angular_velocity[i] = 1;
+        poses.confidence[i] = 0.9f;
+        poses.timestamp_us[i] = frame.timestamp_us;
+        poses.position[0][i] = 0.1f * i;
+        poses.position[1][i] = -1.2f;
+        poses.position[2][i] = 0.05f;
+        poses.rotation[1][i] = 0.7071f;
+        poses.rotation[3][i] = 0.7071f;
+        poses.velocity[0][i] = 0.3f;
+        poses.velocity[2][i] = -0.1f;
+        poses.angular_velocity[1][i] = 1.5f;
+    }
+}
+
+std::string EncodeBinary(const yolovr::TrackerFrameSnapshot& frame) {
+    std::string data(yolovr::BinaryFrameSize(frame.tracker_count), '\0');
+    yolovr::EncodeBinaryFrame(frame, reinterpret_cast<uint8_t*>(&data[0]), data.size());
+    return data;
+}
+
+std::string EncodeProtobuf(const yolovr::TrackerFrameSnapshot& frame) {
+    yolovr::TrackerFrame message;
+    message.set_frame_id(frame.frame_id);
+    message.set_timestamp(frame.timestamp_us);
+    message.set_source_id(frame.source_id);
+    message.set_system_name("YoloVr Python Client");
+    message.set_system_fps(frame.system_fps);
+    message.set_is_calibrated(frame.is_calibrated);
+
+    const yolovr::TrackerPoseArrays& poses = frame.poses;
+    for (uint32_t i = 0; i < frame.tracker_count; i++) {
+        yolovr::TrackerPose* pose = message.add_trackers();
+        pose->set_tracker_id(poses.tracker_id[i]);
+        pose->mutable_position()->set_x(poses.position[0][i]);
+        pose->mutable_position()->set_y(poses.position[1][i]);
+        pose->mutable_position()->set_z(poses.position[2][i]);
+        pose->mutable_rotation()->set_x(poses.rotation[0][i]);
+        pose->mutable_rotation()->set_y(poses.rotation[1][i]);
+        pose->mutable_rotation()->set_z(poses.rotation[2][i]);
+        pose->mutable_rotation()->set_w(poses.rotation[3][i]);
+        pose->mutable_velocity()->set_x(poses.velocity[0][i]);
+        pose->mutable_velocity()->set_y(poses.velocity[1][i]);
+        pose->mutable_velocity()->set_z(poses.velocity[2][i]);
+        pose->mutable_angular_velocity()->set_y(poses.angular_velocity[1][i]);
+        pose->set_is_tracking(poses.is_tracking[i] != 0);
+        pose->set_confidence(poses.confidence[i]);
+        pose->set_timestamp(poses.timestamp_us[i]);
+    }
+    return message.SerializeAsString();
+}
+
+std::vector<std::string> MakeDatagrams(int tracker_count, std::string (*encode)(const yolovr::TrackerFrameSnapshot&)) {
+    std::vector<std::string> datagrams(kFrameCycle);
+    yolovr::TrackerFrameSnapshot frame;
+    for (size_t i = 0; i < kFrameCycle; i++) {
+        FillFrame(frame, tracker_count, i + 1);
+        datagrams[i] = encode(frame);
+    }
+    return datagrams;
+}
+
+void RunInject(benchmark::State& state, std::string (*encode)(const yolovr::TrackerFrameSnapshot&)) {
+    const std::vector<std::string> datagrams = MakeDatagrams(static_cast<int>(state.range(0)), encode);
+    yolovr::TrackerDataReceiver receiver;
+
+    size_t next = 0;
+    size_t bytes = 0;
+    uint64_t rejected = 0;
+    uint64_t allocations_before = yolovr_bench::AllocationCount();
+    for (auto _ : state) {
+        const std::string& data = datagrams[next];
+        if (!receiver.InjectDatagram(reinterpret_cast<const uint8_t*>(data.data()), data.size())) {
+            rejected++;
+        }
+        bytes += data.size();
+        next = (next + 1) % kFrameCycle;
+    }
+    yolovr_bench::ReportAllocations(state, allocations_before);
+    state.counters["rejected"] = static_cast<double>(rejected);
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+}
+
+void BM_InjectBinary(benchmark::State& state) {
+    RunInject(state, EncodeBinary);
+}
+BENCHMARK(BM_InjectBinary)->Arg(12)->Arg(24)->Arg(32);
+
+void BM_InjectProtobuf(benchmark::State& state) {
+    RunInject(state, EncodeProtobuf);
+}
+BENCHMARK(BM_InjectProtobuf)->Arg(12)->Arg(24)->Arg(32);
+
+void BM_GetLatestFrame(benchmark::State& state) {
+    yolovr::TrackerFrameSnapshot frame;
+    FillFrame(frame, static_cast<int>(state.range(0)), 1);
+    const std::string data = EncodeBinary(frame);
+    yolovr::TrackerDataReceiver receiver;
+    receiver.InjectDatagram(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+
+    uint64_t allocations_before = yolovr_bench::AllocationCount();
+    for (auto _ : state) {
+        bool ok = receiver.GetLatestFrame(frame);
+        benchmark::DoNotOptimize(ok);
+        benchmark::DoNotOptimize(frame);
+    }
+    yolovr_bench::ReportAllocations(state, allocations_before);
+}
+BENCHMARK(BM_GetLatestFrame)->Arg(12)->Arg(32);
+
+void BM_SlotTableDemux(benchmark::State& state) {
+    yolovr::TrackerFrameSnapshot frame;
+    FillFrame(frame, static_cast<int>(state.range(0)), 1);
+    yolovr::TrackerSlotTable slot_table;
+
+    uint64_t allocations_before = yolovr_bench::AllocationCount();
+    for (auto _ : state) {
+        frame.frame_id++;
+        slot_table.Demux(frame);
+        benchmark::ClobberMemory();
+    }
+    yolovr_bench::ReportAllocations(state, allocations_before);
+}
+BENCHMARK(BM_SlotTableDemux)->Arg(12)->Arg(24)->Arg(32);
+
+// Holds the last pose for as long as the benchmark runs
+yolovr::DriverSettings UdpDeviceSettings() {
+    yolovr::DriverSettings settings;
+    settings.pose_hold_timeout_ms = INT_MAX;
+    return settings;
+}
+
+void BM_GetPoseUdp(benchmark::State& state) {
+    yolovr::TrackerFrameSnapshot frame;
+    FillFrame(frame, 12, 1);
+    const std::string data = EncodeBinary(frame);
+    yolovr::TrackerDataReceiver receiver;
+    receiver.InjectDatagram(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+
+    // Let the publisher thread fuse, filter and demultiplex the frame once, then
+    // stop it so the slot table is only read while timing
+    yolovr::PosePublisher publisher(&receiver);
+    publisher.Start();
+    yolovr::TrackerSlot slot;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    while (!publisher.GetSlotTable().Read(HipTracker, slot) && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    publisher.Stop();
+    if (!publisher.GetSlotTable().Read(HipTracker, slot)) {
+        state.SkipWithError("Pose publisher did not demultiplex the injected frame");
+        return;
+    }
+
+    MyTrackerDeviceDriver device(HipTracker, &publisher, UdpDeviceSettings());
+    uint64_t allocations_before = yolovr_bench::AllocationCount();
+    for (auto _ : state) {
+        vr::DriverPose_t pose = device.GetPose();
+        benchmark::DoNotOptimize(pose);
+    }
+    yolovr_bench::ReportAllocations(state, allocations_before);
+}
+BENCHMARK(BM_GetPoseUdp);
+
+void BM_GetPoseFallback(benchmark::State& state) {
+    MyTrackerDeviceDriver device(LeftLegTracker, nullptr, yolovr::DriverSettings());
+
+    uint64_t allocations_before = yolovr_bench::AllocationCount();
+    for (auto _ : state) {
+        vr::DriverPose_t pose = device.GetPose();
+        benchmark::DoNotOptimize(pose);
+    }
+    yolovr_bench::ReportAllocations(state, allocations_before);
+}
+BENCHMARK(BM_GetPoseFallback);
+
+void BM_GetPoseFallbackShared(benchmark::State& state) {
+    yolovr::TrackerDataReceiver receiver;
+    yolovr::PosePublisher publisher(&receiver);
+    publisher.SetFallbackOffsets(my_tracker_fallback_offsets, MyTrackerCount);
+    MyTrackerDeviceDriver device(LeftLegTracker, &publisher, yolovr::DriverSettings());
+
+    // The publisher thread refreshes the sample every pass while devices ask for it
+    publisher.Start();
+    yolovr::HmdPoseCache::Sample sample;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    while (std::chrono::steady_clock::now() < deadline) {
+        publisher.RequestHmdPose();
+        const int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        if (publisher.GetHmdPoseCache().Read(now_ns, sample)) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    uint64_t allocations_before = yolovr_bench::AllocationCount();
+    for (auto _ : state) {
+        vr::DriverPose_t pose = device.GetPose();
+        benchmark::DoNotOptimize(pose);
+    }
+    yolovr_bench::ReportAllocations(state, allocations_before);
+    publisher.Stop();
+}
+BENCHMARK(BM_GetPoseFallbackShared);
+
+void BM_FallbackTransform(benchmark::State& state) {
+    yolovr::HmdPoseCache::Sample sample = {};
+    yolovr::HmdPoseCache::FetchHmdPose(0, sample);
+    alignas(16) float offsets[3][yolovr::HmdPoseCache::kMaxTrackers];
+    for (size_t i = 0; i < MyTrackerCount; i++) {
+        for (int axis = 0; axis < 3; axis++) {
+            offsets[axis][i] = my_tracker_fallback_offsets[i][axis];
+        }
+    }
+    const float* const in[3] = { offsets[0], offsets[1], offsets[2] };
+    float* const out[3] = { sample.tracker_position[0], sample.tracker_position[1], sample.tracker_position[2] };
+
+    for (auto _ : state) {
+        yolovr::HmdPoseCache::TransformOffsets(sample.hmd_to_world, in, MyTrackerCount, out);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_FallbackTransform);
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (!yolovr_bench::InitStubDriverContext()) {
+        return 1;
+    }
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
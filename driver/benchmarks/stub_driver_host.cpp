@@ -0,0 +1,182 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+#include "stub_driver_host.h"
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+#include "driverlog.h"
+
+// The driver logs through vrserver; print to stderr instead
+void DriverLog(const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    std::vfprintf(stderr, format, args);
+    std::fputc('\n', stderr);
+    va_end(args);
+}
+
+namespace yolovr_bench {
+
+namespace {
+
+StubDriverHost g_host;
+StubSettings g_settings;
+
+class StubDriverContext : public vr::IVRDriverContext {
+public:
+    void* GetGenericInterface(const char* pchInterfaceVersion, vr::EVRInitError* peError) override {
+        void* result = nullptr;
+        if (std::strcmp(pchInterfaceVersion, vr::IVRServerDriverHost_Version) == 0) {
+            result = &g_host;
+        } else if (std::strcmp(pchInterfaceVersion, vr::IVRSettings_Version) == 0) {
+            result = &g_settings;
+        }
+        if (peError) {
+            *peError = result ? vr::VRInitError_None : vr::VRInitError_Init_InterfaceNotFound;
+        }
+        return result;
+    }
+
+    vr::DriverHandle_t GetDriverHandle() override { return 1; }
+};
+
+StubDriverContext g_context;
+
+} // namespace
+
+bool StubDriverHost::TrackedDeviceAdded(const char*, vr::ETrackedDeviceClass, vr::ITrackedDeviceServerDriver*) {
+    return true;
+}
+
+void StubDriverHost::TrackedDevicePoseUpdated(uint32_t, const vr::DriverPose_t&, uint32_t) {
+    poses_submitted_++;
+}
+
+void StubDriverHost::VsyncEvent(double) {}
+
+void StubDriverHost::VendorSpecificEvent(uint32_t, vr::EVREventType, const vr::VREvent_Data_t&, double) {}
+
+bool StubDriverHost::IsExiting() {
+    return false;
+}
+
+bool StubDriverHost::PollNextEvent(vr::VREvent_t*, uint32_t) {
+    return false;
+}
+
+void StubDriverHost::GetRawTrackedDevicePoses(float, vr::TrackedDevicePose_t* pTrackedDevicePoseArray,
+                                              uint32_t unTrackedDevicePoseArrayCount) {
+    if (unTrackedDevicePoseArrayCount == 0) {
+        return;
+    }
+    // HMD at head height, yawed 30 degrees
+    const float c = 0.8660254f;
+    const float s = 0.5f;
+    const vr::HmdMatrix34_t hmd_matrix = { {
+        { c,    0.0f, s,    0.1f },
+        { 0.0f, 1.0f, 0.0f, 1.7f },
+        { -s,   0.0f, c,    -0.2f },
+    } };
+    for (uint32_t i = 0; i < unTrackedDevicePoseArrayCount; i++) {
+        vr::TrackedDevicePose_t& pose = pTrackedDevicePoseArray[i];
+        pose = {};
+        pose.mDeviceToAbsoluteTracking = hmd_matrix;
+        pose.eTrackingResult = vr::TrackingResult_Running_OK;
+        pose.bPoseIsValid = i == vr::k_unTrackedDeviceIndex_Hmd;
+        pose.bDeviceIsConnected = pose.bPoseIsValid;
+    }
+}
+
+void StubDriverHost::RequestRestart(const char*, const char*, const char*, const char*) {}
+
+uint32_t StubDriverHost::GetFrameTimings(vr::Compositor_FrameTiming*, uint32_t) {
+    return 0;
+}
+
+void StubDriverHost::SetDisplayEyeToHead(uint32_t, const vr::HmdMatrix34_t&, const vr::HmdMatrix34_t&) {}
+
+void StubDriverHost::SetDisplayProjectionRaw(uint32_t, const vr::HmdRect2_t&, const vr::HmdRect2_t&) {}
+
+void StubDriverHost::SetRecommendedRenderTargetSize(uint32_t, uint32_t, uint32_t) {}
+
+const char* StubSettings::GetSettingsErrorNameFromEnum(vr::EVRSettingsError) {
+    return "";
+}
+
+void StubSettings::SetBool(const char*, const char*, bool, vr::EVRSettingsError* peError) {
+    if (peError) {
+        *peError = vr::VRSettingsError_None;
+    }
+}
+
+void StubSettings::SetInt32(const char*, const char*, int32_t, vr::EVRSettingsError* peError) {
+    if (peError) {
+        *peError = vr::VRSettingsError_None;
+    }
+}
+
+void StubSettings::SetFloat(const char*, const char*, float, vr::EVRSettingsError* peError) {
+    if (peError) {
+        *peError = vr::VRSettingsError_None;
+    }
+}
+
+void StubSettings::SetString(const char*, const char*, const char*, vr::EVRSettingsError* peError) {
+    if (peError) {
+        *peError = vr::VRSettingsError_None;
+    }
+}
+
+bool StubSettings::GetBool(const char*, const char*, vr::EVRSettingsError* peError) {
+    if (peError) {
+        *peError = vr::VRSettingsError_None;
+    }
+    return false;
+}
+
+int32_t StubSettings::GetInt32(const char*, const char*, vr::EVRSettingsError* peError) {
+    if (peError) {
+        *peError = vr::VRSettingsError_None;
+    }
+    return 0;
+}
+
+float StubSettings::GetFloat(const char*, const char*, vr::EVRSettingsError* peError) {
+    if (peError) {
+        *peError = vr::VRSettingsError_None;
+    }
+    return 0.0f;
+}
+
+void StubSettings::GetString(const char*, const char*, char* pchValue, uint32_t unValueLen,
+                             vr::EVRSettingsError* peError) {
+    if (pchValue && unValueLen > 0) {
+        pchValue[0] = '\0';
+    }
+    if (peError) {
+        *peError = vr::VRSettingsError_None;
+    }
+}
+
+void StubSettings::RemoveSection(const char*, vr::EVRSettingsError* peError) {
+    if (peError) {
+        *peError = vr::VRSettingsError_None;
+    }
+}
+
+void StubSettings::RemoveKeyInSection(const char*, const char*, vr::EVRSettingsError* peError) {
+    if (peError) {
+        *peError = vr::VRSettingsError_None;
+    }
+}
+
+StubDriverHost& GetStubDriverHost() {
+    return g_host;
+}
+
+bool InitStubDriverContext() {
+    return vr::InitServerDriverContext(&g_context) == vr::VRInitError_None;
+}
+
+} // namespace yolovr_bench
@@ -0,0 +1,70 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+#pragma once
+
+#include "openvr_driver.h"
+
+namespace yolovr_bench {
+
+// Minimal stand-ins for the vrserver interfaces the device code calls, so
+// driver code can be benchmarked outside SteamVR. Install them once with
+// InitStubDriverContext() before constructing any devices.
+//
+// GetRawTrackedDevicePoses reports a valid HMD 1.7 m above the origin, turned
+// slightly, so the HMD-following fallback does real work. Submitted poses are
+// counted and otherwise dropped. Settings return empty strings and zeros.
+class StubDriverHost : public vr::IVRServerDriverHost {
+public:
+    bool TrackedDeviceAdded(const char* pchDeviceSerialNumber, vr::ETrackedDeviceClass eDeviceClass,
+                            vr::ITrackedDeviceServerDriver* pDriver) override;
+    void TrackedDevicePoseUpdated(uint32_t unWhichDevice, const vr::DriverPose_t& newPose,
+                                  uint32_t unPoseStructSize) override;
+    void VsyncEvent(double vsyncTimeOffsetSeconds) override;
+    void VendorSpecificEvent(uint32_t unWhichDevice, vr::EVREventType eventType,
+                             const vr::VREvent_Data_t& eventData, double eventTimeOffset) override;
+    bool IsExiting() override;
+    bool PollNextEvent(vr::VREvent_t* pEvent, uint32_t uncbVREvent) override;
+    void GetRawTrackedDevicePoses(float fPredictedSecondsFromNow, vr::TrackedDevicePose_t* pTrackedDevicePoseArray,
+                                  uint32_t unTrackedDevicePoseArrayCount) override;
+    void RequestRestart(const char* pchLocalizedReason, const char* pchExecutableToStart,
+                        const char* pchArguments, const char* pchWorkingDirectory) override;
+    uint32_t GetFrameTimings(vr::Compositor_FrameTiming* pTiming, uint32_t nFrames) override;
+    void SetDisplayEyeToHead(uint32_t unWhichDevice, const vr::HmdMatrix34_t& eyeToHeadLeft,
+                             const vr::HmdMatrix34_t& eyeToHeadRight) override;
+    void SetDisplayProjectionRaw(uint32_t unWhichDevice, const vr::HmdRect2_t& eyeLeft,
+                                 const vr::HmdRect2_t& eyeRight) override;
+    void SetRecommendedRenderTargetSize(uint32_t unWhichDevice, uint32_t nWidth, uint32_t nHeight) override;
+
+    uint64_t PosesSubmitted() const { return poses_submitted_; }
+
+private:
+    uint64_t poses_submitted_ = 0;
+};
+
+class StubSettings : public vr::IVRSettings {
+public:
+    const char* GetSettingsErrorNameFromEnum(vr::EVRSettingsError eError) override;
+    void SetBool(const char* pchSection, const char* pchSettingsKey, bool bValue,
+                 vr::EVRSettingsError* peError) override;
+    void SetInt32(const char* pchSection, const char* pchSettingsKey, int32_t nValue,
+                  vr::EVRSettingsError* peError) override;
+    void SetFloat(const char* pchSection, const char* pchSettingsKey, float flValue,
+                  vr::EVRSettingsError* peError) override;
+    void SetString(const char* pchSection, const char* pchSettingsKey, const char* pchValue,
+                   vr::EVRSettingsError* peError) override;
+    bool GetBool(const char* pchSection, const char* pchSettingsKey, vr::EVRSettingsError* peError) override;
+    int32_t GetInt32(const char* pchSection, const char* pchSettingsKey, vr::EVRSettingsError* peError) override;
+    float GetFloat(const char* pchSection, const char* pchSettingsKey, vr::EVRSettingsError* peError) override;
+    void GetString(const char* pchSection, const char* pchSettingsKey, char* pchValue, uint32_t unValueLen,
+                   vr::EVRSettingsError* peError) override;
+    void RemoveSection(const char* pchSection, vr::EVRSettingsError* peError) override;
+    void RemoveKeyInSection(const char* pchSection, const char* pchSettingsKey,
+                            vr::EVRSettingsError* peError) override;
+};
+
+// The stub host, valid after InitStubDriverContext()
+StubDriverHost& GetStubDriverHost();
+
+// Point vr::VRServerDriverHost() and vr::VRSettings() at the stubs
+bool InitStubDriverContext();
+
+} // namespace yolovr_bench
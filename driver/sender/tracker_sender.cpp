@@ -0,0 +1,395 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+#include "tracker_sender.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <string>
+
+#ifdef _WIN32
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+    #define INVALID_SOCKET_VALUE INVALID_SOCKET
+#else
+    #include <netdb.h>
+    #include <sys/socket.h>
+    #include <time.h>
+    #include <unistd.h>
+    #define INVALID_SOCKET_VALUE -1
+    #define closesocket close
+#endif
+
+namespace yolovr {
+
+namespace {
+
+const char* const kSystemName = "YoloVr Native Sender";
+
+uint64_t UnixNowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+float Distance3(const float (*a)[kMaxTrackersPerFrame], size_t i, const float (*b)[kMaxTrackersPerFrame], size_t j) {
+    float sum = 0.0f;
+    for (int axis = 0; axis < 3; axis++) {
+        const float d = a[axis][i] - b[axis][j];
+        sum += d * d;
+    }
+    return std::sqrt(sum);
+}
+
+// Angle between two unit quaternions
+float RotationAngle(const TrackerPoseArrays& a, size_t i, const TrackerPoseArrays& b, size_t j) {
+    float dot = 0.0f;
+    for (int axis = 0; axis < 4; axis++) {
+        dot += a.rotation[axis][i] * b.rotation[axis][j];
+    }
+    dot = std::fabs(dot);
+    return 2.0f * std::acos(dot < 1.0f ? dot : 1.0f);
+}
+
+void CopyTracker(const TrackerPoseArrays& from, size_t i, TrackerPoseArrays& to, size_t j) {
+    to.tracker_id[j] = from.tracker_id[i];
+    to.is_tracking[j] = from.is_tracking[i];
+    to.has_velocity[j] = from.has_velocity[i];
+    to.has_angular_velocity[j] = from.has_angular_velocity[i];
+    to.confidence[j] = from.confidence[i];
+    to.timestamp_us[j] = from.timestamp_us[i];
+    for (int axis = 0; axis < 3; axis++) {
+        to.position[axis][j] = from.position[axis][i];
+        to.velocity[axis][j] = from.velocity[axis][i];
+        to.angular_velocity[axis][j] = from.angular_velocity[axis][i];
+    }
+    for (int axis = 0; axis < 4; axis++) {
+        to.rotation[axis][j] = from.rotation[axis][i];
+    }
+}
+
+} // namespace
+
+TrackerSender::TrackerSender(Format format)
+    : format_(format)
+    , frame_{}
+    , has_keyframe_(false)
+    , keyframe_{}
+    , delta_{}
+    , socket_(INVALID_SOCKET_VALUE)
+    , counters_{}
+{
+    frame_.source_id = 1;
+    message_.set_system_name(kSystemName);
+
+    // Large enough for every fixed-size format; protobuf grows it on demand
+    buffer_.resize(std::max(BinaryFrameSize(kMaxTrackersPerFrame), QuantizedFrameSize(kMaxTrackersPerFrame)));
+}
+
+TrackerSender::~TrackerSender() {
+    if (socket_ != INVALID_SOCKET_VALUE) {
+        closesocket(socket_);
+#ifdef _WIN32
+        WSACleanup();
+#endif
+    }
+}
+
+bool TrackerSender::OpenUdp(const char* host, uint16_t port) {
+#ifdef _WIN32
+    WSADATA wsa_data;
+    if (WSAStartup(MAKEWORD(2, 2), &wsa_data) != 0) {
+        return false;
+    }
+#endif
+    addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    addrinfo* address = nullptr;
+    const std::string service = std::to_string(port);
+    if (getaddrinfo(host, service.c_str(), &hints, &address) != 0 || !address) {
+#ifdef _WIN32
+        WSACleanup();
+#endif
+        return false;
+    }
+
+    // Connected, so every frame is a plain send() without an address lookup
+    socket_ = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+    bool ok = socket_ != INVALID_SOCKET_VALUE &&
+        connect(socket_, address->ai_addr, static_cast<int>(address->ai_addrlen)) == 0;
+    freeaddrinfo(address);
+#ifdef SO_TIMESTAMPNS
+    // Kernel arrival times for clock sync pings, so a ping waiting until the
+    // next Send() does not count as round trip
+    int enable = 1;
+    if (ok) {
+        setsockopt(socket_, SOL_SOCKET, SO_TIMESTAMPNS, &enable, sizeof(enable));
+    }
+#endif
+    if (!ok && socket_ != INVALID_SOCKET_VALUE) {
+        closesocket(socket_);
+        socket_ = INVALID_SOCKET_VALUE;
+    }
+#ifdef _WIN32
+    if (!ok) {
+        WSACleanup();
+    }
+#endif
+    return ok;
+}
+
+bool TrackerSender::OpenSharedMemory(const char* name) {
+    return ring_.Open(name, SharedMemoryRing::Role::Producer);
+}
+
+void TrackerSender::SetSource(uint32_t source_id, float system_fps, bool is_calibrated) {
+    frame_.source_id = source_id;
+    frame_.system_fps = system_fps;
+    frame_.is_calibrated = is_calibrated;
+}
+
+TrackerSender::Result TrackerSender::Send(const TrackerArrays& trackers, uint64_t timestamp_us) {
+    if (trackers.count > 0 && !trackers.positions) {
+        return Result::InvalidArgument;
+    }
+    if (trackers.count > kMaxTrackersPerFrame) {
+        return Result::TooManyTrackers;
+    }
+    if (socket_ == INVALID_SOCKET_VALUE && !ring_.IsOpen()) {
+        return Result::InvalidArgument;
+    }
+
+    if (socket_ != INVALID_SOCKET_VALUE) {
+        AnswerClockPings();
+    }
+    if (timestamp_us == 0) {
+        timestamp_us = UnixNowUs();
+    }
+    FillFrame(trackers, timestamp_us);
+
+    size_t size = 0;
+    switch (format_) {
+    case Format::Binary:
+        size = EncodeBinaryFrame(frame_, buffer_.data(), buffer_.size());
+        break;
+    case Format::Quantized:
+        size = EncodeQuantized();
+        break;
+    case Format::Protobuf:
+    default:
+        size = EncodeProtobuf();
+        break;
+    }
+    return Transmit(size);
+}
+
+void TrackerSender::FillFrame(const TrackerArrays& trackers, uint64_t timestamp_us) {
+    frame_.frame_id++;
+    frame_.timestamp_us = timestamp_us;
+    frame_.tracker_count = trackers.count;
+
+    // Rows in, one array per axis out
+    TrackerPoseArrays& poses = frame_.poses;
+    for (uint32_t i = 0; i < trackers.count; i++) {
+        poses.tracker_id[i] = trackers.tracker_ids ? trackers.tracker_ids[i] : i;
+        poses.is_tracking[i] = trackers.is_tracking ? (trackers.is_tracking[i] != 0) : 1;
+        poses.has_velocity[i] = trackers.velocities ? 1 : 0;
+        poses.has_angular_velocity[i] = trackers.angular_velocities ? 1 : 0;
+        poses.confidence[i] = trackers.confidences ? trackers.confidences[i] : 1.0f;
+        poses.timestamp_us[i] = timestamp_us;
+        for (int axis = 0; axis < 3; axis++) {
+            poses.position[axis][i] = trackers.positions[i * 3 + axis];
+            poses.velocity[axis][i] = trackers.velocities ? trackers.velocities[i * 3 + axis] : 0.0f;
+            poses.angular_velocity[axis][i] =
+                trackers.angular_velocities ? trackers.angular_velocities[i * 3 + axis] : 0.0f;
+        }
+        for (int axis = 0; axis < 4; axis++) {
+            poses.rotation[axis][i] = trackers.rotations ? trackers.rotations[i * 4 + axis] : (axis == 3 ? 1.0f : 0.0f);
+        }
+    }
+}
+
+size_t TrackerSender::EncodeProtobuf() {
+    message_.set_frame_id(frame_.frame_id);
+    message_.set_timestamp(frame_.timestamp_us);
+    message_.set_source_id(frame_.source_id);
+    message_.set_system_fps(frame_.system_fps);
+    message_.set_is_calibrated(frame_.is_calibrated);
+
+    // Reuse the TrackerPose messages of the previous frame rather than Clear(),
+    // which would free their nested messages
+    auto* poses = message_.mutable_trackers();
+    while (poses->size() > static_cast<int>(frame_.tracker_count)) {
+        poses->RemoveLast();
+    }
+    while (poses->size() < static_cast<int>(frame_.tracker_count)) {
+        poses->Add();
+    }
+
+    const TrackerPoseArrays& arrays = frame_.poses;
+    uint32_t lost = 0;
+    for (uint32_t i = 0; i < frame_.tracker_count; i++) {
+        TrackerPose& pose = *poses->Mutable(static_cast<int>(i));
+        pose.set_tracker_id(arrays.tracker_id[i]);
+        pose.set_is_tracking(arrays.is_tracking[i] != 0);
+        pose.set_confidence(arrays.confidence[i]);
+        pose.set_timestamp(arrays.timestamp_us[i]);
+        Vector3* position = pose.mutable_position();
+        position->set_x(arrays.position[0][i]);
+        position->set_y(arrays.position[1][i]);
+        position->set_z(arrays.position[2][i]);
+        Quaternion* rotation = pose.mutable_rotation();
+        rotation->set_x(arrays.rotation[0][i]);
+        rotation->set_y(arrays.rotation[1][i]);
+        rotation->set_z(arrays.rotation[2][i]);
+        rotation->set_w(arrays.rotation[3][i]);
+        if (arrays.has_velocity[i]) {
+            Vector3* velocity = pose.mutable_velocity();
+            velocity->set_x(arrays.velocity[0][i]);
+            velocity->set_y(arrays.velocity[1][i]);
+            velocity->set_z(arrays.velocity[2][i]);
+        } else {
+            pose.clear_velocity();
+        }
+        if (arrays.has_angular_velocity[i]) {
+            Vector3* angular_velocity = pose.mutable_angular_velocity();
+            angular_velocity->set_x(arrays.angular_velocity[0][i]);
+            angular_velocity->set_y(arrays.angular_velocity[1][i]);
+            angular_velocity->set_z(arrays.angular_velocity[2][i]);
+        } else {
+            pose.clear_angular_velocity();
+        }
+        lost += arrays.is_tracking[i] ? 0 : 1;
+    }
+    message_.set_lost_tracking_count(lost);
+
+    const size_t size = message_.ByteSizeLong();
+    if (size > buffer_.size()) {
+        buffer_.resize(size);
+    }
+    return message_.SerializeWithCachedSizesToArray(buffer_.data()) - buffer_.data();
+}
+
+size_t TrackerSender::EncodeQuantized() {
+    // A keyframe on schedule, after a restart of the frame_id sequence, or
+    // when a tracker of the keyframe is gone, since only a keyframe drops it
+    bool keyframe = !has_keyframe_ || frame_.frame_id < keyframe_.frame_id ||
+        frame_.frame_id - keyframe_.frame_id >= quantization_.keyframe_interval;
+    for (uint32_t k = 0; !keyframe && k < keyframe_.tracker_count; k++) {
+        bool present = false;
+        for (uint32_t i = 0; i < frame_.tracker_count && !present; i++) {
+            present = frame_.poses.tracker_id[i] == keyframe_.poses.tracker_id[k];
+        }
+        keyframe = !present;
+    }
+
+    if (keyframe) {
+        keyframe_ = frame_;
+        has_keyframe_ = true;
+        return EncodeQuantizedFrame(frame_, frame_.frame_id, steps_, buffer_.data(), buffer_.size());
+    }
+
+    delta_.frame_id = frame_.frame_id;
+    delta_.timestamp_us = frame_.timestamp_us;
+    delta_.source_id = frame_.source_id;
+    delta_.system_fps = frame_.system_fps;
+    delta_.is_calibrated = frame_.is_calibrated;
+    delta_.tracker_count = 0;
+    for (uint32_t i = 0; i < frame_.tracker_count; i++) {
+        if (ChangedSinceKeyframe(i)) {
+            CopyTracker(frame_.poses, i, delta_.poses, delta_.tracker_count++);
+        }
+    }
+    return EncodeQuantizedFrame(delta_, keyframe_.frame_id, steps_, buffer_.data(), buffer_.size());
+}
+
+bool TrackerSender::ChangedSinceKeyframe(size_t i) const {
+    const TrackerPoseArrays& now = frame_.poses;
+    const TrackerPoseArrays& base = keyframe_.poses;
+    size_t j = 0;
+    while (j < keyframe_.tracker_count && base.tracker_id[j] != now.tracker_id[i]) {
+        j++;
+    }
+    if (j == keyframe_.tracker_count) {
+        return true;
+    }
+    return now.is_tracking[i] != base.is_tracking[j] ||
+        now.has_velocity[i] != base.has_velocity[j] ||
+        now.has_angular_velocity[i] != base.has_angular_velocity[j] ||
+        std::fabs(now.confidence[i] - base.confidence[j]) > 0.05f ||
+        Distance3(now.position, i, base.position, j) > quantization_.position_threshold ||
+        RotationAngle(now, i, base, j) > quantization_.rotation_threshold ||
+        Distance3(now.velocity, i, base.velocity, j) > quantization_.velocity_threshold ||
+        Distance3(now.angular_velocity, i, base.angular_velocity, j) > quantization_.velocity_threshold;
+}
+
+void TrackerSender::AnswerClockPings() {
+    uint8_t message[64];
+    for (;;) {
+        uint64_t receive_us = 0;
+#if defined(_WIN32)
+        u_long pending = 0;
+        if (ioctlsocket(socket_, FIONREAD, &pending) != 0 || pending == 0) {
+            return;
+        }
+        const int size = recv(socket_, reinterpret_cast<char*>(message), sizeof(message), 0);
+#else
+        iovec vector;
+        vector.iov_base = message;
+        vector.iov_len = sizeof(message);
+        alignas(cmsghdr) uint8_t control[64];
+        msghdr header;
+        std::memset(&header, 0, sizeof(header));
+        header.msg_iov = &vector;
+        header.msg_iovlen = 1;
+        header.msg_control = control;
+        header.msg_controllen = sizeof(control);
+        const ssize_t size = recvmsg(socket_, &header, MSG_DONTWAIT);
+#ifdef SO_TIMESTAMPNS
+        for (cmsghdr* item = size > 0 ? CMSG_FIRSTHDR(&header) : nullptr; item; item = CMSG_NXTHDR(&header, item)) {
+            if (item->cmsg_level == SOL_SOCKET && item->cmsg_type == SCM_TIMESTAMPNS) {
+                timespec arrival;
+                std::memcpy(&arrival, CMSG_DATA(item), sizeof(arrival));
+                receive_us = static_cast<uint64_t>(arrival.tv_sec) * 1000000 + arrival.tv_nsec / 1000;
+            }
+        }
+#endif
+#endif
+        if (size <= 0) {
+            return;
+        }
+
+        ClockPing ping;
+        if (!DecodeClockPing(message, static_cast<size_t>(size), ping)) {
+            continue;
+        }
+        ClockPong pong;
+        pong.ping = ping;
+        pong.transmit_time_us = UnixNowUs();
+        pong.receive_time_us = receive_us != 0 && receive_us <= pong.transmit_time_us ? receive_us : pong.transmit_time_us;
+        const size_t pong_size = EncodeClockPong(pong, message, sizeof(message));
+        send(socket_, reinterpret_cast<const char*>(message), static_cast<int>(pong_size), 0);
+    }
+}
+
+TrackerSender::Result TrackerSender::Transmit(size_t size) {
+    if (size == 0) {
+        counters_.send_errors++;
+        return Result::InvalidArgument;
+    }
+    if (ring_.IsOpen()) {
+        if (!ring_.Write(buffer_.data(), size)) {
+            counters_.send_errors++;
+            return Result::RingFull;
+        }
+    } else if (send(socket_, reinterpret_cast<const char*>(buffer_.data()), static_cast<int>(size), 0) < 0) {
+        counters_.send_errors++;
+        return Result::SendFailed;
+    }
+    counters_.frames_sent++;
+    counters_.bytes_sent += size;
+    return Result::Ok;
+}
+
+} // namespace yolovr
@@ -0,0 +1,121 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "shared_memory_ring.h"
+#include "tracker_data.pb.h"
+#include "tracker_frame_snapshot.h"
+#include "tracker_wire_format.h"
+
+namespace yolovr {
+
+// Sending side of the driver's wire formats, behind the C interface in
+// yolovr_sender.h.
+//
+// Each Send() transposes the caller's row-major arrays into one
+// TrackerFrameSnapshot, encodes it into a buffer kept across frames and hands
+// it to the socket or the shared memory ring. After the first frame the
+// binary and quantized formats allocate nothing; the protobuf format reuses
+// one TrackerFrame, so it only allocates while the tracker count or the
+// presence of velocities changes. Over UDP, every Send() first answers the
+// driver's clock sync pings.
+class TrackerSender {
+public:
+    enum class Format { Protobuf, Binary, Quantized };
+
+    enum class Result {
+        Ok,
+        InvalidArgument,
+        TooManyTrackers,
+        SendFailed,
+        RingFull,
+    };
+
+    // One frame's trackers, row-major; see yolovr_sender_send for which may be null
+    struct TrackerArrays {
+        uint32_t count;
+        const uint32_t* tracker_ids;
+        const float* positions;             // count x 3
+        const float* rotations;             // count x 4, x y z w
+        const float* velocities;            // count x 3
+        const float* angular_velocities;    // count x 3
+        const float* confidences;
+        const uint8_t* is_tracking;
+    };
+
+    // When the quantized format sends a keyframe, and which trackers a delta frame carries
+    struct QuantizationSettings {
+        uint32_t keyframe_interval = 30;
+        float position_threshold = 0.002f;      // m
+        float rotation_threshold = 0.0087f;     // rad, about half a degree
+        float velocity_threshold = 0.02f;       // m/s and rad/s
+    };
+
+    struct Counters {
+        uint64_t frames_sent;
+        uint64_t bytes_sent;
+        uint64_t send_errors;
+    };
+
+    explicit TrackerSender(Format format);
+    ~TrackerSender();
+
+    TrackerSender(const TrackerSender&) = delete;
+    TrackerSender& operator=(const TrackerSender&) = delete;
+
+    bool OpenUdp(const char* host, uint16_t port);
+    bool OpenSharedMemory(const char* name);
+
+    void SetSource(uint32_t source_id, float system_fps, bool is_calibrated);
+    void SetQuantization(const QuantizationSettings& settings) { quantization_ = settings; }
+
+    // timestamp_us 0 stamps the frame with the current time
+    Result Send(const TrackerArrays& trackers, uint64_t timestamp_us);
+
+    uint64_t NextFrameId() const { return frame_.frame_id + 1; }
+    const Counters& GetCounters() const { return counters_; }
+
+private:
+    void FillFrame(const TrackerArrays& trackers, uint64_t timestamp_us);
+
+    size_t EncodeProtobuf();
+    size_t EncodeQuantized();
+
+    // Quantized format: whether tracker i of frame_ moved past the thresholds
+    // since the keyframe (or is not in it)
+    bool ChangedSinceKeyframe(size_t i) const;
+
+    Result Transmit(size_t size);
+
+    // UDP: answer the clock sync pings the driver sent since the last frame
+    void AnswerClockPings();
+
+    Format format_;
+    TrackerFrameSnapshot frame_;
+    std::vector<uint8_t> buffer_;
+
+    // Quantized format
+    QuantizationSettings quantization_;
+    QuantizationSteps steps_;
+    bool has_keyframe_;
+    TrackerFrameSnapshot keyframe_;
+    TrackerFrameSnapshot delta_;
+
+    // Protobuf format
+    TrackerFrame message_;
+
+    // Transport: a connected UDP socket or the shared memory ring
+#ifdef _WIN32
+    uintptr_t socket_;
+#else
+    int socket_;
+#endif
+    SharedMemoryRing ring_;
+
+    Counters counters_;
+};
+
+} // namespace yolovr
@@ -0,0 +1,144 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+#include "yolovr_sender.h"
+
+#include <new>
+
+#include "tracker_sender.h"
+
+struct yolovr_sender {
+    explicit yolovr_sender(yolovr::TrackerSender::Format format) : sender(format) {}
+
+    yolovr::TrackerSender sender;
+};
+
+namespace {
+
+bool ToFormat(int format, yolovr::TrackerSender::Format& out) {
+    switch (format) {
+    case YOLOVR_FORMAT_PROTOBUF:
+        out = yolovr::TrackerSender::Format::Protobuf;
+        return true;
+    case YOLOVR_FORMAT_BINARY:
+        out = yolovr::TrackerSender::Format::Binary;
+        return true;
+    case YOLOVR_FORMAT_QUANTIZED:
+        out = yolovr::TrackerSender::Format::Quantized;
+        return true;
+    default:
+        return false;
+    }
+}
+
+int ToResult(yolovr::TrackerSender::Result result) {
+    switch (result) {
+    case yolovr::TrackerSender::Result::Ok:
+        return YOLOVR_SEND_OK;
+    case yolovr::TrackerSender::Result::TooManyTrackers:
+        return YOLOVR_SEND_TOO_MANY_TRACKERS;
+    case yolovr::TrackerSender::Result::SendFailed:
+        return YOLOVR_SEND_FAILED;
+    case yolovr::TrackerSender::Result::RingFull:
+        return YOLOVR_SEND_RING_FULL;
+    case yolovr::TrackerSender::Result::InvalidArgument:
+    default:
+        return YOLOVR_SEND_INVALID_ARGUMENT;
+    }
+}
+
+yolovr_sender* Create(int format) {
+    yolovr::TrackerSender::Format sender_format;
+    if (!ToFormat(format, sender_format)) {
+        return nullptr;
+    }
+    return new (std::nothrow) yolovr_sender(sender_format);
+}
+
+} // namespace
+
+uint32_t yolovr_sender_abi_version(void) {
+    return YOLOVR_SENDER_ABI_VERSION;
+}
+
+uint32_t yolovr_sender_max_trackers(void) {
+    return static_cast<uint32_t>(yolovr::kMaxTrackersPerFrame);
+}
+
+yolovr_sender* yolovr_sender_create_udp(const char* host, uint16_t port, int format) {
+    if (!host) {
+        return nullptr;
+    }
+    yolovr_sender* sender = Create(format);
+    if (sender && !sender->sender.OpenUdp(host, port)) {
+        delete sender;
+        return nullptr;
+    }
+    return sender;
+}
+
+yolovr_sender* yolovr_sender_create_shm(const char* name, int format) {
+    if (!name) {
+        return nullptr;
+    }
+    yolovr_sender* sender = Create(format);
+    if (sender && !sender->sender.OpenSharedMemory(name)) {
+        delete sender;
+        return nullptr;
+    }
+    return sender;
+}
+
+void yolovr_sender_destroy(yolovr_sender* sender) {
+    delete sender;
+}
+
+void yolovr_sender_set_source(yolovr_sender* sender, uint32_t source_id, float system_fps, int is_calibrated) {
+    if (sender) {
+        sender->sender.SetSource(source_id, system_fps, is_calibrated != 0);
+    }
+}
+
+void yolovr_sender_set_quantization(yolovr_sender* sender, uint32_t keyframe_interval, float position_threshold,
+                                    float rotation_threshold, float velocity_threshold) {
+    if (sender) {
+        yolovr::TrackerSender::QuantizationSettings settings;
+        settings.keyframe_interval = keyframe_interval > 0 ? keyframe_interval : 1;
+        settings.position_threshold = position_threshold;
+        settings.rotation_threshold = rotation_threshold;
+        settings.velocity_threshold = velocity_threshold;
+        sender->sender.SetQuantization(settings);
+    }
+}
+
+int yolovr_sender_send(yolovr_sender* sender, uint32_t count, const uint32_t* tracker_ids, const float* positions,
+                       const float* rotations, const float* velocities, const float* angular_velocities,
+                       const float* confidences, const uint8_t* is_tracking, uint64_t timestamp_us) {
+    if (!sender) {
+        return YOLOVR_SEND_INVALID_ARGUMENT;
+    }
+    yolovr::TrackerSender::TrackerArrays trackers;
+    trackers.count = count;
+    trackers.tracker_ids = tracker_ids;
+    trackers.positions = positions;
+    trackers.rotations = rotations;
+    trackers.velocities = velocities;
+    trackers.angular_velocities = angular_velocities;
+    trackers.confidences = confidences;
+    trackers.is_tracking = is_tracking;
+    return ToResult(sender->sender.Send(trackers, timestamp_us));
+}
+
+uint64_t yolovr_sender_next_frame_id(const yolovr_sender* sender) {
+    return sender ? sender->sender.NextFrameId() : 0;
+}
+
+uint64_t yolovr_sender_frames_sent(const yolovr_sender* sender) {
+    return sender ? sender->sender.GetCounters().frames_sent : 0;
+}
+
+uint64_t yolovr_sender_bytes_sent(const yolovr_sender* sender) {
+    return sender ? sender->sender.GetCounters().bytes_sent : 0;
+}
+
+uint64_t yolovr_sender_send_errors(const yolovr_sender* sender) {
+    return sender ? sender->sender.GetCounters().send_errors : 0;
+}
@@ -0,0 +1,106 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+// C interface of the native tracker sender library (libyolovr_sender).
+//
+// Encodes frames straight from flat arrays into a buffer reused for every
+// frame, and sends them over UDP or through the driver's shared memory ring
+// (see shared_memory_name in the driver README). Meant for inference
+// processes that send many trackers at high rates, and for bindings such as
+// python-client/yolovr/native_sender.py.
+//
+// The ABI is stable: functions are only ever added, never changed, and
+// yolovr_sender_abi_version() is bumped when they are. A sender is not
+// thread-safe; use one per sending thread.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+    #if defined(YOLOVR_SENDER_BUILD)
+        #define YOLOVR_SENDER_API __declspec(dllexport)
+    #else
+        #define YOLOVR_SENDER_API __declspec(dllimport)
+    #endif
+#else
+    #define YOLOVR_SENDER_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define YOLOVR_SENDER_ABI_VERSION 1
+
+// Wire formats, see driver/src/tracker_wire_format.h and proto/tracker_data.proto
+enum {
+    YOLOVR_FORMAT_PROTOBUF = 0,
+    YOLOVR_FORMAT_BINARY = 1,
+    YOLOVR_FORMAT_QUANTIZED = 2,
+};
+
+// Results of yolovr_sender_send
+enum {
+    YOLOVR_SEND_OK = 0,
+    YOLOVR_SEND_INVALID_ARGUMENT = -1,
+    YOLOVR_SEND_TOO_MANY_TRACKERS = -2,
+    YOLOVR_SEND_FAILED = -3,        // The socket send failed, see errno
+    YOLOVR_SEND_RING_FULL = -4,     // No driver is reading the shared memory ring
+};
+
+typedef struct yolovr_sender yolovr_sender;
+
+YOLOVR_SENDER_API uint32_t yolovr_sender_abi_version(void);
+
+// Most trackers one frame can carry
+YOLOVR_SENDER_API uint32_t yolovr_sender_max_trackers(void);
+
+// Create a sender that sends datagrams to host:port. NULL on failure.
+YOLOVR_SENDER_API yolovr_sender* yolovr_sender_create_udp(const char* host, uint16_t port, int format);
+
+// Create a sender that writes into the shared memory ring called name
+// (e.g. "/yolovr_frames"), creating it if the driver has not yet. Linux only;
+// NULL on failure.
+YOLOVR_SENDER_API yolovr_sender* yolovr_sender_create_shm(const char* name, int format);
+
+YOLOVR_SENDER_API void yolovr_sender_destroy(yolovr_sender* sender);
+
+// Frame header fields sent with every following frame (defaults: 1, 0, 0)
+YOLOVR_SENDER_API void yolovr_sender_set_source(yolovr_sender* sender, uint32_t source_id, float system_fps,
+                                                int is_calibrated);
+
+// Quantized format only: frames between keyframes, and how far a tracker has
+// to move (m), turn (rad) or change velocity (m/s, rad/s) since the keyframe
+// to be sent in a delta frame. Defaults: 30, 0.002, 0.0087, 0.02.
+YOLOVR_SENDER_API void yolovr_sender_set_quantization(yolovr_sender* sender, uint32_t keyframe_interval,
+                                                      float position_threshold, float rotation_threshold,
+                                                      float velocity_threshold);
+
+// Encode and send one frame of count trackers. Arrays are row-major, one row
+// per tracker:
+//   tracker_ids         count values; NULL for 0 .. count-1
+//   positions           count x 3 (x, y, z in meters)
+//   rotations           count x 4 (x, y, z, w); NULL for identity
+//   velocities          count x 3 (m/s); NULL if unknown
+//   angular_velocities  count x 3 (rad/s); NULL if unknown
+//   confidences         count values in [0, 1]; NULL for 1
+//   is_tracking         count values, nonzero when tracked; NULL for all tracked
+//   timestamp_us        frame time, Unix microseconds; 0 for now
+// The frame_id is assigned by the sender and increases by one per call. Over
+// UDP the call first answers any clock sync pings the driver has sent, so the
+// driver can map timestamp_us to its own clock.
+// Returns YOLOVR_SEND_OK or one of the negative results above.
+YOLOVR_SENDER_API int yolovr_sender_send(yolovr_sender* sender, uint32_t count, const uint32_t* tracker_ids,
+                                         const float* positions, const float* rotations, const float* velocities,
+                                         const float* angular_velocities, const float* confidences,
+                                         const uint8_t* is_tracking, uint64_t timestamp_us);
+
+// frame_id the next frame will carry
+YOLOVR_SENDER_API uint64_t yolovr_sender_next_frame_id(const yolovr_sender* sender);
+
+YOLOVR_SENDER_API uint64_t yolovr_sender_frames_sent(const yolovr_sender* sender);
+YOLOVR_SENDER_API uint64_t yolovr_sender_bytes_sent(const yolovr_sender* sender);
+YOLOVR_SENDER_API uint64_t yolovr_sender_send_errors(const yolovr_sender* sender);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
@@ -0,0 +1,196 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+#include "async_logger.h"
+#include "driverlog.h"
+
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+namespace yolovr {
+
+namespace {
+
+// How often the drain thread wakes up; writers never signal it
+constexpr auto kDrainInterval = std::chrono::milliseconds(20);
+
+int64_t SteadyNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+const char* LevelPrefix(LogLevel level) {
+    switch (level) {
+    case LogLevel::Debug: return "[debug] ";
+    case LogLevel::Warning: return "[warning] ";
+    case LogLevel::Error: return "[error] ";
+    default: return "";
+    }
+}
+
+// Prefix, message and suppression note, truncated to size
+void FormatMessage(char* out, size_t size, LogLevel level, uint32_t suppressed, const char* format, va_list args) {
+    int length = std::snprintf(out, size, "%s", LevelPrefix(level));
+    if (length >= 0 && static_cast<size_t>(length) < size) {
+        const int written = std::vsnprintf(out + length, size - length, format, args);
+        if (written > 0) {
+            length += written;
+        }
+    }
+    if (suppressed > 0 && length >= 0 && static_cast<size_t>(length) < size) {
+        std::snprintf(out + length, size - length, " (%u similar messages suppressed)", suppressed);
+    }
+}
+
+} // namespace
+
+bool ParseLogLevel(const char* name, LogLevel& level) {
+    if (std::strcmp(name, "debug") == 0) {
+        level = LogLevel::Debug;
+    } else if (std::strcmp(name, "info") == 0) {
+        level = LogLevel::Info;
+    } else if (std::strcmp(name, "warning") == 0) {
+        level = LogLevel::Warning;
+    } else if (std::strcmp(name, "error") == 0) {
+        level = LogLevel::Error;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+LogRateLimiter::LogRateLimiter(int64_t interval_ms)
+    : interval_ns_(interval_ms * 1000000)
+    , next_allowed_ns_(0)
+    , suppressed_(0)
+{
+}
+
+bool LogRateLimiter::Allow(uint32_t& suppressed) {
+    const int64_t now_ns = SteadyNowNs();
+    int64_t next_allowed_ns = next_allowed_ns_.load(std::memory_order_relaxed);
+    if (now_ns < next_allowed_ns ||
+        !next_allowed_ns_.compare_exchange_strong(next_allowed_ns, now_ns + interval_ns_, std::memory_order_relaxed)) {
+        suppressed_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    suppressed = suppressed_.exchange(0, std::memory_order_relaxed);
+    return true;
+}
+
+AsyncLogger& AsyncLogger::Instance() {
+    static AsyncLogger logger;
+    return logger;
+}
+
+AsyncLogger::AsyncLogger()
+    : level_(static_cast<int>(LogLevel::Info))
+    , running_(false)
+    , dropped_(0)
+    , dropped_reported_(0)
+    , enqueue_position_(0)
+    , dequeue_position_(0)
+{
+    // Slot i is free for the writer that claims position i
+    for (size_t i = 0; i < kCapacity; i++) {
+        entries_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+AsyncLogger::~AsyncLogger() {
+    Stop();
+}
+
+void AsyncLogger::Start() {
+    if (running_.exchange(true)) {
+        return;
+    }
+    drain_thread_ = std::thread(&AsyncLogger::DrainThreadFunction, this);
+}
+
+void AsyncLogger::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(drain_mutex_);
+        if (!running_.exchange(false)) {
+            return;
+        }
+    }
+    drain_cv_.notify_all();
+    if (drain_thread_.joinable()) {
+        drain_thread_.join();
+    }
+}
+
+void AsyncLogger::Write(LogLevel level, uint32_t suppressed, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+
+    if (!running_.load(std::memory_order_acquire)) {
+        char text[kMaxMessageLength];
+        FormatMessage(text, sizeof(text), level, suppressed, format, args);
+        va_end(args);
+        DriverLog("%s", text);
+        return;
+    }
+
+    // Claim a slot: its sequence equals our position while it is free
+    uint64_t position = enqueue_position_.load(std::memory_order_relaxed);
+    Entry* entry;
+    for (;;) {
+        entry = &entries_[position & (kCapacity - 1)];
+        const uint64_t sequence = entry->sequence.load(std::memory_order_acquire);
+        const int64_t difference = static_cast<int64_t>(sequence - position);
+        if (difference == 0) {
+            if (enqueue_position_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            // Still holds a message from one lap ago: the ring is full
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            va_end(args);
+            return;
+        } else {
+            position = enqueue_position_.load(std::memory_order_relaxed);
+        }
+    }
+
+    FormatMessage(entry->text, sizeof(entry->text), level, suppressed, format, args);
+    va_end(args);
+    entry->sequence.store(position + 1, std::memory_order_release);
+}
+
+void AsyncLogger::DrainThreadFunction() {
+    std::unique_lock<std::mutex> lock(drain_mutex_);
+    while (running_.load()) {
+        drain_cv_.wait_for(lock, kDrainInterval);
+        lock.unlock();
+        Drain();
+        lock.lock();
+    }
+    lock.unlock();
+
+    // Messages written while stopping
+    Drain();
+}
+
+void AsyncLogger::Drain() {
+    for (;;) {
+        Entry& entry = entries_[dequeue_position_ & (kCapacity - 1)];
+        if (entry.sequence.load(std::memory_order_acquire) != dequeue_position_ + 1) {
+            break;
+        }
+        DriverLog("%s", entry.text);
+        // Free the slot for the writer one lap ahead
+        entry.sequence.store(dequeue_position_ + kCapacity, std::memory_order_release);
+        dequeue_position_++;
+    }
+
+    const uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+    if (dropped != dropped_reported_) {
+        DriverLog("[warning] %llu log messages dropped, log queue full",
+                  static_cast<unsigned long long>(dropped - dropped_reported_));
+        dropped_reported_ = dropped;
+    }
+}
+
+} // namespace yolovr
@@ -0,0 +1,131 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+namespace yolovr {
+
+enum class LogLevel : int {
+    Debug,
+    Info,
+    Warning,
+    Error,
+};
+
+// "debug", "info", "warning" or "error". Returns false and leaves level
+// unchanged for anything else.
+bool ParseLogLevel(const char* name, LogLevel& level);
+
+// Lets one message through per interval and counts the ones it held back.
+// Lock-free; one instance per call site (see YOLOVR_LOG_EVERY_MS).
+class LogRateLimiter {
+public:
+    explicit LogRateLimiter(int64_t interval_ms);
+
+    // True if a message may be written now. suppressed is set to the number of
+    // messages held back since the last one that was let through.
+    bool Allow(uint32_t& suppressed);
+
+private:
+    int64_t interval_ns_;
+    std::atomic<int64_t> next_allowed_ns_;
+    std::atomic<uint32_t> suppressed_;
+};
+
+// Driver log that keeps vrserver's logging off the calling thread.
+//
+// Write() formats into a slot of a fixed ring (a bounded multi-producer queue:
+// one CAS to claim the slot, no locks, no allocation) and a background thread
+// passes the messages on to DriverLog. When the ring is full the message is
+// dropped and counted; the drain thread reports how many were lost. Before
+// Start() and after Stop() messages go straight to DriverLog.
+//
+// Use the YOLOVR_LOG macros rather than calling Write() directly, so messages
+// below the level are not even formatted.
+class AsyncLogger {
+public:
+    static constexpr size_t kCapacity = 256;            // Power of two
+    static constexpr size_t kMaxMessageLength = 256;    // Longer messages are truncated
+
+    static AsyncLogger& Instance();
+
+    void Start();
+    // Drains every queued message before returning
+    void Stop();
+
+    void SetLevel(LogLevel level) { level_.store(static_cast<int>(level), std::memory_order_relaxed); }
+    bool IsEnabled(LogLevel level) const {
+        return static_cast<int>(level) >= level_.load(std::memory_order_relaxed);
+    }
+
+    // suppressed > 0 appends how many similar messages a rate limiter held back
+    void Write(LogLevel level, uint32_t suppressed, const char* format, ...);
+
+    // Messages lost because the ring was full
+    uint64_t DroppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    struct Entry {
+        std::atomic<uint64_t> sequence;
+        char text[kMaxMessageLength];
+    };
+
+    AsyncLogger();
+    ~AsyncLogger();
+
+    AsyncLogger(const AsyncLogger&) = delete;
+    AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+    void DrainThreadFunction();
+    void Drain();
+
+    std::atomic<int> level_;
+    std::atomic<bool> running_;
+    std::atomic<uint64_t> dropped_;
+    uint64_t dropped_reported_;     // Drain thread only
+
+    Entry entries_[kCapacity];
+    alignas(64) std::atomic<uint64_t> enqueue_position_;
+    alignas(64) uint64_t dequeue_position_;     // Drain thread only
+
+    std::thread drain_thread_;
+    std::mutex drain_mutex_;
+    std::condition_variable drain_cv_;
+};
+
+} // namespace yolovr
+
+// Log at level if it is enabled
+#define YOLOVR_LOG(level, ...)                                                          \
+    do {                                                                                \
+        if (::yolovr::AsyncLogger::Instance().IsEnabled(level)) {                       \
+            ::yolovr::AsyncLogger::Instance().Write(level, 0, __VA_ARGS__);             \
+        }                                                                               \
+    } while (0)
+
+// Log at most once per interval_ms from this call site, e.g. per-datagram
+// errors that a misbehaving sender could otherwise repeat thousands of times
+// a second. The next message written reports how many were held back.
+#define YOLOVR_LOG_EVERY_MS(level, interval_ms, ...)                                    \
+    do {                                                                                \
+        static ::yolovr::LogRateLimiter yolovr_log_limiter(interval_ms);                \
+        uint32_t yolovr_log_suppressed = 0;                                             \
+        if (::yolovr::AsyncLogger::Instance().IsEnabled(level) &&                       \
+            yolovr_log_limiter.Allow(yolovr_log_suppressed)) {                          \
+            ::yolovr::AsyncLogger::Instance().Write(level, yolovr_log_suppressed, __VA_ARGS__); \
+        }                                                                               \
+    } while (0)
+
+// Debug logging on per-pose and per-frame paths. Compiled out of release
+// builds (NDEBUG) unless YOLOVR_HOT_PATH_LOGGING is defined, and sampled to
+// once a second per call site otherwise.
+#if defined(NDEBUG) && !defined(YOLOVR_HOT_PATH_LOGGING)
+#define YOLOVR_LOG_HOT(...) do {} while (0)
+#else
+#define YOLOVR_LOG_HOT(...) YOLOVR_LOG_EVERY_MS(::yolovr::LogLevel::Debug, 1000, __VA_ARGS__)
+#endif
@@ -0,0 +1,107 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+#include "capture_replay.h"
+
+#include "driverlog.h"
+#include "tracker_data_receiver.h"
+
+#include <chrono>
+
+namespace yolovr {
+
+namespace {
+
+int64_t SteadyNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+CaptureReplay::CaptureReplay(TrackerDataReceiver* receiver)
+    : receiver_(receiver)
+    , running_(false)
+    , stop_requested_(false)
+{
+}
+
+CaptureReplay::~CaptureReplay() {
+    Stop();
+}
+
+bool CaptureReplay::Open(const std::string& path) {
+    if (!reader_.Open(path)) {
+        return false;
+    }
+    DriverLog("Opened capture %s with %zu datagrams", path.c_str(), reader_.RecordCount());
+    return true;
+}
+
+bool CaptureReplay::Start(const Options& options) {
+    if (running_.load() || reader_.RecordCount() == 0) {
+        return false;
+    }
+    running_.store(true);
+    stop_requested_.store(false);
+    replay_thread_ = std::thread(&CaptureReplay::ReplayThreadFunction, this, options);
+    return true;
+}
+
+void CaptureReplay::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(wait_mutex_);
+        stop_requested_.store(true);
+    }
+    wait_cv_.notify_all();
+    if (replay_thread_.joinable()) {
+        replay_thread_.join();
+    }
+    running_.store(false);
+}
+
+void CaptureReplay::ReplayThreadFunction(Options options) {
+    DriverLog("Replaying capture at %s", options.speed > 0.0f ? "recorded timing" : "full speed");
+    do {
+        const Result result = Run(options);
+        DriverLog("Replayed %llu datagrams (%llu frames) in %.3f s",
+                  static_cast<unsigned long long>(result.datagrams),
+                  static_cast<unsigned long long>(result.frames), result.duration_s);
+    } while (options.loop && !stop_requested_.load());
+}
+
+CaptureReplay::Result CaptureReplay::Run(const Options& options) {
+    Result result = {};
+    const int64_t start_ns = SteadyNowNs();
+    int64_t first_arrival_ns = 0;
+
+    size_t offset = reader_.FirstOffset();
+    DatagramCaptureReader::Record record;
+    for (bool first = true; reader_.Next(offset, record); first = false) {
+        if (first) {
+            first_arrival_ns = record.arrival_time_ns;
+        }
+        if (options.speed > 0.0f) {
+            const double elapsed_ns = static_cast<double>(record.arrival_time_ns - first_arrival_ns) / options.speed;
+            if (!WaitUntil(start_ns + static_cast<int64_t>(elapsed_ns))) {
+                break;
+            }
+        } else if (stop_requested_.load(std::memory_order_relaxed)) {
+            break;
+        }
+
+        if (receiver_->InjectDatagram(record.data, record.size)) {
+            result.frames++;
+        }
+        result.datagrams++;
+    }
+
+    result.duration_s = (SteadyNowNs() - start_ns) / 1e9;
+    return result;
+}
+
+bool CaptureReplay::WaitUntil(int64_t deadline_ns) {
+    const auto deadline = std::chrono::steady_clock::time_point(std::chrono::nanoseconds(deadline_ns));
+    std::unique_lock<std::mutex> lock(wait_mutex_);
+    return !wait_cv_.wait_until(lock, deadline, [this] { return stop_requested_.load(); });
+}
+
+} // namespace yolovr
@@ -0,0 +1,68 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "datagram_capture.h"
+
+namespace yolovr {
+
+class TrackerDataReceiver;
+
+// Feeds a capture file back through TrackerDataReceiver::InjectDatagram, so
+// recorded sessions run through the same decode, sequencing, fusion, filter
+// and pose path as live data. The receiver must not be receiving on its own
+// sockets meanwhile.
+//
+// Datagrams are injected at their recorded spacing divided by speed, or back to
+// back when speed is 0. They are stamped with the time they are injected, not
+// the time they were captured, so staleness checks behave as they did live.
+class CaptureReplay {
+public:
+    struct Options {
+        float speed = 1.0f;     // 1 = original timing, 2 = twice as fast, 0 = as fast as possible
+        bool loop = false;      // Start over at the end of the capture
+    };
+
+    struct Result {
+        uint64_t datagrams;     // Injected
+        uint64_t frames;        // Accepted and published by the receiver
+        double duration_s;
+    };
+
+    explicit CaptureReplay(TrackerDataReceiver* receiver);
+    ~CaptureReplay();
+
+    bool Open(const std::string& path);
+    size_t RecordCount() const { return reader_.RecordCount(); }
+
+    // Replay on a background thread until the capture ends (or forever when
+    // looping) or Stop() is called
+    bool Start(const Options& options);
+    void Stop();
+
+    // Replay on the calling thread, once through the capture regardless of
+    // options.loop. Returns early if Stop() is called from another thread.
+    Result Run(const Options& options);
+
+private:
+    void ReplayThreadFunction(Options options);
+    // Wait until deadline_ns (steady clock) or Stop(); false if stopped
+    bool WaitUntil(int64_t deadline_ns);
+
+    TrackerDataReceiver* receiver_;
+    DatagramCaptureReader reader_;
+
+    std::atomic<bool> running_;
+    std::atomic<bool> stop_requested_;
+    std::thread replay_thread_;
+    std::mutex wait_mutex_;
+    std::condition_variable wait_cv_;
+};
+
+} // namespace yolovr
@@ -0,0 +1,117 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+#include "clock_sync.h"
+
+#include <cmath>
+#include <cstdlib>
+
+namespace yolovr {
+
+ClockSync::ClockSync() {
+    Reset();
+}
+
+void ClockSync::Reset() {
+    Restart();
+    steps_ = 0;
+}
+
+void ClockSync::Restart() {
+    for (Sample& sample : window_) {
+        sample = Sample{};
+    }
+    next_ = 0;
+    best_ = 0;
+    sample_count_ = 0;
+    drift_ = 0.0;
+    has_drift_ = false;
+    drift_reference_ = Sample{};
+}
+
+bool ClockSync::AddSample(int64_t origin_ns, uint64_t receive_us, uint64_t transmit_us, int64_t arrival_ns) {
+    if (arrival_ns < origin_ns || transmit_us < receive_us) {
+        return false;
+    }
+    const int64_t receive_ns = static_cast<int64_t>(receive_us) * 1000;
+    const int64_t transmit_ns = static_cast<int64_t>(transmit_us) * 1000;
+
+    Sample sample;
+    sample.local_ns = origin_ns + (arrival_ns - origin_ns) / 2;
+    sample.rtt_ns = (arrival_ns - origin_ns) - (transmit_ns - receive_ns);
+    if (sample.rtt_ns < 0) {
+        // Microsecond sender timestamps, or a sender clock running fast over a
+        // very short exchange
+        sample.rtt_ns = 0;
+    }
+    const int64_t outbound_ns = receive_ns - origin_ns;
+    const int64_t inbound_ns = transmit_ns - arrival_ns;
+    sample.offset_ns = outbound_ns + (inbound_ns - outbound_ns) / 2;
+
+    // The true offset is within half a round trip of either exchange's offset
+    if (IsSynchronized()) {
+        const int64_t tolerance_ns = sample.rtt_ns / 2 + window_[best_].rtt_ns / 2 + kStepToleranceNs;
+        if (std::llabs(sample.offset_ns - OffsetAt(sample.local_ns)) > tolerance_ns) {
+            steps_++;
+            Restart();
+        }
+    }
+
+    const size_t index = next_;
+    const bool replaces_best = sample_count_ > 0 && index == best_;
+    window_[index] = sample;
+    next_ = (next_ + 1) % kFilterSize;
+    sample_count_++;
+
+    if (sample_count_ == 1 || sample.rtt_ns <= window_[best_].rtt_ns) {
+        best_ = index;
+    } else if (replaces_best) {
+        const size_t filled = sample_count_ < kFilterSize ? static_cast<size_t>(sample_count_) : kFilterSize;
+        best_ = index;
+        for (size_t i = 0; i < filled; i++) {
+            if (window_[i].rtt_ns < window_[best_].rtt_ns) {
+                best_ = i;
+            }
+        }
+    }
+
+    // Drift from the trusted offsets, over a baseline long enough that their
+    // errors hardly show in the slope
+    if (best_ == index) {
+        if (sample_count_ == 1) {
+            drift_reference_ = sample;
+        } else if (sample.local_ns - drift_reference_.local_ns >= kDriftBaselineNs) {
+            const double drift = static_cast<double>(sample.offset_ns - drift_reference_.offset_ns) /
+                static_cast<double>(sample.local_ns - drift_reference_.local_ns);
+            if (std::fabs(drift) <= kMaxDrift) {
+                drift_ = has_drift_ ? drift_ + (drift - drift_) / 4.0 : drift;
+                has_drift_ = true;
+            }
+            drift_reference_ = sample;
+        }
+    }
+    return true;
+}
+
+int64_t ClockSync::OffsetAt(int64_t local_ns) const {
+    const Sample& best = window_[best_];
+    return best.offset_ns + static_cast<int64_t>(drift_ * static_cast<double>(local_ns - best.local_ns));
+}
+
+int64_t ClockSync::ToLocalNs(uint64_t sender_us) const {
+    const int64_t sender_ns = static_cast<int64_t>(sender_us) * 1000;
+    return sender_ns - OffsetAt(sender_ns - window_[best_].offset_ns);
+}
+
+ClockSync::Estimate ClockSync::GetEstimate(int64_t now_ns) const {
+    Estimate estimate = {};
+    estimate.synchronized = IsSynchronized();
+    estimate.samples = sample_count_;
+    estimate.steps = steps_;
+    if (sample_count_ > 0) {
+        estimate.offset_ns = OffsetAt(now_ns);
+        estimate.rtt_ns = window_[best_].rtt_ns;
+        estimate.drift_ppm = drift_ * 1e6;
+    }
+    return estimate;
+}
+
+} // namespace yolovr
@@ -0,0 +1,79 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace yolovr {
+
+// Estimates one sender's clock against the driver's steady_clock from
+// NTP-style ping/pong exchanges (see the clock sync messages in
+// tracker_wire_format.h), so sender timestamps can be mapped to driver time.
+//
+// Each exchange gives an offset that is off by at most half its round trip,
+// so like NTP's clock filter only the exchange with the smallest round trip
+// among the last kFilterSize is trusted. Drift is the slope between trusted
+// offsets at least kDriftBaselineNs apart, smoothed, and carries the offset
+// forward between exchanges. An exchange that disagrees with the estimate by
+// more than both round trips allow means the sender clock stepped (or another
+// machine took over the source_id), and the estimate starts over.
+//
+// Not thread-safe; used by the receiver thread only.
+class ClockSync {
+public:
+    static constexpr size_t kFilterSize = 8;
+    static constexpr uint64_t kMinSamples = 4;
+    static constexpr int64_t kDriftBaselineNs = 16000000000;
+    static constexpr double kMaxDrift = 500e-6;
+    static constexpr int64_t kStepToleranceNs = 5000000;
+
+    struct Estimate {
+        bool synchronized;          // kMinSamples exchanges since the last reset
+        int64_t offset_ns;          // Sender clock minus steady_clock, now
+        int64_t rtt_ns;             // Round trip of the trusted exchange
+        double drift_ppm;           // Sender clock rate relative to steady_clock, minus one
+        uint64_t samples;           // Exchanges since the last reset
+        uint64_t steps;             // Resets after a clock step
+    };
+
+    ClockSync();
+
+    // One exchange: the ping left at origin_ns and the pong arrived at
+    // arrival_ns (steady_clock); the sender received it at receive_us and
+    // answered at transmit_us (sender clock). Returns false if the times are
+    // inconsistent and the exchange was ignored.
+    bool AddSample(int64_t origin_ns, uint64_t receive_us, uint64_t transmit_us, int64_t arrival_ns);
+
+    bool IsSynchronized() const { return sample_count_ >= kMinSamples; }
+
+    // steady_clock time of a sender timestamp. Only meaningful when synchronized.
+    int64_t ToLocalNs(uint64_t sender_us) const;
+
+    Estimate GetEstimate(int64_t now_ns) const;
+
+    void Reset();
+
+private:
+    struct Sample {
+        int64_t local_ns;           // Midpoint of the exchange, steady_clock
+        int64_t offset_ns;
+        int64_t rtt_ns;
+    };
+
+    int64_t OffsetAt(int64_t local_ns) const;
+
+    // Forget every exchange, keeping steps_
+    void Restart();
+
+    Sample window_[kFilterSize];
+    size_t next_;
+    size_t best_;                   // Index of the trusted sample in window_
+    uint64_t sample_count_;
+    uint64_t steps_;
+
+    double drift_;
+    bool has_drift_;
+    Sample drift_reference_;
+};
+
+} // namespace yolovr
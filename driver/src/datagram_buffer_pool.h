@@ -0,0 +1,35 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace yolovr {
+
+// Fixed set of equally sized datagram buffers carved out of one contiguous
+// allocation. Allocated once when the receiver starts and reused for every
+// receive afterwards.
+class DatagramBufferPool {
+public:
+    DatagramBufferPool() : buffer_count_(0), buffer_size_(0) {}
+
+    void Allocate(size_t buffer_count, size_t buffer_size) {
+        buffer_count_ = buffer_count;
+        buffer_size_ = buffer_size;
+        storage_.assign(buffer_count_ * buffer_size_, 0);
+    }
+
+    uint8_t* Buffer(size_t index) { return storage_.data() + index * buffer_size_; }
+    const uint8_t* Buffer(size_t index) const { return storage_.data() + index * buffer_size_; }
+
+    size_t BufferCount() const { return buffer_count_; }
+    size_t BufferSize() const { return buffer_size_; }
+
+private:
+    size_t buffer_count_;
+    size_t buffer_size_;
+    std::vector<uint8_t> storage_;
+};
+
+} // namespace yolovr
@@ -0,0 +1,245 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+#include "datagram_capture.h"
+#include "driverlog.h"
+
+#include <chrono>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace yolovr {
+
+namespace {
+
+constexpr size_t kFileBufferSize = 1 << 20;
+
+// Little-endian stores and loads; every platform SteamVR runs on is little-endian
+template <typename T>
+void Store(uint8_t* out, T value) {
+    std::memcpy(out, &value, sizeof(T));
+}
+
+template <typename T>
+T Load(const uint8_t* data) {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+size_t PaddedRecordSize(size_t payload_size) {
+    return (kCaptureRecordHeaderSize + payload_size + 7) & ~static_cast<size_t>(7);
+}
+
+} // namespace
+
+DatagramCaptureWriter::DatagramCaptureWriter()
+    : file_(nullptr)
+    , record_count_(0)
+{
+}
+
+DatagramCaptureWriter::~DatagramCaptureWriter() {
+    Close();
+}
+
+bool DatagramCaptureWriter::Open(const std::string& path) {
+    Close();
+
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_) {
+        DriverLog("Failed to open capture file %s", path.c_str());
+        return false;
+    }
+    file_buffer_.resize(kFileBufferSize);
+    std::setvbuf(file_, file_buffer_.data(), _IOFBF, file_buffer_.size());
+
+    uint8_t header[kCaptureHeaderSize] = {};
+    std::memcpy(header + capture_header::kMagic, kCaptureMagic, sizeof(kCaptureMagic));
+    Store<uint16_t>(header + capture_header::kVersion, kCaptureFormatVersion);
+    Store<uint16_t>(header + capture_header::kHeaderSize, static_cast<uint16_t>(kCaptureHeaderSize));
+    Store<int64_t>(header + capture_header::kStartUnixNs, std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+    Store<int64_t>(header + capture_header::kStartSteadyNs, std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+    if (std::fwrite(header, sizeof(header), 1, file_) != 1) {
+        DriverLog("Failed to write capture file %s", path.c_str());
+        Close();
+        return false;
+    }
+
+    record_count_ = 0;
+    DriverLog("Capturing datagrams to %s", path.c_str());
+    return true;
+}
+
+void DatagramCaptureWriter::Close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (file_) {
+        std::fclose(file_);
+        file_ = nullptr;
+        DriverLog("Capture closed after %llu datagrams", static_cast<unsigned long long>(record_count_));
+    }
+}
+
+void DatagramCaptureWriter::Append(int64_t arrival_time_ns, uint32_t address, uint16_t port,
+                                   const uint8_t* data, size_t size) {
+    const size_t record_size = PaddedRecordSize(size);
+    uint8_t header[kCaptureRecordHeaderSize] = {};
+    Store<int64_t>(header + capture_record::kArrivalTimeNs, arrival_time_ns);
+    Store<uint32_t>(header + capture_record::kAddress, address);
+    Store<uint16_t>(header + capture_record::kPort, port);
+    Store<uint32_t>(header + capture_record::kPayloadSize, static_cast<uint32_t>(size));
+    Store<uint32_t>(header + capture_record::kRecordSize, static_cast<uint32_t>(record_size));
+    static const uint8_t kPadding[8] = {};
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!file_) {
+        return;
+    }
+    const bool ok = std::fwrite(header, sizeof(header), 1, file_) == 1 &&
+                    std::fwrite(data, 1, size, file_) == size &&
+                    std::fwrite(kPadding, 1, record_size - kCaptureRecordHeaderSize - size, file_) ==
+                        record_size - kCaptureRecordHeaderSize - size;
+    if (!ok) {
+        // Disk full or similar: stop capturing rather than fail on every datagram
+        DriverLog("Capture write failed after %llu datagrams, capture stopped",
+                  static_cast<unsigned long long>(record_count_));
+        std::fclose(file_);
+        file_ = nullptr;
+        return;
+    }
+    record_count_++;
+}
+
+DatagramCaptureReader::DatagramCaptureReader()
+    : data_(nullptr)
+    , size_(0)
+    , first_offset_(0)
+    , record_count_(0)
+    , start_unix_ns_(0)
+#ifdef _WIN32
+    , file_handle_(INVALID_HANDLE_VALUE)
+    , mapping_handle_(nullptr)
+#endif
+{
+}
+
+DatagramCaptureReader::~DatagramCaptureReader() {
+    Close();
+}
+
+bool DatagramCaptureReader::Open(const std::string& path) {
+    Close();
+
+#ifdef _WIN32
+    file_handle_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                               FILE_ATTRIBUTE_NORMAL, nullptr);
+    LARGE_INTEGER file_size;
+    if (file_handle_ == INVALID_HANDLE_VALUE || !GetFileSizeEx(file_handle_, &file_size)) {
+        DriverLog("Failed to open capture file %s", path.c_str());
+        Close();
+        return false;
+    }
+    size_ = static_cast<size_t>(file_size.QuadPart);
+    if (size_ > 0) {
+        mapping_handle_ = CreateFileMappingA(file_handle_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        data_ = mapping_handle_ ? static_cast<const uint8_t*>(MapViewOfFile(mapping_handle_, FILE_MAP_READ, 0, 0, 0))
+                                : nullptr;
+    }
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    struct stat file_stat;
+    if (fd == -1 || fstat(fd, &file_stat) != 0) {
+        DriverLog("Failed to open capture file %s", path.c_str());
+        if (fd != -1) {
+            close(fd);
+        }
+        return false;
+    }
+    size_ = static_cast<size_t>(file_stat.st_size);
+    if (size_ > 0) {
+        void* mapping = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        data_ = mapping != MAP_FAILED ? static_cast<const uint8_t*>(mapping) : nullptr;
+        if (data_) {
+            // Replay reads front to back
+            madvise(mapping, size_, MADV_SEQUENTIAL);
+        }
+    }
+    close(fd);
+#endif
+
+    if (!data_ || size_ < kCaptureHeaderSize ||
+        std::memcmp(data_ + capture_header::kMagic, kCaptureMagic, sizeof(kCaptureMagic)) != 0) {
+        DriverLog("%s is not a capture file", path.c_str());
+        Close();
+        return false;
+    }
+    if (Load<uint16_t>(data_ + capture_header::kVersion) != kCaptureFormatVersion) {
+        DriverLog("Capture file %s has unsupported version %u", path.c_str(),
+                  Load<uint16_t>(data_ + capture_header::kVersion));
+        Close();
+        return false;
+    }
+    first_offset_ = Load<uint16_t>(data_ + capture_header::kHeaderSize);
+    start_unix_ns_ = Load<int64_t>(data_ + capture_header::kStartUnixNs);
+
+    size_t offset = first_offset_;
+    Record record;
+    while (Next(offset, record)) {
+        record_count_++;
+    }
+    return true;
+}
+
+void DatagramCaptureReader::Close() {
+#ifdef _WIN32
+    if (data_) {
+        UnmapViewOfFile(data_);
+    }
+    if (mapping_handle_) {
+        CloseHandle(mapping_handle_);
+        mapping_handle_ = nullptr;
+    }
+    if (file_handle_ != INVALID_HANDLE_VALUE) {
+        CloseHandle(file_handle_);
+        file_handle_ = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (data_) {
+        munmap(const_cast<uint8_t*>(data_), size_);
+    }
+#endif
+    data_ = nullptr;
+    size_ = 0;
+    first_offset_ = 0;
+    record_count_ = 0;
+}
+
+bool DatagramCaptureReader::Next(size_t& offset, Record& record) const {
+    if (!data_ || offset + kCaptureRecordHeaderSize > size_) {
+        return false;
+    }
+    const uint8_t* header = data_ + offset;
+    const size_t payload_size = Load<uint32_t>(header + capture_record::kPayloadSize);
+    const size_t record_size = Load<uint32_t>(header + capture_record::kRecordSize);
+    if (record_size < kCaptureRecordHeaderSize + payload_size || record_size > size_ - offset) {
+        return false;
+    }
+
+    record.arrival_time_ns = Load<int64_t>(header + capture_record::kArrivalTimeNs);
+    record.address = Load<uint32_t>(header + capture_record::kAddress);
+    record.port = Load<uint16_t>(header + capture_record::kPort);
+    record.data = header + kCaptureRecordHeaderSize;
+    record.size = payload_size;
+    offset += record_size;
+    return true;
+}
+
+} // namespace yolovr
@@ -0,0 +1,130 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace yolovr {
+
+// Capture file of raw datagrams as TrackerDataReceiver got them, for replaying
+// a session later (CaptureReplay). All fields are little-endian; offsets are
+// in bytes.
+//
+// File header (kCaptureHeaderSize bytes):
+//   0  char[4]  magic "YVRC"
+//   4  uint16   version (kCaptureFormatVersion)
+//   6  uint16   header_size - offset of the first record
+//   8  int64    system clock when the capture started, Unix nanoseconds
+//   16 int64    steady clock when the capture started, nanoseconds
+//
+// Record (kCaptureRecordHeaderSize bytes followed by the payload):
+//   0  int64    arrival time, steady clock nanoseconds (as in TrackerFrameSnapshot)
+//   8  uint32   sender IPv4 address, network byte order
+//   12 uint16   sender port, network byte order
+//   14 uint16   reserved, 0
+//   16 uint32   payload size
+//   20 uint32   record size - stride to the next record (header, payload and
+//               padding to a multiple of 8)
+//
+// A record cut short at the end of the file (capture killed mid-write) ends
+// the capture.
+
+constexpr uint8_t kCaptureMagic[4] = { 'Y', 'V', 'R', 'C' };
+constexpr uint16_t kCaptureFormatVersion = 1;
+
+constexpr size_t kCaptureHeaderSize = 24;
+constexpr size_t kCaptureRecordHeaderSize = 24;
+
+namespace capture_header {
+constexpr size_t kMagic = 0;
+constexpr size_t kVersion = 4;
+constexpr size_t kHeaderSize = 6;
+constexpr size_t kStartUnixNs = 8;
+constexpr size_t kStartSteadyNs = 16;
+} // namespace capture_header
+
+namespace capture_record {
+constexpr size_t kArrivalTimeNs = 0;
+constexpr size_t kAddress = 8;
+constexpr size_t kPort = 12;
+constexpr size_t kPayloadSize = 16;
+constexpr size_t kRecordSize = 20;
+} // namespace capture_record
+
+// Appends datagrams to a capture file. Append() may be called from every
+// receive thread; records go through one large stdio buffer, so a datagram
+// costs a memcpy and, every megabyte or so, a write to disk on whichever
+// thread fills the buffer. Capture is for debugging sessions, not always on.
+class DatagramCaptureWriter {
+public:
+    DatagramCaptureWriter();
+    ~DatagramCaptureWriter();
+
+    DatagramCaptureWriter(const DatagramCaptureWriter&) = delete;
+    DatagramCaptureWriter& operator=(const DatagramCaptureWriter&) = delete;
+
+    // Create (or truncate) path and write the file header
+    bool Open(const std::string& path);
+    void Close();
+    bool IsOpen() const { return file_ != nullptr; }
+
+    // address and port in network byte order, as in sockaddr_in
+    void Append(int64_t arrival_time_ns, uint32_t address, uint16_t port, const uint8_t* data, size_t size);
+
+    uint64_t RecordCount() const { return record_count_; }
+
+private:
+    std::mutex mutex_;
+    std::FILE* file_;
+    std::vector<char> file_buffer_;
+    uint64_t record_count_;
+};
+
+// Read-only memory mapping of a capture file. Records are read in place,
+// nothing is copied.
+class DatagramCaptureReader {
+public:
+    struct Record {
+        int64_t arrival_time_ns;
+        uint32_t address;           // Network byte order
+        uint16_t port;              // Network byte order
+        const uint8_t* data;
+        size_t size;
+    };
+
+    DatagramCaptureReader();
+    ~DatagramCaptureReader();
+
+    DatagramCaptureReader(const DatagramCaptureReader&) = delete;
+    DatagramCaptureReader& operator=(const DatagramCaptureReader&) = delete;
+
+    bool Open(const std::string& path);
+    void Close();
+
+    // Offset of the first record, to start iterating with Next()
+    size_t FirstOffset() const { return first_offset_; }
+
+    // Read the record at offset and advance offset past it. Returns false at
+    // the end of the capture.
+    bool Next(size_t& offset, Record& record) const;
+
+    size_t RecordCount() const { return record_count_; }
+    int64_t StartUnixNs() const { return start_unix_ns_; }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+    size_t first_offset_;
+    size_t record_count_;
+    int64_t start_unix_ns_;
+#ifdef _WIN32
+    void* file_handle_;
+    void* mapping_handle_;
+#endif
+};
+
+} // namespace yolovr
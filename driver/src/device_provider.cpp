@@ -1,6 +1,8 @@
 //============ Copyright (c) Valve Corporation, All rights reserved. ============
 #include "device_provider.h"
 
+#include "async_logger.h"
+#include "driver_settings.h"
 #include "driverlog.h"
 
 //-----------------------------------------------------------------------------
@@ -13,43 +15,114 @@ vr::EVRInitError MyDeviceProvider::Init( vr::IVRDriverContext *pDriverContext )
 	// OpenVR provides a macro to do this for us.
 	VR_INIT_SERVER_DRIVER_CONTEXT( pDriverContext );
 
-	// Create all tracker types defined in our enum
-	const unsigned int number_of_tracker_types = 12; // Total number of tracker types in MyTrackers enum
-	for ( unsigned int i = 0; i < number_of_tracker_types; i++ )
+	settings_ = yolovr::DriverSettings::Load();
+	const yolovr::DriverSettings &settings = settings_;
+
+	// Rate-limited and per-pose messages are queued and written by a background thread from here on
+	yolovr::AsyncLogger::Instance().SetLevel( settings.log_level );
+	yolovr::AsyncLogger::Instance().Start();
+
+	// The receiver and publisher exist before any device so devices can be handed the publisher.
+	// Nothing is running until the end of Init.
+	latency_monitor_ = std::make_unique<yolovr::LatencyMonitor>();
+	tracker_receiver_ = std::make_unique<yolovr::TrackerDataReceiver>("0.0.0.0", 9999);
+	tracker_receiver_->SetLatencyMonitor(latency_monitor_.get());
+	tracker_receiver_->SetShardCount(static_cast<size_t>(settings.receiver_shards));
+	tracker_receiver_->SetReceiveBufferSize(static_cast<size_t>(settings.receive_buffer_bytes));
+	tracker_receiver_->SetSourceMaxAge(std::chrono::milliseconds(settings.source_max_age_ms));
+	tracker_receiver_->SetClockSyncInterval(std::chrono::milliseconds(settings.clock_sync_interval_ms));
+	tracker_receiver_->SetLowLatency(settings.low_latency);
+	pose_publisher_ = std::make_unique<yolovr::PosePublisher>(tracker_receiver_.get());
+	pose_publisher_->SetMaxInterval(std::chrono::milliseconds(settings.pose_publish_max_interval_ms));
+	pose_publisher_->SetLatencyMonitor(latency_monitor_.get());
+	pose_publisher_->SetSourceMaxAge(std::chrono::milliseconds(settings.source_max_age_ms));
+	pose_publisher_->SetFilterSettings(settings.smoothing);
+	pose_publisher_->SetFallbackOffsets(my_tracker_fallback_offsets, MyTrackerCount);
+	pose_publisher_->SetLowLatency(settings.low_latency);
+
+	if ( !settings.capture_path.empty() )
+	{
+		capture_writer_ = std::make_unique<yolovr::DatagramCaptureWriter>();
+		if ( capture_writer_->Open( settings.capture_path ) )
+			tracker_receiver_->SetCaptureWriter( capture_writer_.get() );
+	}
+	if ( !settings.replay_path.empty() )
 	{
-		std::unique_ptr< MyTrackerDeviceDriver > tracker_device = std::make_unique< MyTrackerDeviceDriver >( i );
-
-		// Now we need to tell vrserver about our trackers.
-		// The first argument is the serial number of the device, which must be unique across all devices.
-		// We get it from our driver settings when we instantiate,
-		// And can pass it out of the function with MyGetSerialNumber().
-		// make sure we actually managed to create the device.
-		// TrackedDeviceAdded returning true means we have had our device added to SteamVR.
-		if ( !vr::VRServerDriverHost()->TrackedDeviceAdded( tracker_device->MyGetSerialNumber().c_str(),
-				 vr::TrackedDeviceClass_GenericTracker, tracker_device.get() ) )
+		capture_replay_ = std::make_unique<yolovr::CaptureReplay>( tracker_receiver_.get() );
+		if ( !capture_replay_->Open( settings.replay_path ) )
+			capture_replay_.reset();
+	}
+
+	// Register the startup trackers now; RunFrame adds the rest once their tracker_id shows up in a frame,
+	// so trackers the sender never provides cost neither a device nor pose submissions
+	for ( unsigned int i = 0; i < MyTrackerCount; i++ )
+	{
+		if ( ( settings.startup_trackers & ( uint64_t( 1 ) << i ) ) && !MyAddTracker( i ) )
 		{
-			DriverLog( "Failed to create tracker device with id %d!", i );
 			// We failed? Return early.
 			return vr::VRInitError_Driver_Unknown;
 		}
-
-		my_tracker_devices_.emplace_back( std::move( tracker_device ) );
 	}
 
-	// Initialize UDP receiver for external tracking data
-	tracker_receiver_ = std::make_unique<yolovr::TrackerDataReceiver>("0.0.0.0", 9999);
-	
-	if (tracker_receiver_->Start()) {
-		DriverLog("UDP tracker data receiver started on port 9999");
-	} else {
-		DriverLog("Failed to start UDP receiver, using fallback fake data");
-		// Don't fail initialization, just use fake data
+	// Replay a recorded session in place of the network, read a same-host sender's shared memory ring,
+	// or start the UDP receiver for external tracking data
+	if ( !capture_replay_ && !settings.shared_memory_name.empty() )
+	{
+		shared_memory_receiver_ = std::make_unique<yolovr::SharedMemoryReceiver>( tracker_receiver_.get() );
+		shared_memory_receiver_->SetLowLatency( settings.low_latency );
+		if ( !shared_memory_receiver_->Start( settings.shared_memory_name ) )
+		{
+			DriverLog( "Falling back to UDP on port 9999" );
+			shared_memory_receiver_.reset();
+		}
+	}
+	if ( capture_replay_ ) {
+		capture_replay_->Start( settings.replay );
+		DriverLog( "Replaying %s instead of receiving on port 9999", settings.replay_path.c_str() );
+	} else if ( !shared_memory_receiver_ ) {
+		if (tracker_receiver_->Start()) {
+			DriverLog("UDP tracker data receiver started on port 9999");
+		} else {
+			DriverLog("Failed to start UDP receiver, using fallback fake data");
+			// Don't fail initialization, just use fake data
+		}
 	}
 
-	DriverLog( "Created %d tracker devices successfully", number_of_tracker_types );
+	// One thread submits the poses of all devices, woken by new frames from the receiver
+	pose_publisher_->Start();
+
+	DriverLog( "Created %zu tracker devices at startup, the others are added when first received",
+		my_tracker_devices_.size() );
 	return vr::VRInitError_None;
 }
 
+//-----------------------------------------------------------------------------
+// Purpose: Creates the device for one of the MyTrackers and tells vrserver about it.
+//-----------------------------------------------------------------------------
+bool MyDeviceProvider::MyAddTracker( unsigned int tracker_id )
+{
+	my_added_trackers_ |= uint64_t( 1 ) << tracker_id;
+
+	std::unique_ptr< MyTrackerDeviceDriver > tracker_device = std::make_unique< MyTrackerDeviceDriver >( tracker_id, pose_publisher_.get(), settings_ );
+
+	// Now we need to tell vrserver about our trackers.
+	// The first argument is the serial number of the device, which must be unique across all devices.
+	// We get it from our driver settings when we instantiate,
+	// And can pass it out of the function with MyGetSerialNumber().
+	// make sure we actually managed to create the device.
+	// TrackedDeviceAdded returning true means we have had our device added to SteamVR.
+	if ( !vr::VRServerDriverHost()->TrackedDeviceAdded( tracker_device->MyGetSerialNumber().c_str(),
+			 vr::TrackedDeviceClass_GenericTracker, tracker_device.get() ) )
+	{
+		DriverLog( "Failed to create tracker device with id %u!", tracker_id );
+		return false;
+	}
+
+	pose_publisher_->AddDevice( tracker_device.get() );
+	my_tracker_devices_.emplace_back( std::move( tracker_device ) );
+	return true;
+}
+
 //-----------------------------------------------------------------------------
 // Purpose: Tells the runtime which version of the API we are targeting.
 // Helper variables in the header you're using contain this information, which can be returned here.
@@ -74,17 +147,23 @@ bool MyDeviceProvider::ShouldBlockStandbyMode()
 //-----------------------------------------------------------------------------
 void MyDeviceProvider::RunFrame()
 {
-	// Update all tracker devices with latest UDP data
-	yolovr::TrackerFrame latest_frame;
-	bool has_udp_data = tracker_receiver_ && tracker_receiver_->GetLatestFrame(latest_frame);
-	
+	// Add the device of any tracker_id seen in a frame for the first time. vrserver expects new devices from
+	// this thread, and a failed add is not retried.
+	const uint64_t all_trackers = ( uint64_t( 1 ) << MyTrackerCount ) - 1;
+	const uint64_t new_trackers = pose_publisher_->GetSlotTable().SeenMask() & all_trackers & ~my_added_trackers_;
+	for ( unsigned int i = 0; new_trackers && i < MyTrackerCount; i++ )
+	{
+		if ( new_trackers & ( uint64_t( 1 ) << i ) )
+		{
+			DriverLog( "Tracker id %u received for the first time, adding its device", i );
+			MyAddTracker( i );
+		}
+	}
+
+	// UDP frames reach the devices through the pose publisher thread, not this loop.
 	// call our devices to run a frame
 	for ( const auto &tracker : my_tracker_devices_ )
 	{
-		// Pass the UDP frame data to each tracker
-		if (has_udp_data) {
-			tracker->MyUpdateFromUDP(latest_frame);
-		}
 		tracker->MyRunFrame();
 	}
 
@@ -122,16 +201,36 @@ void MyDeviceProvider::LeaveStandby()
 //-----------------------------------------------------------------------------
 void MyDeviceProvider::Cleanup()
 {
-	// Stop UDP receiver
+	// Stop publishing poses before the receiver it reads from goes away
+	if (pose_publisher_) {
+		pose_publisher_->Stop();
+	}
+
+	// Stop replay, the shared memory reader or the UDP receiver
+	if ( capture_replay_ ) {
+		capture_replay_->Stop();
+		capture_replay_.reset();
+	}
+	if ( shared_memory_receiver_ ) {
+		shared_memory_receiver_->Stop();
+		shared_memory_receiver_.reset();
+	}
 	if (tracker_receiver_) {
 		tracker_receiver_->Stop();
 		tracker_receiver_.reset();
 		DriverLog("UDP tracker data receiver stopped");
 	}
+	capture_writer_.reset();
 	
 	// Our tracker devices will have already deactivated. Let's now destroy them.
 	for ( auto &tracker : my_tracker_devices_ )
 	{
 		tracker = nullptr;
 	}
+
+	pose_publisher_.reset();
+	latency_monitor_.reset();
+
+	// Last, so everything logged during shutdown still reaches vrserver
+	yolovr::AsyncLogger::Instance().Stop();
 }
\ No newline at end of file
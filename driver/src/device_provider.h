@@ -7,6 +7,11 @@
 #include "openvr_driver.h"
 #include "tracker_device_driver.h"
 #include "tracker_data_receiver.h"
+#include "pose_publisher.h"
+#include "capture_replay.h"
+#include "datagram_capture.h"
+#include "shared_memory_receiver.h"
+#include "driver_settings.h"
 #pragma once
 
 #include <memory>
@@ -30,6 +35,19 @@ public:
 	void Cleanup() override;
 
 private:
+	// Create the device for tracker_id and register it with vrserver
+	bool MyAddTracker( unsigned int tracker_id );
+
+	yolovr::DriverSettings settings_;
+
+	// A bit per tracker_id whose device has been added (or failed to be)
+	uint64_t my_added_trackers_ = 0;
+
 	std::vector< std::unique_ptr< MyTrackerDeviceDriver > > my_tracker_devices_;
+	std::unique_ptr<yolovr::LatencyMonitor> latency_monitor_;
 	std::unique_ptr<yolovr::TrackerDataReceiver> tracker_receiver_;
+	std::unique_ptr<yolovr::PosePublisher> pose_publisher_;
+	std::unique_ptr<yolovr::DatagramCaptureWriter> capture_writer_;
+	std::unique_ptr<yolovr::CaptureReplay> capture_replay_;
+	std::unique_ptr<yolovr::SharedMemoryReceiver> shared_memory_receiver_;
 };
\ No newline at end of file
@@ -0,0 +1,159 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+#include "driver_settings.h"
+
+#include "driverlog.h"
+#include "openvr_driver.h"
+#include "tracker_slot_table.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+
+namespace yolovr {
+
+const char* const kDriverSettingsSection = "driver_zincyolotrackers";
+
+namespace {
+
+void ReadInt32(const char* key, int32_t& value) {
+    vr::EVRSettingsError error = vr::VRSettingsError_None;
+    int32_t setting = vr::VRSettings()->GetInt32(kDriverSettingsSection, key, &error);
+    if (error == vr::VRSettingsError_None) {
+        value = setting;
+    }
+}
+
+void ReadBool(const char* key, bool& value) {
+    vr::EVRSettingsError error = vr::VRSettingsError_None;
+    bool setting = vr::VRSettings()->GetBool(kDriverSettingsSection, key, &error);
+    if (error == vr::VRSettingsError_None) {
+        value = setting;
+    }
+}
+
+void ReadFloat(const char* key, float& value) {
+    vr::EVRSettingsError error = vr::VRSettingsError_None;
+    float setting = vr::VRSettings()->GetFloat(kDriverSettingsSection, key, &error);
+    if (error == vr::VRSettingsError_None) {
+        value = setting;
+    }
+}
+
+void ReadString(const char* key, std::string& value) {
+    vr::EVRSettingsError error = vr::VRSettingsError_None;
+    char setting[1024] = {};
+    vr::VRSettings()->GetString(kDriverSettingsSection, key, setting, sizeof(setting), &error);
+    if (error == vr::VRSettingsError_None) {
+        value = setting;
+    }
+}
+
+void ReadLogLevel(const char* key, LogLevel& value) {
+    std::string setting;
+    ReadString(key, setting);
+    if (!setting.empty() && !ParseLogLevel(setting.c_str(), value)) {
+        DriverLog("Unknown %s \"%s\", keeping the default", key, setting.c_str());
+    }
+}
+
+// "all" or a comma-separated list of tracker_ids, as a bit per tracker_id
+void ReadTrackerMask(const char* key, uint64_t& value) {
+    std::string setting;
+    ReadString(key, setting);
+    if (setting.empty()) {
+        return;
+    }
+    if (setting == "all") {
+        value = ~uint64_t(0);
+        return;
+    }
+
+    uint64_t mask = 0;
+    const char* cursor = setting.c_str();
+    while (*cursor) {
+        char* end = nullptr;
+        const unsigned long id = std::strtoul(cursor, &end, 10);
+        if (end == cursor || id >= kMaxTrackerSlots || (*end != ',' && *end != '\0')) {
+            DriverLog("Invalid %s \"%s\", keeping the default", key, setting.c_str());
+            return;
+        }
+        mask |= uint64_t(1) << id;
+        cursor = *end == ',' ? end + 1 : end;
+    }
+    value = mask;
+}
+
+} // namespace
+
+DriverSettings DriverSettings::Load() {
+    DriverSettings settings;
+    ReadLogLevel("log_level", settings.log_level);
+    ReadTrackerMask("startup_trackers", settings.startup_trackers);
+
+    ReadInt32("pose_publish_max_interval_ms", settings.pose_publish_max_interval_ms);
+    if (settings.pose_publish_max_interval_ms < 1) {
+        settings.pose_publish_max_interval_ms = 1;
+    }
+
+    ReadInt32("receiver_shards", settings.receiver_shards);
+    if (settings.receiver_shards < 1) {
+        settings.receiver_shards = 1;
+    }
+    ReadInt32("receive_buffer_bytes", settings.receive_buffer_bytes);
+    if (settings.receive_buffer_bytes < 0) {
+        settings.receive_buffer_bytes = 0;
+    }
+    ReadInt32("source_max_age_ms", settings.source_max_age_ms);
+    if (settings.source_max_age_ms < 1) {
+        settings.source_max_age_ms = 1;
+    }
+    ReadInt32("clock_sync_interval_ms", settings.clock_sync_interval_ms);
+    if (settings.clock_sync_interval_ms < 0) {
+        settings.clock_sync_interval_ms = 0;
+    }
+
+    ReadBool("low_latency", settings.low_latency.enabled);
+    ReadInt32("receive_busy_poll_us", settings.low_latency.busy_poll_us);
+    ReadInt32("receive_spin_us", settings.low_latency.receive_spin_us);
+    ReadInt32("publisher_spin_us", settings.low_latency.publisher_spin_us);
+    ReadInt32("receiver_cpu", settings.low_latency.receiver_cpu);
+    ReadInt32("publisher_cpu", settings.low_latency.publisher_cpu);
+    ReadInt32("realtime_priority", settings.low_latency.realtime_priority);
+    settings.low_latency.busy_poll_us = std::max(settings.low_latency.busy_poll_us, 0);
+    settings.low_latency.receive_spin_us = std::max(settings.low_latency.receive_spin_us, 0);
+    settings.low_latency.publisher_spin_us = std::max(settings.low_latency.publisher_spin_us, 0);
+    settings.low_latency.realtime_priority = std::min(std::max(settings.low_latency.realtime_priority, 0), 99);
+
+    ReadString("shared_memory_name", settings.shared_memory_name);
+    ReadString("capture_path", settings.capture_path);
+    ReadString("replay_path", settings.replay_path);
+    ReadFloat("replay_speed", settings.replay.speed);
+    if (settings.replay.speed < 0.0f) {
+        settings.replay.speed = 0.0f;
+    }
+    ReadBool("replay_loop", settings.replay.loop);
+
+    ReadInt32("pose_hold_timeout_ms", settings.pose_hold_timeout_ms);
+    if (settings.pose_hold_timeout_ms < 0) {
+        settings.pose_hold_timeout_ms = 0;
+    }
+
+    ReadBool("use_prediction", settings.prediction.enabled);
+    ReadFloat("prediction_time", settings.prediction.lookahead_s);
+    ReadFloat("max_prediction_time", settings.prediction.max_prediction_s);
+    if (settings.prediction.max_prediction_s < 0.0f) {
+        settings.prediction.max_prediction_s = 0.0f;
+    }
+
+    ReadFloat("smoothing_factor", settings.smoothing.smoothing_factor);
+    ReadFloat("smoothing_position_beta", settings.smoothing.position_beta);
+    ReadFloat("smoothing_rotation_beta", settings.smoothing.rotation_beta);
+    ReadFloat("smoothing_bypass_confidence", settings.smoothing.bypass_confidence);
+    for (uint32_t id = 0; id < kMaxTrackersPerFrame; id++) {
+        const std::string key = "smoothing_factor_" + std::to_string(id);
+        ReadFloat(key.c_str(), settings.smoothing.tracker_smoothing_factor[id]);
+    }
+    return settings;
+}
+
+} // namespace yolovr
@@ -0,0 +1,75 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "async_logger.h"
+#include "capture_replay.h"
+#include "low_latency.h"
+#include "pose_filter_bank.h"
+#include "pose_predictor.h"
+
+namespace yolovr {
+
+// Settings section for this driver, see resources/settings/default.vrsettings
+extern const char* const kDriverSettingsSection;
+
+// Driver-wide tunables read once from SteamVR settings at Init. Every field
+// keeps its default when the key is missing.
+struct DriverSettings {
+    // log_level: "debug", "info", "warning" or "error"
+    LogLevel log_level = LogLevel::Info;
+
+    // startup_trackers: "all", or comma-separated tracker_ids registered with
+    // SteamVR at startup; a bit per tracker_id. Every other tracker is
+    // registered the first time its tracker_id appears in a received frame.
+    uint64_t startup_trackers = 0;
+
+    // Longest time the pose publisher waits for a new frame before
+    // resubmitting poses anyway (fallback trackers, stale data)
+    int32_t pose_publish_max_interval_ms = 5;
+
+    // Receive threads, each with its own SO_REUSEPORT socket (Linux only)
+    int32_t receiver_shards = 1;
+
+    // SO_RCVBUF requested for every receive socket, 0 for the system default
+    int32_t receive_buffer_bytes = 0;
+
+    // Sources not heard from for this long are dropped from fusion
+    int32_t source_max_age_ms = 100;
+
+    // How often each sender is pinged to synchronize its clock, 0 never
+    int32_t clock_sync_interval_ms = 250;
+
+    // low_latency, receive_busy_poll_us, receive_spin_us, publisher_spin_us,
+    // receiver_cpu, publisher_cpu, realtime_priority
+    LowLatencySettings low_latency;
+
+    // Read frames from this POSIX shared memory ring (e.g. "/yolovr_frames")
+    // instead of UDP (empty: UDP). Linux only.
+    std::string shared_memory_name;
+
+    // Append every received datagram to this file (empty: no capture)
+    std::string capture_path;
+
+    // Replay this capture instead of listening on the network (empty: live).
+    // replay_speed scales the recorded timing, 0 replays as fast as possible.
+    std::string replay_path;
+    CaptureReplay::Options replay;     // replay_speed, replay_loop
+
+    // How long a tracker keeps using its last UDP pose after the last frame that
+    // had it tracking, before it falls back to following the HMD
+    int32_t pose_hold_timeout_ms = 500;
+
+    // use_prediction, prediction_time (s), max_prediction_time (s)
+    PredictionSettings prediction;
+
+    // smoothing_factor, smoothing_factor_<tracker_id>, smoothing_position_beta,
+    // smoothing_rotation_beta, smoothing_bypass_confidence
+    FilterSettings smoothing;
+
+    static DriverSettings Load();
+};
+
+} // namespace yolovr
@@ -0,0 +1,90 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+#include "frame_sequencer.h"
+
+namespace yolovr {
+
+FrameSequencer::FrameSequencer() {
+    Reset();
+}
+
+void FrameSequencer::Reset() {
+    for (SourceState& source : sources_) {
+        source = SourceState{};
+    }
+    counters_ = Counters{};
+}
+
+FrameSequencer::SourceState& FrameSequencer::FindSource(uint32_t source_id, int64_t now_ns) {
+    SourceState* oldest = &sources_[0];
+    for (SourceState& source : sources_) {
+        if (source.in_use && source.source_id == source_id) {
+            return source;
+        }
+        if (!source.in_use) {
+            oldest = &source;
+        } else if (oldest->in_use && source.last_seen_ns < oldest->last_seen_ns) {
+            oldest = &source;
+        }
+    }
+
+    // New source: take a free entry, or the one heard from least recently
+    *oldest = SourceState{};
+    oldest->source_id = source_id;
+    oldest->last_seen_ns = now_ns;
+    return *oldest;
+}
+
+FrameSequencer::Verdict FrameSequencer::Check(uint32_t source_id, uint64_t frame_id, int64_t now_ns) {
+    if (frame_id == 0) {
+        return Verdict::Accept;
+    }
+
+    SourceState& source = FindSource(source_id, now_ns);
+    if (source.in_use &&
+        (now_ns - source.last_seen_ns > kRestartTimeoutNs || frame_id + kRestartGap < source.highest_frame_id ||
+         frame_id > source.highest_frame_id + kRestartGap ||
+         (frame_id <= source.highest_frame_id && source.rejected_run + 1 >= kRestartRejects))) {
+        counters_.source_restarts++;
+        source.in_use = false;
+    }
+
+    if (!source.in_use) {
+        source.in_use = true;
+        source.highest_frame_id = frame_id;
+        source.received_window = 1;
+        source.last_seen_ns = now_ns;
+        source.rejected_run = 0;
+        return Verdict::Accept;
+    }
+
+    if (frame_id > source.highest_frame_id) {
+        const uint64_t advance = frame_id - source.highest_frame_id;
+        counters_.frames_lost += advance - 1;
+        source.received_window = advance < kWindow ? (source.received_window << advance) | 1 : 1;
+        source.highest_frame_id = frame_id;
+        source.last_seen_ns = now_ns;
+        source.rejected_run = 0;
+        return Verdict::Accept;
+    }
+
+    // Rejected frames do not keep the source alive, so a restarted sender
+    // still resolves by timeout if it is not caught by the run below
+    source.rejected_run++;
+    const uint64_t behind = source.highest_frame_id - frame_id;
+    if (behind < kWindow) {
+        const uint64_t bit = uint64_t(1) << behind;
+        if (source.received_window & bit) {
+            counters_.frames_duplicate++;
+            return Verdict::Duplicate;
+        }
+        // It did arrive after all, just too late to use
+        source.received_window |= bit;
+        if (counters_.frames_lost > 0) {
+            counters_.frames_lost--;
+        }
+    }
+    counters_.frames_reordered++;
+    return Verdict::Late;
+}
+
+} // namespace yolovr
@@ -0,0 +1,70 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace yolovr {
+
+// Orders incoming frames by TrackerFrame.frame_id, separately per source_id.
+//
+// Only frames newer than the newest accepted one from the same source are
+// accepted, so a datagram delayed on the network can never replace a newer
+// pose. A sliding window over the last kWindow frame ids tells late frames
+// (reordered, already counted as lost when the gap was seen) apart from
+// duplicates. frame_id 0 is what a sender that does not number its frames
+// sends, and is always accepted.
+//
+// A source that has no frame accepted for kRestartTimeoutNs, whose frame_id
+// jumps by more than kRestartGap either way, or that sends kRestartRejects
+// late or duplicate frames in a row (a restart that reset frame_id by less
+// than kRestartGap) is assumed to have restarted, and its sequence starts
+// over without counting the jump as loss.
+//
+// Not thread-safe; used by the receiver thread only.
+class FrameSequencer {
+public:
+    enum class Verdict {
+        Accept,
+        Duplicate,  // Already accepted, or the same frame again
+        Late,       // Older than the newest accepted frame of its source
+    };
+
+    struct Counters {
+        uint64_t frames_lost;       // Gaps in frame_id that were never filled
+        uint64_t frames_reordered;  // Arrived after a newer frame of the same source
+        uint64_t frames_duplicate;
+        uint64_t source_restarts;
+    };
+
+    static constexpr size_t kMaxSources = 16;
+    static constexpr uint64_t kWindow = 64;
+    static constexpr uint64_t kRestartGap = 1024;
+    static constexpr int64_t kRestartTimeoutNs = 1000000000;
+    static constexpr uint32_t kRestartRejects = 8;
+
+    FrameSequencer();
+
+    Verdict Check(uint32_t source_id, uint64_t frame_id, int64_t now_ns);
+
+    const Counters& GetCounters() const { return counters_; }
+
+    void Reset();
+
+private:
+    struct SourceState {
+        uint32_t source_id;
+        bool in_use;
+        uint64_t highest_frame_id;
+        uint64_t received_window;   // Bit n set: highest_frame_id - n was received
+        int64_t last_seen_ns;       // Last accepted frame
+        uint32_t rejected_run;      // Late or duplicate frames since then
+    };
+
+    SourceState& FindSource(uint32_t source_id, int64_t now_ns);
+
+    SourceState sources_[kMaxSources];
+    Counters counters_;
+};
+
+} // namespace yolovr
@@ -0,0 +1,72 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+#include "hmd_pose_cache.h"
+
+#include "vrmath.h"
+
+namespace yolovr {
+
+HmdPoseCache::HmdPoseCache()
+    : requested_(false)
+    , max_age_ns_(10000000)
+    , offset_count_(0)
+    , offsets_{}
+{
+}
+
+void HmdPoseCache::SetOffsets(const float (*offsets)[3], size_t count) {
+    offset_count_ = count < kMaxTrackers ? count : kMaxTrackers;
+    for (size_t i = 0; i < offset_count_; i++) {
+        for (int axis = 0; axis < 3; axis++) {
+            offsets_[axis][i] = offsets[i][axis];
+        }
+    }
+}
+
+bool HmdPoseCache::Update(int64_t now_ns) {
+    if (!requested_.exchange(false, std::memory_order_relaxed)) {
+        return false;
+    }
+
+    Sample sample = {};
+    FetchHmdPose(now_ns, sample);
+    const float* const offsets[3] = { offsets_[0], offsets_[1], offsets_[2] };
+    float* const positions[3] = { sample.tracker_position[0], sample.tracker_position[1], sample.tracker_position[2] };
+    TransformOffsets(sample.hmd_to_world, offsets, offset_count_, positions);
+    sample_.Store(sample);
+    return true;
+}
+
+bool HmdPoseCache::Read(int64_t now_ns, Sample& sample) const {
+    return sample_.Load(sample) != 0 && now_ns - sample.sample_time_ns <= max_age_ns_;
+}
+
+void HmdPoseCache::FetchHmdPose(int64_t now_ns, Sample& sample) {
+    vr::TrackedDevicePose_t hmd_pose{};
+    vr::VRServerDriverHost()->GetRawTrackedDevicePoses(0.f, &hmd_pose, 1);
+
+    sample.sample_time_ns = now_ns;
+    sample.hmd_to_world = hmd_pose.mDeviceToAbsoluteTracking;
+    sample.hmd_rotation = HmdQuaternion_FromMatrix(hmd_pose.mDeviceToAbsoluteTracking);
+}
+
+void HmdPoseCache::TransformOffsets(const vr::HmdMatrix34_t& hmd_to_world, const float* const offset[3], size_t count,
+                                    float* const out[3]) {
+    // The 3x4 matrix is rotation | translation, so each output axis is one
+    // multiply-add chain over all offsets; the loops vectorize
+    const float (*m)[4] = hmd_to_world.m;
+    const float* x = offset[0];
+    const float* y = offset[1];
+    const float* z = offset[2];
+    for (int axis = 0; axis < 3; axis++) {
+        const float r0 = m[axis][0];
+        const float r1 = m[axis][1];
+        const float r2 = m[axis][2];
+        const float t = m[axis][3];
+        float* result = out[axis];
+        for (size_t i = 0; i < count; i++) {
+            result[i] = r0 * x[i] + r1 * y[i] + r2 * z[i] + t;
+        }
+    }
+}
+
+} // namespace yolovr
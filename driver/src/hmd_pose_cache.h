@@ -0,0 +1,74 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "openvr_driver.h"
+#include "seqlock.h"
+
+namespace yolovr {
+
+// The HMD pose shared by every tracker that follows the HMD (no UDP data).
+//
+// The pose publisher fetches the HMD pose from vrserver once per publish pass
+// and moves every tracker's offset into world space in one structure-of-arrays
+// pass, so all fallback trackers in a pass use the same HMD sample and
+// vrserver is asked once instead of once per device. Passes only fetch while
+// some device asked for the HMD pose (Request) since the previous pass, so
+// trackers on UDP data cost no host calls.
+//
+// Offsets are set once before the publisher starts. Update() must only be
+// called from one thread; Read() and Request() from any thread.
+class HmdPoseCache {
+public:
+    static constexpr size_t kMaxTrackers = 16;
+
+    struct Sample {
+        int64_t sample_time_ns;             // steady_clock time of the fetch
+        vr::HmdMatrix34_t hmd_to_world;
+        vr::HmdQuaternion_t hmd_rotation;
+        alignas(16) float tracker_position[3][kMaxTrackers];    // x, y, z of each offset in world space
+    };
+
+    HmdPoseCache();
+
+    HmdPoseCache(const HmdPoseCache&) = delete;
+    HmdPoseCache& operator=(const HmdPoseCache&) = delete;
+
+    // offsets[i] is tracker i's position relative to the HMD, in HMD space.
+    // At most kMaxTrackers.
+    void SetOffsets(const float (*offsets)[3], size_t count);
+
+    // Samples older than this are not returned by Read()
+    void SetMaxAge(int64_t max_age_ns) { max_age_ns_ = max_age_ns; }
+
+    // Ask for the HMD pose to be fetched on the next Update()
+    void Request() { requested_.store(true, std::memory_order_relaxed); }
+
+    // Fetch and transform if Request() was called since the last Update().
+    // Returns true if it fetched.
+    bool Update(int64_t now_ns);
+
+    // Copy the newest sample. Returns false if there is none younger than the max age.
+    bool Read(int64_t now_ns, Sample& sample) const;
+
+    // Fetch the HMD pose from vrserver into sample, without transforming any offsets
+    static void FetchHmdPose(int64_t now_ns, Sample& sample);
+
+    // out[axis][i] = rotation(hmd_to_world) * offset[i] + translation(hmd_to_world),
+    // for count offsets given as one array per axis
+    static void TransformOffsets(const vr::HmdMatrix34_t& hmd_to_world, const float* const offset[3], size_t count,
+                                 float* const out[3]);
+
+private:
+    SeqLock<Sample> sample_;
+    std::atomic<bool> requested_;
+    int64_t max_age_ns_;
+
+    size_t offset_count_;
+    alignas(16) float offsets_[3][kMaxTrackers];
+};
+
+} // namespace yolovr
@@ -0,0 +1,89 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+#include "latency_histogram.h"
+
+namespace yolovr {
+
+namespace {
+
+int HighestBit(uint64_t value) {
+    int bit = 0;
+    while (value >>= 1) {
+        bit++;
+    }
+    return bit;
+}
+
+} // namespace
+
+size_t LatencyHistogram::BucketIndex(uint64_t value_ns) {
+    if (value_ns < kSubBuckets) {
+        return static_cast<size_t>(value_ns);
+    }
+    // Bucket group by the highest set bit, then the next kSubBucketBits bits linearly
+    const int msb = HighestBit(value_ns);
+    const int shift = msb - kSubBucketBits;
+    const size_t group = static_cast<size_t>(msb - kSubBucketBits + 1);
+    return group * kSubBuckets + static_cast<size_t>((value_ns >> shift) & (kSubBuckets - 1));
+}
+
+uint64_t LatencyHistogram::BucketUpperBound(size_t index) {
+    const size_t group = index / kSubBuckets;
+    const uint64_t sub = index % kSubBuckets;
+    if (group == 0) {
+        return sub;
+    }
+    const int shift = static_cast<int>(group) - 1;
+    const uint64_t lower = (kSubBuckets + sub) << shift;
+    return lower + (uint64_t(1) << shift) - 1;
+}
+
+void LatencyHistogram::Reset() {
+    for (std::atomic<uint32_t>& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    total_ns_.store(0, std::memory_order_relaxed);
+    max_ns_.store(0, std::memory_order_relaxed);
+}
+
+LatencyHistogram::Summary LatencyHistogram::Summarize() const {
+    Summary summary{};
+
+    uint32_t counts[kBucketCount];
+    for (size_t i = 0; i < kBucketCount; i++) {
+        counts[i] = buckets_[i].load(std::memory_order_relaxed);
+        summary.count += counts[i];
+    }
+    summary.max_ns = max_ns_.load(std::memory_order_relaxed);
+    if (summary.count == 0) {
+        return summary;
+    }
+    summary.mean_ns = total_ns_.load(std::memory_order_relaxed) / summary.count;
+
+    // Rank of each percentile, rounded up so p99 of 100 samples is the 99th
+    const uint64_t rank50 = (summary.count * 50 + 99) / 100;
+    const uint64_t rank90 = (summary.count * 90 + 99) / 100;
+    const uint64_t rank99 = (summary.count * 99 + 99) / 100;
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBucketCount; i++) {
+        if (counts[i] == 0) {
+            continue;
+        }
+        const uint64_t before = seen;
+        seen += counts[i];
+        const uint64_t value = BucketUpperBound(i) < summary.max_ns ? BucketUpperBound(i) : summary.max_ns;
+        if (before < rank50 && seen >= rank50) {
+            summary.p50_ns = value;
+        }
+        if (before < rank90 && seen >= rank90) {
+            summary.p90_ns = value;
+        }
+        if (before < rank99 && seen >= rank99) {
+            summary.p99_ns = value;
+            break;
+        }
+    }
+    return summary;
+}
+
+} // namespace yolovr
@@ -0,0 +1,66 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace yolovr {
+
+// Log-linear (HDR-style) histogram of nanosecond durations.
+//
+// Every power of two is split into kSubBuckets linear buckets, so any value is
+// recorded with about 6% relative error from 16 ns up to kMaxValueNs (larger
+// values land in the last bucket). Record() is a relaxed atomic increment and
+// may be called from any number of threads; readers take a Snapshot().
+class LatencyHistogram {
+public:
+    static constexpr int kSubBucketBits = 4;
+    static constexpr size_t kSubBuckets = size_t(1) << kSubBucketBits;
+    static constexpr int kMaxValueBits = 36;    // ~68 s
+    static constexpr uint64_t kMaxValueNs = (uint64_t(1) << kMaxValueBits) - 1;
+    static constexpr size_t kBucketCount = (kMaxValueBits - kSubBucketBits + 1) * kSubBuckets;
+
+    // Summary computed from a consistent-enough copy of the buckets
+    struct Summary {
+        uint64_t count;
+        uint64_t p50_ns;
+        uint64_t p90_ns;
+        uint64_t p99_ns;
+        uint64_t max_ns;
+        uint64_t mean_ns;
+    };
+
+    LatencyHistogram() { Reset(); }
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    void Record(uint64_t value_ns) {
+        if (value_ns > kMaxValueNs) {
+            value_ns = kMaxValueNs;
+        }
+        buckets_[BucketIndex(value_ns)].fetch_add(1, std::memory_order_relaxed);
+        total_ns_.fetch_add(value_ns, std::memory_order_relaxed);
+        uint64_t max = max_ns_.load(std::memory_order_relaxed);
+        while (value_ns > max && !max_ns_.compare_exchange_weak(max, value_ns, std::memory_order_relaxed)) {
+        }
+    }
+
+    // Not atomic with respect to concurrent Record(); a few samples may straddle a reset
+    void Reset();
+
+    Summary Summarize() const;
+
+    static size_t BucketIndex(uint64_t value_ns);
+
+    // Highest value that maps to the bucket
+    static uint64_t BucketUpperBound(size_t index);
+
+private:
+    std::atomic<uint32_t> buckets_[kBucketCount];
+    std::atomic<uint64_t> total_ns_;
+    std::atomic<uint64_t> max_ns_;
+};
+
+} // namespace yolovr
@@ -0,0 +1,103 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+#include "latency_monitor.h"
+#include "report_writer.h"
+
+namespace yolovr {
+
+namespace {
+
+void AppendStage(ReportWriter& writer, const char* separator, LatencyStage stage, const LatencyHistogram& histogram) {
+    const LatencyHistogram::Summary summary = histogram.Summarize();
+    writer.Append("%s\"%s\":{\"count\":%llu,\"p50_us\":%.1f,\"p90_us\":%.1f,\"p99_us\":%.1f,\"max_us\":%.1f,\"mean_us\":%.1f}",
+                  separator, LatencyStageName(stage), static_cast<unsigned long long>(summary.count),
+                  summary.p50_ns / 1e3, summary.p90_ns / 1e3, summary.p99_ns / 1e3, summary.max_ns / 1e3,
+                  summary.mean_ns / 1e3);
+}
+
+} // namespace
+
+const char* LatencyStageName(LatencyStage stage) {
+    switch (stage) {
+    case LatencyStage::SenderToArrival: return "sender_to_arrival";
+    case LatencyStage::ArrivalToParsed: return "arrival_to_parsed";
+    case LatencyStage::ParsedToDemux: return "parsed_to_demux";
+    case LatencyStage::DemuxToSubmit: return "demux_to_submit";
+    case LatencyStage::ArrivalToSubmit: return "arrival_to_submit";
+    default: return "unknown";
+    }
+}
+
+LatencyMonitor::LatencyMonitor() {
+    for (std::atomic<uint32_t>& key : source_keys_) {
+        key.store(0, std::memory_order_relaxed);
+    }
+}
+
+void LatencyMonitor::RecordSource(uint32_t source_id, LatencyStage stage, int64_t duration_ns) {
+    if (duration_ns < 0 || stage >= LatencyStage::Count) {
+        return;
+    }
+    const uint32_t key = source_id + 1;
+    for (size_t i = 0; i < kMaxSources; i++) {
+        uint32_t current = source_keys_[i].load(std::memory_order_acquire);
+        if (current == 0 && source_keys_[i].compare_exchange_strong(current, key, std::memory_order_acq_rel)) {
+            current = key;
+        }
+        if (current == key) {
+            sources_[i].stages[static_cast<size_t>(stage)].Record(static_cast<uint64_t>(duration_ns));
+            return;
+        }
+    }
+}
+
+void LatencyMonitor::RecordTracker(uint32_t tracker_id, LatencyStage stage, int64_t duration_ns) {
+    if (duration_ns < 0 || tracker_id >= kMaxTrackerSlots || stage >= LatencyStage::Count) {
+        return;
+    }
+    trackers_[tracker_id].stages[static_cast<size_t>(stage)].Record(static_cast<uint64_t>(duration_ns));
+}
+
+void LatencyMonitor::Reset() {
+    for (size_t i = 0; i < kMaxSources; i++) {
+        for (LatencyHistogram& histogram : sources_[i].stages) {
+            histogram.Reset();
+        }
+    }
+    for (size_t i = 0; i < kMaxTrackerSlots; i++) {
+        for (LatencyHistogram& histogram : trackers_[i].stages) {
+            histogram.Reset();
+        }
+    }
+}
+
+size_t LatencyMonitor::FormatReport(uint32_t tracker_id, char* out, size_t out_size) const {
+    ReportWriter writer(out, out_size);
+
+    writer.Append("{\"tracker_id\":%u,\"tracker\":{", tracker_id);
+    if (tracker_id < kMaxTrackerSlots) {
+        const LatencyStage stages[] = { LatencyStage::ParsedToDemux, LatencyStage::DemuxToSubmit, LatencyStage::ArrivalToSubmit };
+        const char* separator = "";
+        for (LatencyStage stage : stages) {
+            AppendStage(writer, separator, stage, trackers_[tracker_id].stages[static_cast<size_t>(stage)]);
+            separator = ",";
+        }
+    }
+    writer.Append("},\"sources\":[");
+
+    const char* source_separator = "";
+    for (size_t i = 0; i < kMaxSources; i++) {
+        const uint32_t key = source_keys_[i].load(std::memory_order_acquire);
+        if (key == 0) {
+            continue;
+        }
+        writer.Append("%s{\"source_id\":%u", source_separator, key - 1);
+        AppendStage(writer, ",", LatencyStage::SenderToArrival, sources_[i].stages[static_cast<size_t>(LatencyStage::SenderToArrival)]);
+        AppendStage(writer, ",", LatencyStage::ArrivalToParsed, sources_[i].stages[static_cast<size_t>(LatencyStage::ArrivalToParsed)]);
+        writer.Append("}");
+        source_separator = ",";
+    }
+    writer.Append("]}");
+    return writer.Length();
+}
+
+} // namespace yolovr
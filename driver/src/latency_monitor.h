@@ -0,0 +1,67 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "latency_histogram.h"
+#include "tracker_slot_table.h"
+
+namespace yolovr {
+
+// Where a tracker pose spends its time between the sender and SteamVR
+enum class LatencyStage {
+    SenderToArrival,    // Frame timestamp (sender clock) -> kernel received the datagram (driver clock)
+    ArrivalToParsed,    // Kernel received the datagram -> frame decoded and sequenced
+    ParsedToDemux,      // Frame decoded -> demultiplexed into the slot table
+    DemuxToSubmit,      // Demultiplexed -> TrackedDevicePoseUpdated returned
+    ArrivalToSubmit,    // Kernel received the datagram -> TrackedDevicePoseUpdated returned
+    Count,
+};
+
+const char* LatencyStageName(LatencyStage stage);
+
+// Latency histograms per source_id for the receive stages (SenderToArrival,
+// ArrivalToParsed) and per tracker_id for the publish stages (ParsedToDemux,
+// DemuxToSubmit, ArrivalToSubmit).
+//
+// Recording is lock-free and allocation-free from any thread. A source_id gets
+// its histograms the first time it is recorded; sources beyond kMaxSources are
+// not recorded. SenderToArrival maps the sender timestamp through the
+// receiver's clock sync once the sender answers pings; before that it compares
+// the system clocks of both machines and is only meaningful when they agree.
+// Where the receiver has no kernel receive timestamps (Windows, injected
+// datagrams) arrival is when it woke up for the datagram instead.
+class LatencyMonitor {
+public:
+    static constexpr size_t kMaxSources = 16;
+
+    LatencyMonitor();
+
+    LatencyMonitor(const LatencyMonitor&) = delete;
+    LatencyMonitor& operator=(const LatencyMonitor&) = delete;
+
+    void RecordSource(uint32_t source_id, LatencyStage stage, int64_t duration_ns);
+    void RecordTracker(uint32_t tracker_id, LatencyStage stage, int64_t duration_ns);
+
+    void Reset();
+
+    // Write a JSON report for one tracker and every source into out, always
+    // NUL-terminated. Returns the length the full report needs (like snprintf).
+    size_t FormatReport(uint32_t tracker_id, char* out, size_t out_size) const;
+
+private:
+    static constexpr size_t kStageCount = static_cast<size_t>(LatencyStage::Count);
+
+    struct Histograms {
+        LatencyHistogram stages[kStageCount];
+    };
+
+    // source_id + 1 per entry, 0 while the entry is free
+    std::atomic<uint32_t> source_keys_[kMaxSources];
+    Histograms sources_[kMaxSources];
+    Histograms trackers_[kMaxTrackerSlots];
+};
+
+} // namespace yolovr
@@ -0,0 +1,71 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+#include "low_latency.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include "driverlog.h"
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <pthread.h>
+    #include <sched.h>
+#endif
+
+namespace yolovr {
+
+bool TuneCurrentThread(const char* name, int32_t cpu, int32_t realtime_priority) {
+    bool ok = true;
+
+#if defined(_WIN32)
+    if (cpu >= 0) {
+        if (cpu >= 64 || SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpu) == 0) {
+            DriverLog("Could not pin the %s thread to CPU %d: %lu", name, cpu, GetLastError());
+            ok = false;
+        }
+    }
+    if (realtime_priority > 0 && !SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL)) {
+        DriverLog("Could not raise the %s thread to time-critical priority: %lu", name, GetLastError());
+        ok = false;
+    }
+#else
+    if (cpu >= 0) {
+#ifdef __linux__
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        int error = cpu < CPU_SETSIZE ? 0 : EINVAL;
+        if (error == 0) {
+            CPU_SET(cpu, &cpus);
+            error = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+        }
+        if (error != 0) {
+            DriverLog("Could not pin the %s thread to CPU %d: %s", name, cpu, strerror(error));
+            ok = false;
+        }
+#else
+        DriverLog("Pinning threads to a CPU is not supported on this platform, the %s thread is unpinned", name);
+        ok = false;
+#endif
+    }
+    if (realtime_priority > 0) {
+        sched_param param;
+        std::memset(&param, 0, sizeof(param));
+        const int max_priority = sched_get_priority_max(SCHED_FIFO);
+        param.sched_priority = realtime_priority < max_priority ? realtime_priority : max_priority;
+        const int error = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (error != 0) {
+            DriverLog("Could not run the %s thread as SCHED_FIFO priority %d: %s (needs CAP_SYS_NICE or RLIMIT_RTPRIO)",
+                      name, param.sched_priority, strerror(error));
+            ok = false;
+        }
+    }
+#endif
+
+    if (ok && (cpu >= 0 || realtime_priority > 0)) {
+        DriverLog("Low latency: %s thread on CPU %d, real-time priority %d", name, cpu, realtime_priority);
+    }
+    return ok;
+}
+
+} // namespace yolovr
@@ -0,0 +1,42 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+#pragma once
+
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    #include <immintrin.h>
+#endif
+
+namespace yolovr {
+
+// Opt-in mode that spends CPU time on lower and steadier receive latency:
+// receive threads poll instead of sleeping while data is flowing, and the
+// receive and publish threads can be pinned to a core and run SCHED_FIFO.
+// The other fields only apply while enabled is set.
+struct LowLatencySettings {
+    bool enabled = false;
+    int32_t busy_poll_us = 50;          // SO_BUSY_POLL of the receive sockets (Linux), 0 to leave it unset
+    int32_t receive_spin_us = 50000;    // Receive threads poll this long after the last datagram before blocking
+    int32_t publisher_spin_us = 0;      // The pose publisher polls for new frames this long before blocking
+    int32_t receiver_cpu = -1;          // Core of the receive thread, shard i on receiver_cpu + i; -1 unpinned
+    int32_t publisher_cpu = -1;         // Core of the pose publisher thread; -1 unpinned
+    int32_t realtime_priority = 0;      // SCHED_FIFO priority (1-99) of both, 0 keeps the normal scheduler
+};
+
+// Pin the calling thread to cpu unless it is negative, and move it to
+// SCHED_FIFO at realtime_priority if that is positive (on Windows the
+// affinity mask and THREAD_PRIORITY_TIME_CRITICAL). Logs what could not be
+// applied, e.g. SCHED_FIFO without CAP_SYS_NICE or an RLIMIT_RTPRIO, and
+// returns false; the thread runs on either way.
+bool TuneCurrentThread(const char* name, int32_t cpu, int32_t realtime_priority);
+
+// Pause hint for spin-wait loops
+inline void SpinPause() {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+} // namespace yolovr
@@ -0,0 +1,174 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+#include "pose_filter_bank.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace yolovr {
+
+namespace {
+
+constexpr float kTwoPi = 6.2831853f;
+
+// Minimum cutoff for smoothing_factor in (0, 1]: 10 Hz (light) down to 0.5 Hz (heavy)
+constexpr float kLightestCutoffHz = 10.0f;
+constexpr float kHeaviestCutoffHz = 0.5f;
+
+// Frame gaps outside this range restart the filter instead of smoothing across them
+constexpr float kMinFrameDelta = 1e-4f;
+constexpr float kMaxFrameDelta = 0.25f;
+
+float MinCutoffForSmoothing(float smoothing_factor) {
+    if (smoothing_factor <= 0.0f) {
+        return 0.0f;
+    }
+    smoothing_factor = std::min(smoothing_factor, 1.0f);
+    return kLightestCutoffHz * std::pow(kHeaviestCutoffHz / kLightestCutoffHz, smoothing_factor);
+}
+
+// Exponential smoothing gain for a first-order low-pass at cutoff_hz
+inline float Gain(float cutoff_hz, float dt) {
+    const float r = kTwoPi * cutoff_hz * dt;
+    return r / (r + 1.0f);
+}
+
+} // namespace
+
+PoseFilterBank::PoseFilterBank() {
+    Configure(FilterSettings());
+}
+
+void PoseFilterBank::Configure(const FilterSettings& settings) {
+    settings_ = settings;
+    for (uint32_t id = 0; id < kMaxTrackersPerFrame; id++) {
+        const float factor = settings.tracker_smoothing_factor[id] >= 0.0f
+            ? settings.tracker_smoothing_factor[id]
+            : settings.smoothing_factor;
+        min_cutoff_by_id_[id] = MinCutoffForSmoothing(factor);
+    }
+    Reset();
+}
+
+void PoseFilterBank::SetTrackerSmoothing(uint32_t tracker_id, float smoothing_factor) {
+    if (tracker_id >= kMaxTrackersPerFrame) {
+        return;
+    }
+    settings_.tracker_smoothing_factor[tracker_id] = smoothing_factor;
+    min_cutoff_by_id_[tracker_id] = MinCutoffForSmoothing(smoothing_factor);
+    for (size_t i = 0; i < kMaxTrackersPerFrame; i++) {
+        if (slot_tracker_id_[i] == tracker_id) {
+            min_cutoff_[i] = min_cutoff_by_id_[tracker_id];
+        }
+    }
+}
+
+void PoseFilterBank::Reset() {
+    has_history_ = false;
+    last_timestamp_us_ = 0;
+    last_arrival_time_ns_ = 0;
+    for (size_t i = 0; i < kMaxTrackersPerFrame; i++) {
+        slot_tracker_id_[i] = kNoTracker;
+    }
+}
+
+void PoseFilterBank::ResetSlot(const TrackerPoseArrays& poses, size_t i) {
+    const uint32_t id = poses.tracker_id[i];
+    slot_tracker_id_[i] = id;
+    min_cutoff_[i] = id < kMaxTrackersPerFrame ? min_cutoff_by_id_[id] : 0.0f;
+    for (int axis = 0; axis < 3; axis++) {
+        value_[axis][i] = poses.position[axis][i];
+    }
+    for (int axis = 0; axis < 4; axis++) {
+        value_[3 + axis][i] = poses.rotation[axis][i];
+    }
+    for (int channel = 0; channel < kChannels; channel++) {
+        speed_[channel][i] = 0.0f;
+    }
+}
+
+float PoseFilterBank::FrameDeltaSeconds(const TrackerFrameSnapshot& frame) const {
+    // Prefer the sender's capture clock; arrival times include network jitter
+    if (frame.timestamp_us > last_timestamp_us_ && last_timestamp_us_ != 0) {
+        return static_cast<float>(frame.timestamp_us - last_timestamp_us_) * 1e-6f;
+    }
+    return static_cast<float>(frame.arrival_time_ns - last_arrival_time_ns_) * 1e-9f;
+}
+
+void PoseFilterBank::Apply(TrackerFrameSnapshot& frame) {
+    TrackerPoseArrays& poses = frame.poses;
+    const size_t count = std::min<size_t>(frame.tracker_count, kMaxTrackersPerFrame);
+
+    const float dt = FrameDeltaSeconds(frame);
+    const bool restart = !has_history_ || dt < kMinFrameDelta || dt > kMaxFrameDelta;
+    has_history_ = true;
+    last_timestamp_us_ = frame.timestamp_us;
+    last_arrival_time_ns_ = frame.arrival_time_ns;
+
+    // Rare path: new trackers or a gap in the stream
+    for (size_t i = 0; i < count; i++) {
+        if (restart || slot_tracker_id_[i] != poses.tracker_id[i]) {
+            ResetSlot(poses, i);
+        }
+    }
+    // A tracker that drops out of the frame starts fresh when it comes back
+    for (size_t i = count; i < kMaxTrackersPerFrame; i++) {
+        slot_tracker_id_[i] = kNoTracker;
+    }
+    if (restart) {
+        return;
+    }
+
+    const float derivative_gain = Gain(settings_.derivative_cutoff_hz, dt);
+    const float inv_dt = 1.0f / dt;
+    const float bypass_confidence = settings_.bypass_confidence;
+
+    for (size_t i = 0; i < count; i++) {
+        const bool bypass = !poses.is_tracking[i] || poses.confidence[i] >= bypass_confidence || min_cutoff_[i] <= 0.0f;
+        pass_through_[i] = bypass ? 1.0f : 0.0f;
+    }
+
+    // q and -q are the same rotation; keep the input on the same hemisphere as the state
+    for (size_t i = 0; i < count; i++) {
+        const float dot = poses.rotation[0][i] * value_[3][i] + poses.rotation[1][i] * value_[4][i] +
+                          poses.rotation[2][i] * value_[5][i] + poses.rotation[3][i] * value_[6][i];
+        const float sign = dot < 0.0f ? -1.0f : 1.0f;
+        for (int axis = 0; axis < 4; axis++) {
+            poses.rotation[axis][i] *= sign;
+        }
+    }
+
+    for (int channel = 0; channel < kChannels; channel++) {
+        float* input = channel < 3 ? poses.position[channel] : poses.rotation[channel - 3];
+        float* value = value_[channel];
+        float* speed = speed_[channel];
+        const float beta = channel < 3 ? settings_.position_beta : settings_.rotation_beta;
+
+        for (size_t i = 0; i < count; i++) {
+            const float raw_speed = (input[i] - value[i]) * inv_dt;
+            const float smoothed_speed = speed[i] + derivative_gain * (raw_speed - speed[i]);
+            const float cutoff = min_cutoff_[i] + beta * std::fabs(smoothed_speed);
+            const float smoothed = value[i] + Gain(cutoff, dt) * (input[i] - value[i]);
+            // Select rather than branch so the loop stays vectorizable
+            const float filtered = pass_through_[i] != 0.0f ? input[i] : smoothed;
+
+            speed[i] = smoothed_speed;
+            value[i] = filtered;
+            input[i] = filtered;
+        }
+    }
+
+    // Componentwise filtering shrinks the quaternion slightly; renormalize the output
+    for (size_t i = 0; i < count; i++) {
+        if (pass_through_[i] != 0.0f) {
+            continue;
+        }
+        const float norm_sq = poses.rotation[0][i] * poses.rotation[0][i] + poses.rotation[1][i] * poses.rotation[1][i] +
+                              poses.rotation[2][i] * poses.rotation[2][i] + poses.rotation[3][i] * poses.rotation[3][i];
+        const float inv_norm = norm_sq > 1e-12f ? 1.0f / std::sqrt(norm_sq) : 1.0f;
+        for (int axis = 0; axis < 4; axis++) {
+            poses.rotation[axis][i] *= inv_norm;
+        }
+    }
+}
+
+} // namespace yolovr
@@ -0,0 +1,81 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+#pragma once
+
+#include <cstdint>
+
+#include "tracker_frame_snapshot.h"
+
+namespace yolovr {
+
+// Settings for PoseFilterBank. smoothing_factor mirrors TrackerConfig.smoothing_factor
+// in tracker_data.proto: 0 disables smoothing, 1 is the heaviest.
+struct FilterSettings {
+    float smoothing_factor = 0.5f;
+    float position_beta = 4.0f;             // Cutoff increase per m/s of position speed
+    float rotation_beta = 2.0f;             // Cutoff increase per unit/s of quaternion change
+    float derivative_cutoff_hz = 1.0f;      // Cutoff of the speed estimate
+    float bypass_confidence = 0.98f;        // Poses at least this confident are not smoothed
+
+    // Per-tracker_id override of smoothing_factor, negative to use the global one
+    float tracker_smoothing_factor[kMaxTrackersPerFrame];
+
+    FilterSettings() {
+        for (float& factor : tracker_smoothing_factor) {
+            factor = -1.0f;
+        }
+    }
+};
+
+// Adaptive One Euro filter over the position and rotation of every tracker in
+// a frame. Each of the seven channels (x, y, z, qx, qy, qz, qw) is one pass
+// over the structure-of-arrays frame, so the per-tracker math vectorizes; the
+// minimum cutoff slows jitter at rest while beta raises the cutoff with speed
+// to keep lag low during fast motion.
+//
+// Filter state is kept per position in the frame and is reset whenever the
+// tracker_id at that position changes, so senders that keep a stable tracker
+// order (the Python client does) never take the slow path. Trackers that are
+// not tracking, or at least bypass_confidence confident, pass through
+// unchanged while still updating their state.
+//
+// Not thread-safe; owned by the pose publisher thread.
+class PoseFilterBank {
+public:
+    PoseFilterBank();
+
+    void Configure(const FilterSettings& settings);
+
+    // Smoothing for one tracker_id (0 off .. 1 heaviest), ids >= kMaxTrackersPerFrame are never smoothed
+    void SetTrackerSmoothing(uint32_t tracker_id, float smoothing_factor);
+
+    // Filters frame.poses position and rotation in place
+    void Apply(TrackerFrameSnapshot& frame);
+
+    // Forget all history; the next frame passes through unchanged
+    void Reset();
+
+private:
+    static constexpr int kChannels = 7;
+    static constexpr uint32_t kNoTracker = 0xFFFFFFFFu;
+
+    void ResetSlot(const TrackerPoseArrays& poses, size_t i);
+    float FrameDeltaSeconds(const TrackerFrameSnapshot& frame) const;
+
+    FilterSettings settings_;
+
+    // Per tracker_id, from settings
+    float min_cutoff_by_id_[kMaxTrackersPerFrame];
+
+    // Per position in the frame
+    uint32_t slot_tracker_id_[kMaxTrackersPerFrame];
+    alignas(32) float min_cutoff_[kMaxTrackersPerFrame];    // 0 disables smoothing
+    alignas(32) float pass_through_[kMaxTrackersPerFrame];  // 1 to skip smoothing this frame
+    alignas(32) float value_[kChannels][kMaxTrackersPerFrame];
+    alignas(32) float speed_[kChannels][kMaxTrackersPerFrame];
+
+    bool has_history_;
+    uint64_t last_timestamp_us_;
+    int64_t last_arrival_time_ns_;
+};
+
+} // namespace yolovr
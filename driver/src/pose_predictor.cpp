@@ -0,0 +1,82 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+#include "pose_predictor.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace yolovr {
+
+PredictionTiming ComputePredictionTiming(const PredictionSettings& settings, double data_age_s) {
+    PredictionTiming timing;
+    if (!settings.enabled) {
+        timing.extrapolate_s = 0.0f;
+        timing.pose_time_offset_s = -data_age_s;
+        return timing;
+    }
+
+    double target_s = std::max(0.0, data_age_s + settings.lookahead_s);
+    timing.extrapolate_s = static_cast<float>(std::min(target_s, static_cast<double>(settings.max_prediction_s)));
+    // Positive when the result lies in the future relative to now
+    timing.pose_time_offset_s = timing.extrapolate_s - data_age_s;
+    return timing;
+}
+
+void ExtrapolatePose(const TrackerPoseSnapshot& pose, float dt, float position[3], float rotation[4]) {
+    for (int axis = 0; axis < 3; axis++) {
+        position[axis] = pose.position[axis];
+    }
+    for (int axis = 0; axis < 4; axis++) {
+        rotation[axis] = pose.rotation[axis];
+    }
+
+    if (dt <= 0.0f) {
+        return;
+    }
+
+    if (pose.has_velocity) {
+        for (int axis = 0; axis < 3; axis++) {
+            position[axis] += pose.velocity[axis] * dt;
+        }
+    }
+
+    if (!pose.has_angular_velocity) {
+        return;
+    }
+
+    const float wx = pose.angular_velocity[0];
+    const float wy = pose.angular_velocity[1];
+    const float wz = pose.angular_velocity[2];
+    const float rate = std::sqrt(wx * wx + wy * wy + wz * wz);
+    if (rate < 1e-6f) {
+        return;
+    }
+
+    // Rotation by |w| * dt about w, applied on the left since w is world space
+    const float half_angle = 0.5f * rate * dt;
+    const float s = std::sin(half_angle) / rate;
+    const float dx = wx * s;
+    const float dy = wy * s;
+    const float dz = wz * s;
+    const float dw = std::cos(half_angle);
+
+    const float qx = pose.rotation[0];
+    const float qy = pose.rotation[1];
+    const float qz = pose.rotation[2];
+    const float qw = pose.rotation[3];
+
+    float rx = dw * qx + dx * qw + dy * qz - dz * qy;
+    float ry = dw * qy - dx * qz + dy * qw + dz * qx;
+    float rz = dw * qz + dx * qy - dy * qx + dz * qw;
+    float rw = dw * qw - dx * qx - dy * qy - dz * qz;
+
+    const float norm = std::sqrt(rx * rx + ry * ry + rz * rz + rw * rw);
+    if (norm < 1e-6f) {
+        return; // Sender gave no usable rotation
+    }
+    rotation[0] = rx / norm;
+    rotation[1] = ry / norm;
+    rotation[2] = rz / norm;
+    rotation[3] = rw / norm;
+}
+
+} // namespace yolovr
@@ -0,0 +1,32 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+#pragma once
+
+#include "tracker_frame_snapshot.h"
+
+namespace yolovr {
+
+// Settings for forward prediction of UDP tracker poses. Mirrors
+// TrackerConfig.use_prediction / prediction_time in tracker_data.proto.
+struct PredictionSettings {
+    bool enabled = true;
+    float lookahead_s = 0.0f;       // Extra time to predict beyond "now"
+    float max_prediction_s = 0.1f;  // Never extrapolate further than this
+};
+
+// How far to extrapolate a pose and how to report it to SteamVR.
+struct PredictionTiming {
+    float extrapolate_s;            // Time the pose is moved forward by
+    double pose_time_offset_s;      // DriverPose_t::poseTimeOffset for the result
+};
+
+// Prediction timing for a pose that is data_age_s old. With prediction on,
+// the pose is moved to now + lookahead (clamped to max_prediction_s). With it
+// off, the pose is left alone and its age is reported through poseTimeOffset
+// so SteamVR extrapolates it with the velocities instead.
+PredictionTiming ComputePredictionTiming(const PredictionSettings& settings, double data_age_s);
+
+// Extrapolates a pose by dt seconds using its linear and angular velocity
+// (both world space). Channels without velocity are left unchanged.
+void ExtrapolatePose(const TrackerPoseSnapshot& pose, float dt, float position[3], float rotation[4]);
+
+} // namespace yolovr
@@ -0,0 +1,135 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+#include "pose_publisher.h"
+
+#include "driverlog.h"
+#include "tracker_data_receiver.h"
+#include "tracker_device_driver.h"
+
+namespace yolovr {
+
+namespace {
+
+int64_t SteadyNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+PosePublisher::PosePublisher(TrackerDataReceiver* receiver)
+    : receiver_(receiver)
+    , latency_monitor_(nullptr)
+    , max_interval_(std::chrono::milliseconds(5))
+    , running_(false)
+    , frame_{}
+    , demux_time_ns_(0)
+{
+}
+
+PosePublisher::~PosePublisher() {
+    Stop();
+}
+
+void PosePublisher::AddDevice(MyTrackerDeviceDriver* device) {
+    std::lock_guard<std::mutex> lock(devices_mutex_);
+    devices_.push_back(device);
+    poses_.resize(devices_.size());
+    device_indices_.resize(devices_.size());
+}
+
+bool PosePublisher::Start() {
+    if (running_.load()) {
+        return true;
+    }
+    
+    running_.store(true);
+    publisher_thread_ = std::thread(&PosePublisher::PublisherThreadFunction, this);
+    
+    DriverLog("PosePublisher started, max interval %lld ms", static_cast<long long>(max_interval_.count()));
+    return true;
+}
+
+void PosePublisher::Stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    
+    if (publisher_thread_.joinable()) {
+        publisher_thread_.join();
+    }
+    
+    DriverLog("PosePublisher stopped");
+}
+
+void PosePublisher::WaitForPublishPass() {
+    std::lock_guard<std::mutex> lock(devices_mutex_);
+}
+
+void PosePublisher::PublisherThreadFunction() {
+    uint64_t last_sequence = 0;
+    std::chrono::microseconds spin(0);
+    if (low_latency_.enabled) {
+        TuneCurrentThread("pose publisher", low_latency_.publisher_cpu, low_latency_.realtime_priority);
+        spin = std::chrono::microseconds(low_latency_.publisher_spin_us);
+    }
+    
+    while (running_.load()) {
+        bool has_new_frame = false;
+        if (receiver_) {
+            // Wakes as soon as the receiver publishes, or after max_interval_
+            if (receiver_->WaitForNewFrame(last_sequence, max_interval_, spin)) {
+                size_t source_count = receiver_->GetSourceFrames(fusion_.Sources(), SourceFusion::kMaxSources);
+                has_new_frame = fusion_.Fuse(source_count, SteadyNowNs(), frame_);
+            }
+            if (has_new_frame) {
+                filter_bank_.Apply(frame_);
+                slot_table_.Demux(frame_);
+                demux_time_ns_ = SteadyNowNs();
+            }
+        } else {
+            std::this_thread::sleep_for(max_interval_);
+        }
+        
+        PublishPoses(has_new_frame);
+    }
+}
+
+void PosePublisher::PublishPoses(bool has_new_frame) {
+    std::lock_guard<std::mutex> lock(devices_mutex_);
+    
+    // One HMD fetch for every device that followed the HMD since the last pass
+    hmd_pose_cache_.Update(SteadyNowNs());
+    
+    size_t pose_count = 0;
+    for (MyTrackerDeviceDriver* device : devices_) {
+        if (!device->MyIsActive()) {
+            continue;
+        }
+        poses_[pose_count] = device->GetPose();
+        device_indices_[pose_count] = device->MyGetDeviceIndex();
+        pose_count++;
+    }
+    
+    for (size_t i = 0; i < pose_count; i++) {
+        vr::VRServerDriverHost()->TrackedDevicePoseUpdated(device_indices_[i], poses_[i], sizeof(vr::DriverPose_t));
+    }
+    
+    if (has_new_frame && latency_monitor_) {
+        RecordLatency(SteadyNowNs());
+    }
+}
+
+void PosePublisher::RecordLatency(int64_t submit_time_ns) {
+    // Once per frame for every tracker it carried, from the first submission after it was demultiplexed
+    for (uint32_t i = 0; i < frame_.tracker_count; i++) {
+        if (!frame_.poses.is_tracking[i]) {
+            continue;
+        }
+        const uint32_t tracker_id = frame_.poses.tracker_id[i];
+        latency_monitor_->RecordTracker(tracker_id, LatencyStage::ParsedToDemux, demux_time_ns_ - frame_.parsed_time_ns);
+        latency_monitor_->RecordTracker(tracker_id, LatencyStage::DemuxToSubmit, submit_time_ns - demux_time_ns_);
+        latency_monitor_->RecordTracker(tracker_id, LatencyStage::ArrivalToSubmit, submit_time_ns - frame_.arrival_time_ns);
+    }
+}
+
+} // namespace yolovr
@@ -0,0 +1,109 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "openvr_driver.h"
+#include "hmd_pose_cache.h"
+#include "pose_filter_bank.h"
+#include "latency_monitor.h"
+#include "low_latency.h"
+#include "source_fusion.h"
+#include "tracker_frame_snapshot.h"
+#include "tracker_slot_table.h"
+
+class MyTrackerDeviceDriver;
+
+namespace yolovr {
+
+class TrackerDataReceiver;
+
+// One thread that submits the poses of every tracker device.
+//
+// It wakes when the receiver publishes a new frame (or after max_interval at
+// the latest), merges the newest frame of every source into one, runs it
+// through the smoothing filter, demultiplexes it into the per-tracker slot table,
+// computes all poses in a single pass and then submits them together, so every
+// body part in a pass comes from the same source frame.
+class PosePublisher {
+public:
+    explicit PosePublisher(TrackerDataReceiver* receiver);
+    ~PosePublisher();
+
+    // Also how long a pass's HMD sample serves fallback poses requested between passes
+    void SetMaxInterval(std::chrono::milliseconds max_interval) {
+        max_interval_ = max_interval;
+        hmd_pose_cache_.SetMaxAge(2 * std::chrono::duration_cast<std::chrono::nanoseconds>(max_interval).count());
+    }
+
+    // Sources older than this lose out to fresher ones when merging. Call before Start().
+    void SetSourceMaxAge(std::chrono::milliseconds max_age) { fusion_.SetMaxAge(max_age.count() * 1000000); }
+
+    // Smoothing applied to every new frame before devices see it. Call before Start().
+    void SetFilterSettings(const FilterSettings& settings) { filter_bank_.Configure(settings); }
+
+    // Spin-wait for new frames, CPU pinning and SCHED_FIFO for the publisher
+    // thread (publisher_spin_us, publisher_cpu, realtime_priority). Call before Start().
+    void SetLowLatency(const LowLatencySettings& settings) { low_latency_ = settings; }
+
+    // Record per-tracker publish latency into monitor (may be null). Call before Start().
+    void SetLatencyMonitor(LatencyMonitor* monitor) { latency_monitor_ = monitor; }
+    LatencyMonitor* GetLatencyMonitor() const { return latency_monitor_; }
+
+    TrackerDataReceiver* GetReceiver() const { return receiver_; }
+
+    // Per-tracker poses from the newest frame. Devices read their slot in GetPose().
+    const TrackerSlotTable& GetSlotTable() const { return slot_table_; }
+
+    // Positions relative to the HMD of the trackers that follow it without UDP
+    // data, indexed by tracker id. Call before Start().
+    void SetFallbackOffsets(const float (*offsets)[3], size_t count) { hmd_pose_cache_.SetOffsets(offsets, count); }
+
+    // HMD pose fetched at most once per publish pass, with every fallback offset already applied
+    const HmdPoseCache& GetHmdPoseCache() const { return hmd_pose_cache_; }
+    void RequestHmdPose() { hmd_pose_cache_.Request(); }
+
+    // Devices may be added before or after Start()
+    void AddDevice(MyTrackerDeviceDriver* device);
+
+    bool Start();
+    void Stop();
+
+    // Returns once any publish pass in progress has finished. A device calls
+    // this from Deactivate() after clearing its active flag, so no pose is
+    // submitted for it afterwards.
+    void WaitForPublishPass();
+
+private:
+    void PublisherThreadFunction();
+    void PublishPoses(bool has_new_frame);
+    void RecordLatency(int64_t submit_time_ns);
+
+    TrackerDataReceiver* receiver_;
+    LatencyMonitor* latency_monitor_;
+    std::chrono::milliseconds max_interval_;
+    LowLatencySettings low_latency_;
+
+    std::atomic<bool> running_;
+    std::thread publisher_thread_;
+
+    // Guards devices_ and the publish pass itself
+    std::mutex devices_mutex_;
+    std::vector<MyTrackerDeviceDriver*> devices_;
+
+    // Publisher thread only
+    TrackerFrameSnapshot frame_;
+    SourceFusion fusion_;
+    PoseFilterBank filter_bank_;
+    TrackerSlotTable slot_table_;
+    HmdPoseCache hmd_pose_cache_;
+    int64_t demux_time_ns_;
+    std::vector<vr::DriverPose_t> poses_;
+    std::vector<vr::TrackedDeviceIndex_t> device_indices_;
+};
+
+} // namespace yolovr
@@ -0,0 +1,40 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+#pragma once
+
+#include <cstdarg>
+#include <cstddef>
+#include <cstdio>
+
+namespace yolovr {
+
+// snprintf into a fixed buffer that keeps counting the needed length once the
+// buffer is full, for DebugRequest responses. out is always NUL-terminated.
+class ReportWriter {
+public:
+    ReportWriter(char* out, size_t out_size) : out_(out), out_size_(out_size), length_(0) {
+        if (out_size_ > 0) {
+            out_[0] = '\0';
+        }
+    }
+
+    void Append(const char* format, ...) {
+        va_list args;
+        va_start(args, format);
+        char* dest = length_ < out_size_ ? out_ + length_ : nullptr;
+        const size_t space = length_ < out_size_ ? out_size_ - length_ : 0;
+        const int written = std::vsnprintf(dest, space, format, args);
+        va_end(args);
+        if (written > 0) {
+            length_ += static_cast<size_t>(written);
+        }
+    }
+
+    size_t Length() const { return length_; }
+
+private:
+    char* out_;
+    size_t out_size_;
+    size_t length_;
+};
+
+} // namespace yolovr
@@ -0,0 +1,59 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace yolovr {
+
+// Single-writer / multi-reader sequence lock over a trivially copyable value.
+//
+// The writer never blocks and never waits for readers. Readers never block the
+// writer either: they copy the value out and retry if a write overlapped the copy.
+// Neither side allocates, so this is safe to use from the vrserver main loop.
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock requires a trivially copyable type");
+
+public:
+    SeqLock() : sequence_(0) { std::memset(&value_, 0, sizeof(value_)); }
+
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    // Publish a new value. Must only be called from one thread at a time.
+    void Store(const T& value) {
+        uint64_t seq = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(&value_, &value, sizeof(T));
+        sequence_.store(seq + 2, std::memory_order_release);
+    }
+
+    // Copy the most recently published value. Returns the sequence number the
+    // copy corresponds to (0 if nothing has been published yet).
+    uint64_t Load(T& out) const {
+        for (;;) {
+            uint64_t before = sequence_.load(std::memory_order_acquire);
+            if (before & 1) {
+                continue; // Write in progress
+            }
+            std::memcpy(&out, &value_, sizeof(T));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence_.load(std::memory_order_relaxed) == before) {
+                return before / 2;
+            }
+        }
+    }
+
+    // Number of values published so far.
+    uint64_t Sequence() const { return sequence_.load(std::memory_order_acquire) / 2; }
+
+private:
+    alignas(64) std::atomic<uint64_t> sequence_;
+    alignas(64) T value_;
+};
+
+} // namespace yolovr
@@ -0,0 +1,95 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+#include "shared_memory_receiver.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
+#include "driverlog.h"
+#include "tracker_data_receiver.h"
+
+namespace yolovr {
+
+namespace {
+
+// Upper bound on how long Stop() waits for the read thread to notice
+constexpr int kWaitTimeoutMs = 100;
+
+int64_t SteadyNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+SharedMemoryReceiver::SharedMemoryReceiver(TrackerDataReceiver* receiver)
+    : receiver_(receiver)
+    , running_(false)
+    , frames_read_(0)
+{
+}
+
+SharedMemoryReceiver::~SharedMemoryReceiver() {
+    Stop();
+}
+
+bool SharedMemoryReceiver::Start(const std::string& name) {
+    if (running_.load()) {
+        return true;
+    }
+    if (!ring_.Open(name, SharedMemoryRing::Role::Consumer)) {
+        DriverLog("Failed to open shared memory ring %s: %s", name.c_str(),
+                  errno == EPROTO ? "it has an incompatible layout" : strerror(errno));
+        return false;
+    }
+    running_.store(true);
+    read_thread_ = std::thread(&SharedMemoryReceiver::ReadThreadFunction, this);
+    DriverLog("Reading tracker frames from shared memory ring %s", name.c_str());
+    return true;
+}
+
+void SharedMemoryReceiver::Stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    ring_.Wake();
+    if (read_thread_.joinable()) {
+        read_thread_.join();
+    }
+    DriverLog("Shared memory receiver stopped: %llu frames read, %llu dropped by the sender",
+              static_cast<unsigned long long>(FramesRead()), static_cast<unsigned long long>(FramesDropped()));
+    ring_.Close();
+}
+
+void SharedMemoryReceiver::ReadThreadFunction() {
+    int64_t spin_ns = 0;
+    if (low_latency_.enabled) {
+        TuneCurrentThread("shared memory reader", low_latency_.receiver_cpu, low_latency_.realtime_priority);
+        spin_ns = static_cast<int64_t>(low_latency_.receive_spin_us) * 1000;
+    }
+    
+    // Like the UDP receive threads, keep checking the ring for spin_ns after
+    // each frame before sleeping on the futex
+    int64_t spin_until_ns = 0;
+    while (running_.load(std::memory_order_relaxed)) {
+        size_t size = 0;
+        const uint8_t* data = ring_.Peek(size);
+        if (!data) {
+            if (spin_ns > 0 && SteadyNowNs() < spin_until_ns) {
+                SpinPause();
+            } else {
+                ring_.Wait(kWaitTimeoutMs);
+            }
+            continue;
+        }
+        spin_until_ns = SteadyNowNs() + spin_ns;
+        // The slot stays ours until Release(), so decode it in place
+        if (size > 0) {
+            receiver_->InjectDatagram(data, size);
+            frames_read_.fetch_add(1, std::memory_order_relaxed);
+        }
+        ring_.Release();
+    }
+}
+
+} // namespace yolovr
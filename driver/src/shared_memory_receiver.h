@@ -0,0 +1,54 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include "low_latency.h"
+#include "shared_memory_ring.h"
+
+namespace yolovr {
+
+class TrackerDataReceiver;
+
+// Reads tracker frames from a SharedMemoryRing filled by a sender on the same
+// host and feeds them through TrackerDataReceiver::InjectDatagram, in place of
+// the UDP sockets: no loopback socket, no kernel copy, and each frame is
+// decoded straight out of shared memory. The receiver must not be receiving
+// on its own sockets meanwhile.
+//
+// Frames are stamped with the time they are read, like UDP datagrams are
+// stamped with the receive thread's wakeup.
+class SharedMemoryReceiver {
+public:
+    explicit SharedMemoryReceiver(TrackerDataReceiver* receiver);
+    ~SharedMemoryReceiver();
+
+    // Spin-then-block reading, CPU pinning and SCHED_FIFO for the read
+    // thread, which stands in for the receive thread. Call before Start().
+    void SetLowLatency(const LowLatencySettings& settings) { low_latency_ = settings; }
+
+    // Map the ring (creating it if the sender has not yet) and start reading
+    bool Start(const std::string& name);
+    void Stop();
+
+    uint64_t FramesRead() const { return frames_read_.load(std::memory_order_relaxed); }
+
+    // Frames the sender dropped because the ring was full
+    uint64_t FramesDropped() const { return ring_.FramesDropped(); }
+
+private:
+    void ReadThreadFunction();
+
+    TrackerDataReceiver* receiver_;
+    SharedMemoryRing ring_;
+    LowLatencySettings low_latency_;
+
+    std::atomic<bool> running_;
+    std::atomic<uint64_t> frames_read_;
+    std::thread read_thread_;
+};
+
+} // namespace yolovr
@@ -0,0 +1,274 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+#include "shared_memory_ring.h"
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+namespace yolovr {
+
+namespace {
+
+constexpr uint8_t kMagic[4] = { 'Y', 'V', 'R', 'S' };
+
+enum SegmentState : uint32_t {
+    kStateEmpty = 0,            // Fresh, zero-filled segment
+    kStateInitializing = 1,
+    kStateReady = 2,
+};
+
+// How long to wait for another process to finish initializing the segment
+// before assuming it died halfway and initializing it ourselves
+constexpr int kInitializeTimeoutMs = 100;
+
+} // namespace
+
+// Lives at the start of the shared segment; every field is zero in a new one
+struct SharedMemoryRing::Header {
+    uint8_t magic[4];
+    uint32_t version;
+    uint32_t slot_count;
+    uint32_t slot_size;
+    std::atomic<uint32_t> state;
+
+    // Producer side
+    alignas(64) std::atomic<uint64_t> write_index;
+    std::atomic<uint64_t> frames_dropped;
+
+    // Consumer side
+    alignas(64) std::atomic<uint64_t> read_index;
+    std::atomic<uint32_t> consumer_waiting;
+
+    // Futex word, bumped after every write
+    alignas(64) std::atomic<uint32_t> wake_sequence;
+};
+
+SharedMemoryRing::SharedMemoryRing()
+    : header_(nullptr)
+    , slots_(nullptr)
+    , next_index_(0)
+{
+    static_assert(sizeof(Header) <= kHeaderSize, "ring header outgrew its space");
+    static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+                  "shared memory atomics must be lock-free to work across processes");
+}
+
+SharedMemoryRing::~SharedMemoryRing() {
+    Close();
+}
+
+uint8_t* SharedMemoryRing::Slot(uint64_t index) const {
+    return slots_ + (index % kSlotCount) * kSlotSize;
+}
+
+#ifdef __linux__
+
+namespace {
+
+long Futex(std::atomic<uint32_t>* word, int op, uint32_t value, const timespec* timeout) {
+    // Not FUTEX_PRIVATE_FLAG: the word is shared with another process
+    return syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), op, value, timeout, nullptr, 0);
+}
+
+} // namespace
+
+bool SharedMemoryRing::Open(const std::string& name, Role role) {
+    Close();
+
+    const int fd = shm_open(name.c_str(), O_RDWR | O_CREAT, 0660);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 ||
+        (static_cast<size_t>(info.st_size) < kSegmentSize && ftruncate(fd, static_cast<off_t>(kSegmentSize)) != 0)) {
+        const int error = errno;
+        close(fd);
+        errno = error;
+        return false;
+    }
+    void* mapping = mmap(nullptr, kSegmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    const int error = errno;
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        errno = error;
+        return false;
+    }
+    Header* header = static_cast<Header*>(mapping);
+
+    // Whoever moves the segment out of kStateEmpty initializes it
+    uint32_t state = kStateEmpty;
+    bool initialize = header->state.compare_exchange_strong(state, kStateInitializing);
+    for (int waited_ms = 0; !initialize && state == kStateInitializing; waited_ms++) {
+        if (waited_ms == kInitializeTimeoutMs) {
+            initialize = true;
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        state = header->state.load();
+    }
+    if (initialize) {
+        std::memcpy(header->magic, kMagic, sizeof(kMagic));
+        header->version = kVersion;
+        header->slot_count = kSlotCount;
+        header->slot_size = static_cast<uint32_t>(kSlotSize);
+        header->write_index.store(0);
+        header->frames_dropped.store(0);
+        header->read_index.store(0);
+        header->consumer_waiting.store(0);
+        header->state.store(kStateReady);
+    }
+
+    if (std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0 || header->version != kVersion ||
+        header->slot_count != kSlotCount || header->slot_size != kSlotSize) {
+        munmap(mapping, kSegmentSize);
+        errno = EPROTO;
+        return false;
+    }
+
+    header_ = header;
+    slots_ = static_cast<uint8_t*>(mapping) + kHeaderSize;
+    if (role == Role::Consumer) {
+        // Whatever a previous consumer left unread is stale by now
+        next_index_ = header_->write_index.load(std::memory_order_acquire);
+        header_->read_index.store(next_index_, std::memory_order_release);
+        header_->consumer_waiting.store(0);
+    } else {
+        next_index_ = header_->write_index.load(std::memory_order_relaxed);
+    }
+    return true;
+}
+
+void SharedMemoryRing::Close() {
+    if (header_) {
+        munmap(header_, kSegmentSize);
+        header_ = nullptr;
+        slots_ = nullptr;
+    }
+}
+
+bool SharedMemoryRing::Write(const uint8_t* data, size_t size) {
+    if (!header_ || size > kMaxFrameSize) {
+        return false;
+    }
+    const uint64_t read_index = header_->read_index.load(std::memory_order_acquire);
+    if (next_index_ - read_index >= kSlotCount) {
+        header_->frames_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    uint8_t* slot = Slot(next_index_);
+    const uint32_t length = static_cast<uint32_t>(size);
+    std::memcpy(slot, &length, sizeof(length));
+    std::memcpy(slot + kSlotHeaderSize, data, size);
+    header_->write_index.store(++next_index_, std::memory_order_release);
+
+    // Pairs with Wait(): either the consumer sees the new write index before
+    // sleeping, or we see it waiting and wake it
+    header_->wake_sequence.fetch_add(1, std::memory_order_seq_cst);
+    if (header_->consumer_waiting.load(std::memory_order_seq_cst) != 0) {
+        Futex(&header_->wake_sequence, FUTEX_WAKE, 1, nullptr);
+    }
+    return true;
+}
+
+const uint8_t* SharedMemoryRing::Peek(size_t& size) {
+    if (!header_) {
+        return nullptr;
+    }
+    const uint64_t write_index = header_->write_index.load(std::memory_order_acquire);
+    if (write_index == next_index_) {
+        return nullptr;
+    }
+    if (write_index - next_index_ > kSlotCount) {
+        // Only a segment reinitialized under us gets here; start over at its end
+        next_index_ = write_index;
+        header_->read_index.store(next_index_, std::memory_order_release);
+        return nullptr;
+    }
+
+    const uint8_t* slot = Slot(next_index_);
+    uint32_t length;
+    std::memcpy(&length, slot, sizeof(length));
+    size = length <= kMaxFrameSize ? length : 0;
+    return slot + kSlotHeaderSize;
+}
+
+void SharedMemoryRing::Release() {
+    if (header_) {
+        header_->read_index.store(++next_index_, std::memory_order_release);
+    }
+}
+
+bool SharedMemoryRing::Wait(int timeout_ms) {
+    if (!header_) {
+        return false;
+    }
+    header_->consumer_waiting.store(1, std::memory_order_seq_cst);
+    const uint32_t sequence = header_->wake_sequence.load(std::memory_order_seq_cst);
+    if (header_->write_index.load(std::memory_order_seq_cst) == next_index_) {
+        timespec timeout;
+        timeout.tv_sec = timeout_ms / 1000;
+        timeout.tv_nsec = static_cast<long>(timeout_ms % 1000) * 1000000L;
+        Futex(&header_->wake_sequence, FUTEX_WAIT, sequence, &timeout);
+    }
+    header_->consumer_waiting.store(0, std::memory_order_relaxed);
+    return header_->write_index.load(std::memory_order_acquire) != next_index_;
+}
+
+void SharedMemoryRing::Wake() {
+    if (header_) {
+        header_->wake_sequence.fetch_add(1, std::memory_order_seq_cst);
+        Futex(&header_->wake_sequence, FUTEX_WAKE, 1, nullptr);
+    }
+}
+
+uint64_t SharedMemoryRing::FramesDropped() const {
+    return header_ ? header_->frames_dropped.load(std::memory_order_relaxed) : 0;
+}
+
+#else
+
+bool SharedMemoryRing::Open(const std::string&, Role) {
+    errno = ENOSYS;
+    return false;
+}
+
+void SharedMemoryRing::Close() {}
+
+bool SharedMemoryRing::Write(const uint8_t*, size_t) {
+    return false;
+}
+
+const uint8_t* SharedMemoryRing::Peek(size_t&) {
+    return nullptr;
+}
+
+void SharedMemoryRing::Release() {}
+
+bool SharedMemoryRing::Wait(int timeout_ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(timeout_ms));
+    return false;
+}
+
+void SharedMemoryRing::Wake() {}
+
+uint64_t SharedMemoryRing::FramesDropped() const {
+    return 0;
+}
+
+#endif
+
+} // namespace yolovr
@@ -0,0 +1,85 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace yolovr {
+
+// Single-producer/single-consumer ring of tracker frame datagrams in POSIX
+// shared memory, for senders on the same host as vrserver (Linux only).
+//
+// Each slot holds one datagram in any of the wire formats TrackerFrameDecoder
+// accepts. The consumer decodes straight out of the slot and only then
+// releases it, so frames are never copied on the driver side. The consumer
+// sleeps on a futex in the shared segment; the producer only makes the wake
+// syscall while the consumer is actually asleep.
+//
+// Either side may restart at any time:
+//  - Both sides create the segment if it does not exist and initialize it
+//    exactly once; neither side ever unlinks it.
+//  - A slot is written before the write index that publishes it, so a
+//    producer dying mid-write leaves nothing half-written visible.
+//  - A consumer attaching skips whatever an earlier consumer left unread.
+//  - When the ring is full (no consumer running) the producer drops the new
+//    frame and counts it instead of blocking.
+//
+// Segment layout (kSegmentSize bytes): a kHeaderSize-byte header with the
+// magic "YVRS", version, geometry and the indices, each index on its own cache
+// line, then kSlotCount slots of kSlotSize bytes: a uint32 length followed by
+// the datagram.
+class SharedMemoryRing {
+public:
+    enum class Role { Producer, Consumer };
+
+    static constexpr uint32_t kVersion = 1;
+    static constexpr uint32_t kSlotCount = 64;
+    static constexpr size_t kSlotSize = 4096;
+    static constexpr size_t kSlotHeaderSize = 8;
+    static constexpr size_t kMaxFrameSize = kSlotSize - kSlotHeaderSize;
+    static constexpr size_t kHeaderSize = 256;
+    static constexpr size_t kSegmentSize = kHeaderSize + kSlotCount * kSlotSize;
+
+    SharedMemoryRing();
+    ~SharedMemoryRing();
+
+    SharedMemoryRing(const SharedMemoryRing&) = delete;
+    SharedMemoryRing& operator=(const SharedMemoryRing&) = delete;
+
+    // Map the segment called name (e.g. "/yolovr_frames"), creating it if needed
+    bool Open(const std::string& name, Role role);
+    void Close();
+    bool IsOpen() const { return header_ != nullptr; }
+
+    // Producer: copy one datagram into the next slot and wake the consumer.
+    // Returns false if it is larger than kMaxFrameSize or the ring is full.
+    bool Write(const uint8_t* data, size_t size);
+
+    // Consumer: the oldest unread datagram, or nullptr if there is none. It
+    // stays valid, and its slot unwritten, until Release().
+    const uint8_t* Peek(size_t& size);
+    void Release();
+
+    // Consumer: sleep until a datagram is available, Wake() is called or
+    // timeout_ms passes. Returns true if a datagram is available.
+    bool Wait(int timeout_ms);
+
+    // Wake a consumer blocked in Wait(), from either side
+    void Wake();
+
+    // Frames the producer dropped because the ring was full, over the
+    // lifetime of the segment
+    uint64_t FramesDropped() const;
+
+private:
+    struct Header;
+
+    uint8_t* Slot(uint64_t index) const;
+
+    Header* header_;
+    uint8_t* slots_;
+    uint64_t next_index_;       // Producer: next slot to write; consumer: next slot to read
+};
+
+} // namespace yolovr
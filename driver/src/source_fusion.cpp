@@ -0,0 +1,119 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+#include "source_fusion.h"
+
+#include <cstring>
+
+namespace yolovr {
+
+namespace {
+
+// Below any real score, so a non-tracking pose only wins when nothing tracks
+constexpr float kNotTrackingScore = -1.0f;
+constexpr float kNoPoseScore = -2.0f;
+
+void CopyPose(const TrackerPoseArrays& from, size_t i, TrackerPoseArrays& to, size_t j) {
+    to.tracker_id[j] = from.tracker_id[i];
+    to.is_tracking[j] = from.is_tracking[i];
+    to.has_velocity[j] = from.has_velocity[i];
+    to.has_angular_velocity[j] = from.has_angular_velocity[i];
+    to.confidence[j] = from.confidence[i];
+    to.timestamp_us[j] = from.timestamp_us[i];
+    to.sample_time_ns[j] = from.sample_time_ns[i];
+    for (int axis = 0; axis < 3; axis++) {
+        to.position[axis][j] = from.position[axis][i];
+        to.velocity[axis][j] = from.velocity[axis][i];
+        to.angular_velocity[axis][j] = from.angular_velocity[axis][i];
+    }
+    for (int axis = 0; axis < 4; axis++) {
+        to.rotation[axis][j] = from.rotation[axis][i];
+    }
+}
+
+} // namespace
+
+SourceFusion::SourceFusion()
+    : max_age_ns_(100000000)
+{
+    std::memset(sources_, 0, sizeof(sources_));
+}
+
+bool SourceFusion::Fuse(size_t source_count, int64_t now_ns, TrackerFrameSnapshot& out) const {
+    if (source_count == 0) {
+        return false;
+    }
+    if (source_count > kMaxSources) {
+        source_count = kMaxSources;
+    }
+
+    size_t newest = 0;
+    for (size_t s = 1; s < source_count; s++) {
+        if (sources_[s].arrival_time_ns > sources_[newest].arrival_time_ns) {
+            newest = s;
+        }
+    }
+
+    if (source_count == 1) {
+        std::memcpy(&out, &sources_[0], sizeof(out));
+        return true;
+    }
+
+    // Best (source, index) per tracker_id; ids without a slot are dropped
+    float best_score[kMaxTrackersPerFrame];
+    uint8_t best_source[kMaxTrackersPerFrame];
+    uint8_t best_index[kMaxTrackersPerFrame];
+    for (size_t id = 0; id < kMaxTrackersPerFrame; id++) {
+        best_score[id] = kNoPoseScore;
+    }
+
+    out.is_calibrated = false;
+    out.system_fps = 0.0f;
+    for (size_t s = 0; s < source_count; s++) {
+        const TrackerFrameSnapshot& source = sources_[s];
+        const float age_ns = static_cast<float>(now_ns - source.arrival_time_ns);
+        float freshness = 1.0f - age_ns / static_cast<float>(max_age_ns_);
+        if (freshness < 0.0f) {
+            freshness = 0.0f;
+        } else if (freshness > 1.0f) {
+            freshness = 1.0f;
+        }
+
+        out.is_calibrated = out.is_calibrated || source.is_calibrated;
+        if (source.system_fps > out.system_fps) {
+            out.system_fps = source.system_fps;
+        }
+
+        for (size_t i = 0; i < source.tracker_count; i++) {
+            const uint32_t id = source.poses.tracker_id[i];
+            if (id >= kMaxTrackersPerFrame) {
+                continue;
+            }
+            const float score = source.poses.is_tracking[i] ? source.poses.confidence[i] * freshness : kNotTrackingScore;
+            // Ties go to the newer frame
+            if (score > best_score[id] ||
+                (score == best_score[id] && source.arrival_time_ns > sources_[best_source[id]].arrival_time_ns)) {
+                best_score[id] = score;
+                best_source[id] = static_cast<uint8_t>(s);
+                best_index[id] = static_cast<uint8_t>(i);
+            }
+        }
+    }
+
+    uint32_t count = 0;
+    for (uint32_t id = 0; id < kMaxTrackersPerFrame; id++) {
+        if (best_score[id] == kNoPoseScore) {
+            continue;
+        }
+        CopyPose(sources_[best_source[id]].poses, best_index[id], out.poses, count);
+        count++;
+    }
+
+    out.tracker_count = count;
+    out.frame_id = sources_[newest].frame_id;
+    out.arrival_time_ns = sources_[newest].arrival_time_ns;
+    out.parsed_time_ns = sources_[newest].parsed_time_ns;
+    out.timestamp_us = 0;
+    out.source_id = 0;
+    return true;
+}
+
+} // namespace yolovr
@@ -0,0 +1,44 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "tracker_frame_snapshot.h"
+
+namespace yolovr {
+
+// Merges the newest frames of several tracking sources (e.g. two camera rigs
+// with different source_ids) into one frame.
+//
+// For every tracker_id the pose comes from the source that currently tracks
+// it with the best score: confidence, scaled down linearly with the age of the
+// source's frame until max_age. Poses that are not tracking are only used when
+// no source tracks that tracker. With a single source the frame is passed
+// through unchanged.
+//
+// The merged frame lists trackers in tracker_id order, has source_id 0 and the
+// arrival time and frame_id of the newest source. Its timestamp_us is 0 since
+// sender clocks are not comparable across sources.
+//
+// Owns scratch storage for the source frames; fill Sources() (e.g. with
+// TrackerDataReceiver::GetSourceFrames) and call Fuse. Not thread-safe.
+class SourceFusion {
+public:
+    static constexpr size_t kMaxSources = 8;
+
+    SourceFusion();
+
+    void SetMaxAge(int64_t max_age_ns) { max_age_ns_ = max_age_ns; }
+
+    TrackerFrameSnapshot* Sources() { return sources_; }
+
+    // Merge Sources()[0, source_count) into out. Returns false if there is nothing to merge.
+    bool Fuse(size_t source_count, int64_t now_ns, TrackerFrameSnapshot& out) const;
+
+private:
+    int64_t max_age_ns_;
+    TrackerFrameSnapshot sources_[kMaxSources];
+};
+
+} // namespace yolovr
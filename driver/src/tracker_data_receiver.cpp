@@ -1,15 +1,69 @@
 //============ Copyright (c) YoloVr Project, All rights reserved. ============
 #include "tracker_data_receiver.h"
+#include "async_logger.h"
 #include "driverlog.h"
+#include "report_writer.h"
+#include "tracker_wire_format.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
 
 #ifndef _WIN32
 #include <fcntl.h>
 #include <errno.h>
+#include <poll.h>
+#endif
+#ifdef __linux__
+#include <sys/eventfd.h>
 #endif
 
 namespace yolovr {
 
+namespace {
+
+int64_t SteadyNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int64_t SystemNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// Counters have a single writer (their shard's thread), so a relaxed
+// load/store pair is enough and avoids a locked read-modify-write
+void Increment(std::atomic<uint64_t>& counter, uint64_t amount = 1) {
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+// Latest, largest and summed latency, single writer like Increment()
+void RecordLatency(std::atomic<uint64_t>& last, std::atomic<uint64_t>& max, std::atomic<uint64_t>& total,
+                   uint64_t latency_ns) {
+    last.store(latency_ns, std::memory_order_relaxed);
+    Increment(total, latency_ns);
+    if (latency_ns > max.load(std::memory_order_relaxed)) {
+        max.store(latency_ns, std::memory_order_relaxed);
+    }
+}
+
+// A sample time further back than this is a sender clock or timestamp gone
+// wrong, not a real delay
+constexpr int64_t kMaxSampleAgeNs = 1000000000;
+
+// No datagram waits in the socket queue this long; a kernel timestamp further
+// back means the system clock stepped since
+constexpr int64_t kMaxQueueDelayNs = 1000000000;
+
+#ifdef __linux__
+// Room for the ancillary data requested on the sockets: the drop count and
+// the receive timestamp
+constexpr size_t kControlBufferSize = CMSG_SPACE(sizeof(uint32_t)) + CMSG_SPACE(sizeof(timespec));
+#endif
+
+} // namespace
+
 #ifdef _WIN32
 std::atomic<int> TrackerDataReceiver::winsock_ref_count_(0);
 
@@ -35,17 +89,27 @@ void TrackerDataReceiver::CleanupWinsock() {
 TrackerDataReceiver::TrackerDataReceiver(const std::string& bind_address, uint16_t port)
     : bind_address_(bind_address)
     , port_(port)
-    , socket_(INVALID_SOCKET_VALUE)
     , running_(false)
-    , last_update_time_(std::chrono::steady_clock::now())
+    , stop_requested_time_ns_(0)
+    , running_shards_(0)
+    , shard_count_(0)
+    , configured_shard_count_(1)
+    , publish_sequence_(0)
+    , latest_location_(0)
+    , last_update_time_ns_(SteadyNowNs())
+    , source_max_age_ns_(100000000)
+    , clock_sync_interval_ns_(250000000)
+    , latency_monitor_(nullptr)
+    , capture_writer_(nullptr)
+    , frame_waiters_(0)
+    , stop_latency_ns_(0)
+    , receive_buffer_bytes_granted_(0)
     , timeout_ms_(std::chrono::milliseconds(50))
     , max_frame_size_(64 * 1024) // 64KB max frame size
+    , receive_buffer_bytes_(0)
+    , batch_receive_(true)
+    , batch_size_(32)
 {
-    // Initialize statistics
-    std::lock_guard<std::mutex> lock(stats_mutex_);
-    stats_ = {};
-    stats_.last_frame_time = std::chrono::steady_clock::now();
-    
 #ifdef _WIN32
     InitializeWinsock();
 #endif
@@ -63,21 +127,85 @@ TrackerDataReceiver::~TrackerDataReceiver() {
     DriverLog("TrackerDataReceiver destroyed");
 }
 
+void TrackerDataReceiver::SetShardCount(size_t shard_count) {
+    if (shard_count < 1) {
+        shard_count = 1;
+    }
+    if (shard_count > kMaxShards) {
+        shard_count = kMaxShards;
+    }
+#ifndef __linux__
+    if (shard_count > 1) {
+        // SO_REUSEPORT only load-balances UDP on Linux
+        DriverLog("Receive sharding is only supported on Linux, using one receiver thread");
+        shard_count = 1;
+    }
+#endif
+    configured_shard_count_ = shard_count;
+}
+
 bool TrackerDataReceiver::Start() {
     if (running_.load()) {
         DriverLog("TrackerDataReceiver already running");
         return true;
     }
     
-    if (!InitializeSocket()) {
-        DriverLog("Failed to initialize UDP socket");
+    const size_t shard_count = configured_shard_count_;
+    for (size_t i = 0; i < shard_count; i++) {
+        if (!shards_[i]) {
+            shards_[i] = std::make_unique<ReceiverShard>();
+            shards_[i]->index = i;
+        }
+        if (!InitializeSocket(*shards_[i], shard_count > 1)) {
+            DriverLog("Failed to initialize UDP socket");
+            for (size_t j = 0; j < i; j++) {
+                CleanupSocket(*shards_[j]);
+            }
+            return false;
+        }
+    }
+    
+    if (!InitializeWakeup()) {
+        DriverLog("Failed to create receiver wakeup descriptor");
+        for (size_t i = 0; i < shard_count; i++) {
+            CleanupSocket(*shards_[i]);
+        }
         return false;
     }
     
+    // Receive buffers are allocated once here and reused for every datagram
+    for (size_t i = 0; i < shard_count; i++) {
+        ReceiverShard& shard = *shards_[i];
+#ifdef __linux__
+        size_t buffer_count = batch_receive_ ? batch_size_ : 1;
+        shard.batch_headers.assign(buffer_count, mmsghdr{});
+        shard.batch_iovecs.assign(buffer_count, iovec{});
+        shard.batch_addresses.assign(buffer_count, sockaddr_in{});
+        shard.batch_is_latest.assign(buffer_count, 0);
+        shard.batch_control.assign(buffer_count * kControlBufferSize, 0);
+        shard.batch_kernel_time_ns.assign(buffer_count, 0);
+        shard.batch_has_frame_id.assign(buffer_count, 0);
+        shard.batch_source_ids.assign(buffer_count, 0);
+        shard.batch_frame_ids.assign(buffer_count, 0);
+#else
+        size_t buffer_count = 1;
+#endif
+        shard.buffer_pool.Allocate(buffer_count, max_frame_size_);
+    }
+    
+    // Readers may see more shards than before, never fewer
+    if (shard_count > shard_count_.load()) {
+        shard_count_.store(shard_count, std::memory_order_release);
+    }
+    
     running_.store(true);
-    receiver_thread_ = std::thread(&TrackerDataReceiver::ReceiverThreadFunction, this);
+    running_shards_.store(static_cast<int>(shard_count));
+    for (size_t i = 0; i < shard_count; i++) {
+        shards_[i]->thread = std::thread(&TrackerDataReceiver::ReceiverThreadFunction, this, std::ref(*shards_[i]));
+    }
     
-    DriverLog("TrackerDataReceiver started successfully");
+    DriverLog("TrackerDataReceiver started successfully with %zu receive thread(s)%s", shard_count,
+              low_latency_.enabled ? " in low latency mode" : "");
     return true;
 }
 
@@ -86,43 +214,269 @@ void TrackerDataReceiver::Stop() {
         return;
     }
     
+    stop_requested_time_ns_.store(SteadyNowNs());
     running_.store(false);
     
-    // Close socket to unblock receiver thread
-    CleanupSocket();
+    // Wake every receiver thread out of poll() so they can exit
+    SignalWakeup();
     
-    if (receiver_thread_.joinable()) {
-        receiver_thread_.join();
+    StopShards();
+    CleanupWakeup();
+    
+    const Stats stats = GetStats();
+    DriverLog("TrackerDataReceiver stopped after %.3f ms: %llu frames, %llu dropped, %llu lost, %llu kernel drops",
+              stats.stop_latency_ns / 1e6, static_cast<unsigned long long>(stats.frames_received),
+              static_cast<unsigned long long>(stats.frames_dropped), static_cast<unsigned long long>(stats.frames_lost),
+              static_cast<unsigned long long>(stats.kernel_drops));
+}
+
+void TrackerDataReceiver::StopShards() {
+    for (size_t i = 0; i < kMaxShards; i++) {
+        if (!shards_[i]) {
+            continue;
+        }
+        if (shards_[i]->thread.joinable()) {
+            shards_[i]->thread.join();
+        }
+        CleanupSocket(*shards_[i]);
+    }
+}
+
+bool TrackerDataReceiver::GetLatestFrame(TrackerFrameSnapshot& frame) const {
+    if (!HasRecentData()) {
+        return false;
     }
     
-    DriverLog("TrackerDataReceiver stopped");
+    const uint32_t location = latest_location_.load(std::memory_order_acquire);
+    const ReceiverShard* shard = shards_[location / kMaxSourcesPerShard].get();
+    if (!shard) {
+        return false;
+    }
+    return shard->source_frames[location % kMaxSourcesPerShard].Load(frame) != 0;
 }
 
-bool TrackerDataReceiver::GetLatestFrame(yolovr::TrackerFrame& frame) {
-    std::lock_guard<std::mutex> lock(frame_mutex_);
+size_t TrackerDataReceiver::GetSourceFrames(TrackerFrameSnapshot* frames, size_t max_frames) const {
+    const int64_t oldest_ns = SteadyNowNs() - source_max_age_ns_;
+    const size_t shard_count = shard_count_.load(std::memory_order_acquire);
     
-    if (!HasRecentData()) {
+    size_t count = 0;
+    for (size_t i = 0; i < shard_count && count < max_frames; i++) {
+        const ReceiverShard& shard = *shards_[i];
+        for (size_t slot = 0; slot < kMaxSourcesPerShard && count < max_frames; slot++) {
+            // Check the age first so stale sources cost no copy
+            if (shard.source_update_ns[slot].load(std::memory_order_acquire) < oldest_ns) {
+                continue;
+            }
+            if (shard.source_frames[slot].Load(frames[count]) != 0 && frames[count].arrival_time_ns >= oldest_ns) {
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+bool TrackerDataReceiver::InjectDatagram(const uint8_t* data, size_t size) {
+    if (running_.load()) {
+        YOLOVR_LOG_EVERY_MS(LogLevel::Warning, 1000, "Cannot inject datagrams while the receiver is running");
         return false;
     }
     
-    frame = latest_frame_;
-    return true;
+    // Shard 0 stands in for the socket; create it like Start() would
+    if (!shards_[0]) {
+        shards_[0] = std::make_unique<ReceiverShard>();
+    }
+    if (shard_count_.load() == 0) {
+        shard_count_.store(1, std::memory_order_release);
+    }
+    
+    ReceiverShard& shard = *shards_[0];
+    shard.wakeup_time_ns = SteadyNowNs();
+    shard.steady_minus_system_ns = shard.wakeup_time_ns - SystemNowNs();
+    SetArrivalTime(shard, 0);
+    Increment(shard.counters.bytes_received, size);
+    return ProcessDatagram(shard, data, size, nullptr);
 }
 
-bool TrackerDataReceiver::HasRecentData(std::chrono::milliseconds max_age) {
-    auto now = std::chrono::steady_clock::now();
-    auto age = std::chrono::duration_cast<std::chrono::milliseconds>(now - last_update_time_);
-    return age <= max_age;
+bool TrackerDataReceiver::WaitForNewFrame(uint64_t& last_sequence, std::chrono::milliseconds timeout,
+                                          std::chrono::microseconds spin) {
+    if (spin.count() > 0) {
+        const int64_t spin_ns = std::min<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(spin).count(),
+            std::chrono::duration_cast<std::chrono::nanoseconds>(timeout).count());
+        const int64_t start_ns = SteadyNowNs();
+        while (SteadyNowNs() - start_ns < spin_ns) {
+            const uint64_t sequence = publish_sequence_.load(std::memory_order_acquire);
+            if (sequence != last_sequence) {
+                last_sequence = sequence;
+                return true;
+            }
+            SpinPause();
+        }
+        timeout -= std::chrono::duration_cast<std::chrono::milliseconds>(spin);
+        if (timeout.count() <= 0) {
+            return false;
+        }
+    }
+    
+    std::unique_lock<std::mutex> lock(frame_wait_mutex_);
+    frame_waiters_.fetch_add(1);
+    bool has_new_frame = frame_wait_cv_.wait_for(lock, timeout, [&] {
+        return publish_sequence_.load(std::memory_order_acquire) != last_sequence;
+    });
+    frame_waiters_.fetch_sub(1);
+    
+    if (has_new_frame) {
+        last_sequence = publish_sequence_.load(std::memory_order_acquire);
+    }
+    return has_new_frame;
+}
+
+bool TrackerDataReceiver::HasRecentData(std::chrono::milliseconds max_age) const {
+    int64_t age_ns = SteadyNowNs() - last_update_time_ns_.load(std::memory_order_acquire);
+    return age_ns <= std::chrono::duration_cast<std::chrono::nanoseconds>(max_age).count();
 }
 
 TrackerDataReceiver::Stats TrackerDataReceiver::GetStats() const {
-    std::lock_guard<std::mutex> lock(stats_mutex_);
-    return stats_;
+    Stats stats = {};
+    int64_t last_frame_time_ns = 0;
+    int64_t newest_latency_frame_ns = 0;
+    const int64_t oldest_ns = SteadyNowNs() - source_max_age_ns_;
+    const size_t shard_count = shard_count_.load(std::memory_order_acquire);
+    for (size_t i = 0; i < shard_count; i++) {
+        const ReceiverShard& shard = *shards_[i];
+        const ShardCounters& counters = shard.counters;
+        stats.frames_received += counters.frames_received.load(std::memory_order_relaxed);
+        stats.parse_errors += counters.parse_errors.load(std::memory_order_relaxed);
+        stats.network_errors += counters.network_errors.load(std::memory_order_relaxed);
+        stats.bytes_received += counters.bytes_received.load(std::memory_order_relaxed);
+        stats.kernel_drops += counters.kernel_drops.load(std::memory_order_relaxed);
+        stats.receive_batches += counters.receive_batches.load(std::memory_order_relaxed);
+        stats.datagrams_received += counters.datagrams_received.load(std::memory_order_relaxed);
+        stats.stale_datagrams_skipped += counters.stale_datagrams_skipped.load(std::memory_order_relaxed);
+        stats.wakeups += counters.wakeups.load(std::memory_order_relaxed);
+        stats.arrival_to_wakeup_ns_total += counters.arrival_to_wakeup_ns_total.load(std::memory_order_relaxed);
+        stats.arrival_to_wakeup_ns_max = std::max(stats.arrival_to_wakeup_ns_max,
+                                                  counters.arrival_to_wakeup_ns_max.load(std::memory_order_relaxed));
+        stats.spin_wakeups += counters.spin_wakeups.load(std::memory_order_relaxed);
+        stats.wakeup_to_parse_ns_total += counters.wakeup_to_parse_ns_total.load(std::memory_order_relaxed);
+        stats.wakeup_to_parse_ns_max = std::max(stats.wakeup_to_parse_ns_max,
+                                                counters.wakeup_to_parse_ns_max.load(std::memory_order_relaxed));
+        stats.receive_latency_ns_total += counters.receive_latency_ns_total.load(std::memory_order_relaxed);
+        stats.receive_latency_ns_max = std::max(stats.receive_latency_ns_max,
+                                                counters.receive_latency_ns_max.load(std::memory_order_relaxed));
+        stats.frames_lost += counters.frames_lost.load(std::memory_order_relaxed);
+        stats.frames_reordered += counters.frames_reordered.load(std::memory_order_relaxed);
+        stats.frames_duplicate += counters.frames_duplicate.load(std::memory_order_relaxed);
+        stats.source_restarts += counters.source_restarts.load(std::memory_order_relaxed);
+        stats.frames_missing_keyframe += counters.frames_missing_keyframe.load(std::memory_order_relaxed);
+        stats.clock_pings_sent += counters.clock_pings_sent.load(std::memory_order_relaxed);
+        stats.clock_pongs_received += counters.clock_pongs_received.load(std::memory_order_relaxed);
+        
+        // The last latency comes from whichever shard published most recently
+        const int64_t shard_last_frame_ns = counters.last_frame_time_ns.load(std::memory_order_relaxed);
+        if (shard_last_frame_ns > newest_latency_frame_ns) {
+            newest_latency_frame_ns = shard_last_frame_ns;
+            stats.receive_latency_ns_last = counters.receive_latency_ns_last.load(std::memory_order_relaxed);
+            stats.wakeup_to_parse_ns_last = counters.wakeup_to_parse_ns_last.load(std::memory_order_relaxed);
+            stats.arrival_to_wakeup_ns_last = counters.arrival_to_wakeup_ns_last.load(std::memory_order_relaxed);
+        }
+        last_frame_time_ns = std::max(last_frame_time_ns, shard_last_frame_ns);
+        
+        for (size_t slot = 0; slot < kMaxSourcesPerShard; slot++) {
+            if (shard.source_update_ns[slot].load(std::memory_order_relaxed) >= oldest_ns) {
+                stats.interarrival_jitter_ns = std::max(stats.interarrival_jitter_ns, static_cast<uint64_t>(
+                    shard.source_counters[slot].jitter_ns.load(std::memory_order_relaxed)));
+            }
+        }
+    }
+    stats.frames_dropped = stats.parse_errors + stats.network_errors;
+    stats.stop_latency_ns = stop_latency_ns_.load(std::memory_order_relaxed);
+    stats.receive_buffer_bytes = receive_buffer_bytes_granted_.load(std::memory_order_relaxed);
+    stats.last_frame_time = std::chrono::steady_clock::time_point(std::chrono::nanoseconds(last_frame_time_ns));
+    return stats;
+}
+
+size_t TrackerDataReceiver::GetSourceStats(SourceStats* sources, size_t max_sources) const {
+    const int64_t now_ns = SteadyNowNs();
+    // Report offsets against the system clock, which senders on the same host share
+    const int64_t system_minus_steady_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count() - now_ns;
+    const size_t shard_count = shard_count_.load(std::memory_order_acquire);
+    
+    size_t count = 0;
+    for (size_t i = 0; i < shard_count && count < max_sources; i++) {
+        const ReceiverShard& shard = *shards_[i];
+        for (size_t slot = 0; slot < kMaxSourcesPerShard && count < max_sources; slot++) {
+            const int64_t updated_ns = shard.source_update_ns[slot].load(std::memory_order_acquire);
+            if (updated_ns == 0) {
+                continue;
+            }
+            const SourceCounters& counters = shard.source_counters[slot];
+            const int64_t interval_ns = counters.interval_ns.load(std::memory_order_relaxed);
+            const int64_t age_ns = now_ns - updated_ns;
+            
+            SourceStats& source = sources[count++];
+            source.source_id = counters.source_id.load(std::memory_order_relaxed);
+            source.frames_received = counters.frames_received.load(std::memory_order_relaxed);
+            source.bytes_received = counters.bytes_received.load(std::memory_order_relaxed);
+            source.frame_rate_hz = (interval_ns > 0 && age_ns <= source_max_age_ns_) ? 1e9 / interval_ns : 0.0;
+            source.jitter_ms = counters.jitter_ns.load(std::memory_order_relaxed) / 1e6;
+            source.age_ms = age_ns / 1e6;
+            source.clock_synchronized = counters.clock_synchronized.load(std::memory_order_relaxed);
+            source.clock_offset_ms = source.clock_synchronized ?
+                (counters.clock_offset_ns.load(std::memory_order_relaxed) - system_minus_steady_ns) / 1e6 : 0.0;
+            source.clock_rtt_ms = counters.clock_rtt_ns.load(std::memory_order_relaxed) / 1e6;
+            source.clock_drift_ppm = counters.clock_drift_ppb.load(std::memory_order_relaxed) / 1e3;
+            source.sample_age_ms = counters.sample_age_ns.load(std::memory_order_relaxed) / 1e6;
+        }
+    }
+    return count;
 }
 
-bool TrackerDataReceiver::InitializeSocket() {
-    socket_ = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
-    if (socket_ == INVALID_SOCKET_VALUE) {
+size_t TrackerDataReceiver::FormatStatsReport(char* out, size_t out_size) const {
+    const Stats stats = GetStats();
+    ReportWriter writer(out, out_size);
+    writer.Append("{\"frames_received\":%llu,\"frames_dropped\":%llu,\"parse_errors\":%llu,\"network_errors\":%llu,"
+                  "\"bytes_received\":%llu,\"kernel_drops\":%llu,\"stale_datagrams_skipped\":%llu,"
+                  "\"frames_lost\":%llu,\"frames_reordered\":%llu,\"frames_duplicate\":%llu,\"source_restarts\":%llu,"
+                  "\"frames_missing_keyframe\":%llu,\"jitter_ms\":%.3f,\"receive_buffer_bytes\":%llu,"
+                  "\"clock_pings_sent\":%llu,\"clock_pongs_received\":%llu,\"low_latency\":%s,\"wakeups\":%llu,"
+                  "\"spin_wakeups\":%llu,\"arrival_to_wakeup_us_mean\":%.2f,\"arrival_to_wakeup_us_max\":%.2f,"
+                  "\"wakeup_to_parse_us_mean\":%.2f,\"wakeup_to_parse_us_max\":%.2f,\"sources\":[",
+                  static_cast<unsigned long long>(stats.frames_received), static_cast<unsigned long long>(stats.frames_dropped),
+                  static_cast<unsigned long long>(stats.parse_errors), static_cast<unsigned long long>(stats.network_errors),
+                  static_cast<unsigned long long>(stats.bytes_received), static_cast<unsigned long long>(stats.kernel_drops),
+                  static_cast<unsigned long long>(stats.stale_datagrams_skipped),
+                  static_cast<unsigned long long>(stats.frames_lost), static_cast<unsigned long long>(stats.frames_reordered),
+                  static_cast<unsigned long long>(stats.frames_duplicate), static_cast<unsigned long long>(stats.source_restarts),
+                  static_cast<unsigned long long>(stats.frames_missing_keyframe), stats.interarrival_jitter_ns / 1e6, static_cast<unsigned long long>(stats.receive_buffer_bytes),
+                  static_cast<unsigned long long>(stats.clock_pings_sent), static_cast<unsigned long long>(stats.clock_pongs_received),
+                  low_latency_.enabled ? "true" : "false", static_cast<unsigned long long>(stats.wakeups),
+                  static_cast<unsigned long long>(stats.spin_wakeups),
+                  stats.frames_received > 0 ? stats.arrival_to_wakeup_ns_total / 1e3 / stats.frames_received : 0.0,
+                  stats.arrival_to_wakeup_ns_max / 1e3,
+                  stats.frames_received > 0 ? stats.wakeup_to_parse_ns_total / 1e3 / stats.frames_received : 0.0,
+                  stats.wakeup_to_parse_ns_max / 1e3);
+    
+    SourceStats sources[kMaxShards * kMaxSourcesPerShard];
+    const size_t source_count = GetSourceStats(sources, kMaxShards * kMaxSourcesPerShard);
+    for (size_t i = 0; i < source_count; i++) {
+        writer.Append("%s{\"source_id\":%u,\"frames_received\":%llu,\"bytes_received\":%llu,"
+                      "\"rate_hz\":%.1f,\"jitter_ms\":%.3f,\"age_ms\":%.1f,\"clock_synchronized\":%s,"
+                      "\"clock_offset_ms\":%.3f,\"clock_rtt_ms\":%.3f,\"clock_drift_ppm\":%.2f,\"sample_age_ms\":%.3f}",
+                      i > 0 ? "," : "", sources[i].source_id,
+                      static_cast<unsigned long long>(sources[i].frames_received),
+                      static_cast<unsigned long long>(sources[i].bytes_received),
+                      sources[i].frame_rate_hz, sources[i].jitter_ms, sources[i].age_ms,
+                      sources[i].clock_synchronized ? "true" : "false", sources[i].clock_offset_ms,
+                      sources[i].clock_rtt_ms, sources[i].clock_drift_ppm, sources[i].sample_age_ms);
+    }
+    writer.Append("]}");
+    return writer.Length();
+}
+
+bool TrackerDataReceiver::InitializeSocket(ReceiverShard& shard, bool reuse_port) {
+    shard.socket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (shard.socket == INVALID_SOCKET_VALUE) {
         DriverLog("Failed to create UDP socket");
         return false;
     }
@@ -130,16 +484,16 @@ bool TrackerDataReceiver::InitializeSocket() {
     // Set socket to non-blocking mode
 #ifdef _WIN32
     u_long mode = 1;
-    if (ioctlsocket(socket_, FIONBIO, &mode) != 0) {
+    if (ioctlsocket(shard.socket, FIONBIO, &mode) != 0) {
         DriverLog("Failed to set socket to non-blocking mode");
-        CleanupSocket();
+        CleanupSocket(shard);
         return false;
     }
 #else
-    int flags = fcntl(socket_, F_GETFL, 0);
-    if (flags == -1 || fcntl(socket_, F_SETFL, flags | O_NONBLOCK) == -1) {
+    int flags = fcntl(shard.socket, F_GETFL, 0);
+    if (flags == -1 || fcntl(shard.socket, F_SETFL, flags | O_NONBLOCK) == -1) {
         DriverLog("Failed to set socket to non-blocking mode");
-        CleanupSocket();
+        CleanupSocket(shard);
         return false;
     }
 #endif
@@ -147,18 +501,75 @@ bool TrackerDataReceiver::InitializeSocket() {
     // Set receive timeout
 #ifdef _WIN32
     DWORD timeout = static_cast<DWORD>(timeout_ms_.count());
-    if (setsockopt(socket_, SOL_SOCKET, SO_RCVTIMEO, (char*)&timeout, sizeof(timeout)) == SOCKET_ERROR_VALUE) {
+    if (setsockopt(shard.socket, SOL_SOCKET, SO_RCVTIMEO, (char*)&timeout, sizeof(timeout)) == SOCKET_ERROR_VALUE) {
         DriverLog("Failed to set socket receive timeout");
     }
 #else
     struct timeval timeout;
     timeout.tv_sec = timeout_ms_.count() / 1000;
     timeout.tv_usec = (timeout_ms_.count() % 1000) * 1000;
-    if (setsockopt(socket_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) == SOCKET_ERROR_VALUE) {
+    if (setsockopt(shard.socket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) == SOCKET_ERROR_VALUE) {
         DriverLog("Failed to set socket receive timeout");
     }
 #endif
     
+#ifdef __linux__
+    // Every shard binds the same port; the kernel hashes senders across them
+    int reuse = 1;
+    if (reuse_port && setsockopt(shard.socket, SOL_SOCKET, SO_REUSEPORT, &reuse, sizeof(reuse)) == SOCKET_ERROR_VALUE) {
+        DriverLog("Failed to enable SO_REUSEPORT: %s", strerror(errno));
+        CleanupSocket(shard);
+        return false;
+    }
+#else
+    (void)reuse_port;
+#endif
+    
+    if (receive_buffer_bytes_ > 0) {
+        int requested = static_cast<int>(receive_buffer_bytes_);
+        if (setsockopt(shard.socket, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<const char*>(&requested), sizeof(requested)) == SOCKET_ERROR_VALUE) {
+            DriverLog("Failed to set socket receive buffer to %zu bytes", receive_buffer_bytes_);
+        }
+    }
+    int granted = 0;
+    socklen_t granted_len = sizeof(granted);
+    if (getsockopt(shard.socket, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<char*>(&granted), &granted_len) == 0) {
+        receive_buffer_bytes_granted_.store(static_cast<uint64_t>(granted), std::memory_order_relaxed);
+        if (shard.index == 0 && receive_buffer_bytes_ > static_cast<size_t>(granted)) {
+            // Linux reports twice the usable size, so this only fires when the kernel capped the request
+            DriverLog("Socket receive buffer is %d bytes, less than the %zu requested (see net.core.rmem_max)",
+                      granted, receive_buffer_bytes_);
+        }
+    }
+    
+#ifdef __linux__
+    // Have the kernel attach its running count of datagrams dropped on a full
+    // socket queue, so loss before recvmmsg shows up in the stats
+    int enable_drops = 1;
+    if (setsockopt(shard.socket, SOL_SOCKET, SO_RXQ_OVFL, &enable_drops, sizeof(enable_drops)) == SOCKET_ERROR_VALUE) {
+        DriverLog("Failed to enable SO_RXQ_OVFL, kernel drops will not be counted: %s", strerror(errno));
+    }
+    shard.kernel_drops_reported = 0;
+    
+    // Have the kernel attach each datagram's receive time, so frames are aged
+    // from their arrival rather than from when this thread got to them
+    int enable_timestamps = 1;
+    if (setsockopt(shard.socket, SOL_SOCKET, SO_TIMESTAMPNS, &enable_timestamps, sizeof(enable_timestamps)) == SOCKET_ERROR_VALUE) {
+        DriverLog("Failed to enable SO_TIMESTAMPNS, frames are stamped when the receiver wakes: %s", strerror(errno));
+    }
+    
+    // Busy-poll the device queue for up to busy_poll_us on socket reads
+    // instead of waiting for its interrupt. poll() only busy-polls when the
+    // net.core.busy_poll sysctl is set as well.
+    if (low_latency_.enabled && low_latency_.busy_poll_us > 0) {
+        int busy_poll_us = low_latency_.busy_poll_us;
+        if (setsockopt(shard.socket, SOL_SOCKET, SO_BUSY_POLL, &busy_poll_us, sizeof(busy_poll_us)) == SOCKET_ERROR_VALUE) {
+            DriverLog("Failed to set SO_BUSY_POLL to %d us: %s (above net.core.busy_read needs CAP_NET_ADMIN)",
+                      busy_poll_us, strerror(errno));
+        }
+    }
+#endif
+    
     // Bind socket
     struct sockaddr_in bind_addr;
     std::memset(&bind_addr, 0, sizeof(bind_addr));
@@ -170,14 +581,14 @@ bool TrackerDataReceiver::InitializeSocket() {
     } else {
         if (inet_pton(AF_INET, bind_address_.c_str(), &bind_addr.sin_addr) != 1) {
             DriverLog("Invalid bind address: %s", bind_address_.c_str());
-            CleanupSocket();
+            CleanupSocket(shard);
             return false;
         }
     }
     
-    if (bind(socket_, reinterpret_cast<struct sockaddr*>(&bind_addr), sizeof(bind_addr)) == SOCKET_ERROR_VALUE) {
+    if (bind(shard.socket, reinterpret_cast<struct sockaddr*>(&bind_addr), sizeof(bind_addr)) == SOCKET_ERROR_VALUE) {
         DriverLog("Failed to bind UDP socket to %s:%d", bind_address_.c_str(), port_);
-        CleanupSocket();
+        CleanupSocket(shard);
         return false;
     }
     
@@ -185,54 +596,188 @@ bool TrackerDataReceiver::InitializeSocket() {
     return true;
 }
 
-void TrackerDataReceiver::CleanupSocket() {
-    if (socket_ != INVALID_SOCKET_VALUE) {
-        closesocket(socket_);
-        socket_ = INVALID_SOCKET_VALUE;
+void TrackerDataReceiver::CleanupSocket(ReceiverShard& shard) {
+    if (shard.socket != INVALID_SOCKET_VALUE) {
+        closesocket(shard.socket);
+        shard.socket = INVALID_SOCKET_VALUE;
+    }
+}
+
+bool TrackerDataReceiver::InitializeWakeup() {
+#if defined(__linux__)
+    int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (fd == -1) {
+        return false;
+    }
+    wakeup_fds_[0] = fd;
+    wakeup_fds_[1] = fd;
+#elif !defined(_WIN32)
+    if (pipe(wakeup_fds_) == -1) {
+        return false;
+    }
+    fcntl(wakeup_fds_[0], F_SETFL, O_NONBLOCK);
+    fcntl(wakeup_fds_[1], F_SETFL, O_NONBLOCK);
+#endif
+    return true;
+}
+
+void TrackerDataReceiver::CleanupWakeup() {
+#ifndef _WIN32
+    if (wakeup_fds_[0] != -1) {
+        close(wakeup_fds_[0]);
+    }
+    if (wakeup_fds_[1] != -1 && wakeup_fds_[1] != wakeup_fds_[0]) {
+        close(wakeup_fds_[1]);
+    }
+    wakeup_fds_[0] = -1;
+    wakeup_fds_[1] = -1;
+#endif
+}
+
+void TrackerDataReceiver::SignalWakeup() {
+#ifndef _WIN32
+    // 8 bytes satisfies eventfd and is a harmless write to a pipe
+    uint64_t one = 1;
+    if (write(wakeup_fds_[1], &one, sizeof(one)) == -1 && errno != EAGAIN) {
+        DriverLog("Failed to signal receiver wakeup: %s", strerror(errno));
+    }
+#endif
+}
+
+bool TrackerDataReceiver::WaitForReadable(ReceiverShard& shard, bool block) {
+#ifdef _WIN32
+    // No wakeup descriptor on Windows: bound the wait so Stop() is noticed
+    fd_set read_set;
+    FD_ZERO(&read_set);
+    FD_SET(shard.socket, &read_set);
+    struct timeval timeout;
+    timeout.tv_sec = block ? static_cast<long>(timeout_ms_.count() / 1000) : 0;
+    timeout.tv_usec = block ? static_cast<long>((timeout_ms_.count() % 1000) * 1000) : 0;
+    int result = select(0, &read_set, nullptr, nullptr, &timeout);
+    if (result == SOCKET_ERROR_VALUE) {
+        UpdateStats(shard, false);
+        YOLOVR_LOG_EVERY_MS(LogLevel::Warning, 1000, "UDP select error: %d", WSAGetLastError());
+        return false;
     }
+    return result > 0;
+#else
+    struct pollfd fds[2];
+    fds[0].fd = shard.socket;
+    fds[0].events = POLLIN;
+    fds[0].revents = 0;
+    fds[1].fd = wakeup_fds_[0];
+    fds[1].events = POLLIN;
+    fds[1].revents = 0;
+    
+    // Block until a datagram arrives or Stop() signals the wakeup descriptor,
+    // or only check for either while spinning
+    int result = poll(fds, 2, block ? -1 : 0);
+    if (result < 0) {
+        if (errno != EINTR) {
+            UpdateStats(shard, false);
+            YOLOVR_LOG_EVERY_MS(LogLevel::Warning, 1000, "UDP poll error: %s", strerror(errno));
+        }
+        return false;
+    }
+    if (fds[1].revents != 0) {
+        return false;
+    }
+    return (fds[0].revents & POLLIN) != 0;
+#endif
 }
 
-void TrackerDataReceiver::ReceiverThreadFunction() {
-    DriverLog("TrackerDataReceiver thread started");
+void TrackerDataReceiver::ReceiverThreadFunction(ReceiverShard& shard) {
+    DriverLog("TrackerDataReceiver thread %zu started", shard.index);
     
-    std::vector<uint8_t> buffer(max_frame_size_);
+    int64_t spin_ns = 0;
+    if (low_latency_.enabled) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "receiver %zu", shard.index);
+        const int32_t cpu = low_latency_.receiver_cpu >= 0 ?
+            low_latency_.receiver_cpu + static_cast<int32_t>(shard.index) : -1;
+        TuneCurrentThread(name, cpu, low_latency_.realtime_priority);
+        spin_ns = static_cast<int64_t>(low_latency_.receive_spin_us) * 1000;
+    }
     
+    // Spin-then-block: after a datagram keep polling the socket without
+    // sleeping until spin_ns pass without one, so a sender's next frame is
+    // picked up without a scheduler wakeup
+    int64_t spin_until_ns = 0;
     while (running_.load()) {
-        if (ReceiveFrame()) {
-            // Frame received and processed successfully
+        const bool spinning = spin_ns > 0 && SteadyNowNs() < spin_until_ns;
+        if (!WaitForReadable(shard, !spinning)) {
+            if (spinning) {
+                SpinPause();
+            }
             continue;
         }
         
-        // Small delay to prevent busy-waiting
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        shard.wakeup_time_ns = SteadyNowNs();
+        shard.steady_minus_system_ns = shard.wakeup_time_ns - SystemNowNs();
+        Increment(shard.counters.wakeups);
+        if (spinning) {
+            Increment(shard.counters.spin_wakeups);
+        }
+        spin_until_ns = shard.wakeup_time_ns + spin_ns;
+        
+#ifdef __linux__
+        if (batch_receive_) {
+            ReceiveBatch(shard);
+            continue;
+        }
+#endif
+        ReceiveFrame(shard);
+    }
+    
+    // The last thread out measures how long stopping took
+    if (running_shards_.fetch_sub(1) == 1) {
+        stop_latency_ns_.store(static_cast<uint64_t>(SteadyNowNs() - stop_requested_time_ns_.load()));
     }
     
-    DriverLog("TrackerDataReceiver thread stopped");
+    DriverLog("TrackerDataReceiver thread %zu stopped", shard.index);
 }
 
-bool TrackerDataReceiver::ReceiveFrame() {
-    std::vector<uint8_t> buffer(max_frame_size_);
+bool TrackerDataReceiver::ReceiveFrame(ReceiverShard& shard) {
+    uint8_t* buffer = shard.buffer_pool.Buffer(0);
     struct sockaddr_in sender_addr;
+    
+#ifdef __linux__
+    // recvmsg rather than recvfrom for the ancillary data
+    struct iovec iov;
+    iov.iov_base = buffer;
+    iov.iov_len = shard.buffer_pool.BufferSize();
+    struct msghdr header;
+    std::memset(&header, 0, sizeof(header));
+    header.msg_name = &sender_addr;
+    header.msg_namelen = sizeof(sender_addr);
+    header.msg_iov = &iov;
+    header.msg_iovlen = 1;
+    header.msg_control = shard.batch_control.data();
+    header.msg_controllen = kControlBufferSize;
+    
+    ssize_t bytes_received = recvmsg(shard.socket, &header, 0);
+#else
     socklen_t sender_addr_len = sizeof(sender_addr);
     
-    ssize_t bytes_received = recvfrom(socket_, 
-                                     reinterpret_cast<char*>(buffer.data()), 
-                                     buffer.size(), 
+    ssize_t bytes_received = recvfrom(shard.socket, 
+                                     reinterpret_cast<char*>(buffer), 
+                                     static_cast<int>(shard.buffer_pool.BufferSize()), 
                                      0,
                                      reinterpret_cast<struct sockaddr*>(&sender_addr), 
                                      &sender_addr_len);
+#endif
     
     if (bytes_received == SOCKET_ERROR_VALUE) {
 #ifdef _WIN32
         int error = WSAGetLastError();
         if (error != WSAEWOULDBLOCK && error != WSAETIMEDOUT) {
-            UpdateStats(false);
-            DriverLog("UDP receive error: %d", error);
+            UpdateStats(shard, false);
+            YOLOVR_LOG_EVERY_MS(LogLevel::Warning, 1000, "UDP receive error: %d", error);
         }
 #else
         if (errno != EAGAIN && errno != EWOULDBLOCK) {
-            UpdateStats(false);
-            DriverLog("UDP receive error: %s", strerror(errno));
+            UpdateStats(shard, false);
+            YOLOVR_LOG_EVERY_MS(LogLevel::Warning, 1000, "UDP receive error: %s", strerror(errno));
         }
 #endif
         return false;
@@ -242,45 +787,460 @@ bool TrackerDataReceiver::ReceiveFrame() {
         return false;
     }
     
-    // Parse protobuf message
-    yolovr::TrackerFrame frame;
-    if (!frame.ParseFromArray(buffer.data(), bytes_received)) {
-        UpdateStats(false, true);
-        DriverLog("Failed to parse protobuf message of %zd bytes", bytes_received);
+    Increment(shard.counters.bytes_received, static_cast<uint64_t>(bytes_received));
+#ifdef __linux__
+    SetArrivalTime(shard, ReadControlMessages(shard, header));
+#else
+    SetArrivalTime(shard, 0);
+#endif
+    if (capture_writer_) {
+        capture_writer_->Append(shard.arrival_time_ns, sender_addr.sin_addr.s_addr, sender_addr.sin_port,
+                                buffer, static_cast<size_t>(bytes_received));
+    }
+    
+    return ProcessDatagram(shard, buffer, static_cast<size_t>(bytes_received), &sender_addr);
+}
+
+#ifdef __linux__
+size_t TrackerDataReceiver::ReceiveBatch(ReceiverShard& shard) {
+    const size_t batch_size = shard.buffer_pool.BufferCount();
+    for (size_t i = 0; i < batch_size; i++) {
+        shard.batch_iovecs[i].iov_base = shard.buffer_pool.Buffer(i);
+        shard.batch_iovecs[i].iov_len = shard.buffer_pool.BufferSize();
+        shard.batch_headers[i].msg_hdr.msg_name = &shard.batch_addresses[i];
+        shard.batch_headers[i].msg_hdr.msg_namelen = sizeof(shard.batch_addresses[i]);
+        shard.batch_headers[i].msg_hdr.msg_iov = &shard.batch_iovecs[i];
+        shard.batch_headers[i].msg_hdr.msg_iovlen = 1;
+        shard.batch_headers[i].msg_hdr.msg_control = shard.batch_control.data() + i * kControlBufferSize;
+        shard.batch_headers[i].msg_hdr.msg_controllen = kControlBufferSize;
+        shard.batch_headers[i].msg_hdr.msg_flags = 0;
+        shard.batch_headers[i].msg_len = 0;
+    }
+    
+    int received = recvmmsg(shard.socket, shard.batch_headers.data(), static_cast<unsigned int>(batch_size), MSG_DONTWAIT, nullptr);
+    if (received < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            UpdateStats(shard, false);
+            YOLOVR_LOG_EVERY_MS(LogLevel::Warning, 1000, "UDP batch receive error: %s", strerror(errno));
+        }
+        return 0;
+    }
+    
+    // Drain-to-latest: of the frames one source sent from one address, only
+    // the one with the highest frame_id is parsed (the last of equal ones),
+    // wherever it is in the batch, then the batch is processed in arrival
+    // order. Quantized keyframes are only superseded by a newer keyframe,
+    // since the delta frames after them cannot be decoded without them.
+    // Clock sync pongs are not frames, and neither are datagrams whose header
+    // cannot be read: they are always processed and supersede nothing.
+    // Skipped frames still go through the sequencer, so they count as
+    // received rather than lost.
+    size_t stale = 0;
+    uint64_t bytes = 0;
+    for (int i = 0; i < received; i++) {
+        bytes += shard.batch_headers[i].msg_len;
+        shard.batch_kernel_time_ns[i] = ReadControlMessages(shard, shard.batch_headers[i].msg_hdr);
+        shard.batch_is_latest[i] = 1;
+        shard.batch_has_frame_id[i] = !IsClockPong(shard.buffer_pool.Buffer(i), shard.batch_headers[i].msg_len) &&
+            TrackerFrameDecoder::PeekFrameId(shard.buffer_pool.Buffer(i), shard.batch_headers[i].msg_len,
+                                             shard.batch_source_ids[i], shard.batch_frame_ids[i]) ? 1 : 0;
+    }
+    for (int i = 0; i < received; i++) {
+        if (!shard.batch_has_frame_id[i]) {
+            continue;
+        }
+        const bool keyframe = TrackerFrameDecoder::IsQuantizedKeyframe(shard.buffer_pool.Buffer(i),
+                                                                       shard.batch_headers[i].msg_len);
+        for (int j = 0; j < received; j++) {
+            if (j == i || !shard.batch_has_frame_id[j] ||
+                shard.batch_source_ids[j] != shard.batch_source_ids[i] ||
+                shard.batch_addresses[j].sin_addr.s_addr != shard.batch_addresses[i].sin_addr.s_addr ||
+                shard.batch_addresses[j].sin_port != shard.batch_addresses[i].sin_port) {
+                continue;
+            }
+            const bool newer = shard.batch_frame_ids[j] > shard.batch_frame_ids[i] ||
+                (shard.batch_frame_ids[j] == shard.batch_frame_ids[i] && j > i);
+            if (newer && (!keyframe || TrackerFrameDecoder::IsQuantizedKeyframe(shard.buffer_pool.Buffer(j),
+                                                                                shard.batch_headers[j].msg_len))) {
+                shard.batch_is_latest[i] = 0;
+                stale++;
+                break;
+            }
+        }
+    }
+    
+    // Capture everything, including the datagrams drain-to-latest skips
+    if (capture_writer_) {
+        for (int i = 0; i < received; i++) {
+            SetArrivalTime(shard, shard.batch_kernel_time_ns[i]);
+            capture_writer_->Append(shard.arrival_time_ns, shard.batch_addresses[i].sin_addr.s_addr,
+                                    shard.batch_addresses[i].sin_port, shard.buffer_pool.Buffer(i),
+                                    shard.batch_headers[i].msg_len);
+        }
+    }
+    
+    size_t processed = 0;
+    for (int i = 0; i < received; i++) {
+        if (!shard.batch_is_latest[i]) {
+            // Seen but not published; truncated ones are left to count as lost
+            if (shard.batch_has_frame_id[i] && !(shard.batch_headers[i].msg_hdr.msg_flags & MSG_TRUNC)) {
+                SetArrivalTime(shard, shard.batch_kernel_time_ns[i]);
+                shard.sequencer.Check(shard.batch_source_ids[i], shard.batch_frame_ids[i], shard.arrival_time_ns);
+                UpdateSequenceStats(shard);
+            }
+            continue;
+        }
+        if (shard.batch_headers[i].msg_hdr.msg_flags & MSG_TRUNC) {
+            UpdateStats(shard, false, true);
+            YOLOVR_LOG_EVERY_MS(LogLevel::Warning, 1000, "Dropped truncated datagram larger than %zu bytes", shard.buffer_pool.BufferSize());
+            continue;
+        }
+        SetArrivalTime(shard, shard.batch_kernel_time_ns[i]);
+        if (ProcessDatagram(shard, shard.buffer_pool.Buffer(i), shard.batch_headers[i].msg_len,
+                            &shard.batch_addresses[i])) {
+            processed++;
+        }
+    }
+    
+    Increment(shard.counters.receive_batches);
+    Increment(shard.counters.datagrams_received, static_cast<uint64_t>(received));
+    Increment(shard.counters.stale_datagrams_skipped, stale);
+    Increment(shard.counters.bytes_received, bytes);
+    
+    return processed;
+}
+
+int64_t TrackerDataReceiver::ReadControlMessages(ReceiverShard& shard, const msghdr& header) {
+    int64_t kernel_time_ns = 0;
+    for (const cmsghdr* message = CMSG_FIRSTHDR(&header); message != nullptr;
+         message = CMSG_NXTHDR(const_cast<msghdr*>(&header), const_cast<cmsghdr*>(message))) {
+        if (message->cmsg_level == SOL_SOCKET && message->cmsg_type == SO_RXQ_OVFL) {
+            // The socket's drop count when this datagram was queued; it only
+            // grows while the socket lives, and is absent while it is zero
+            uint32_t drops;
+            std::memcpy(&drops, CMSG_DATA(message), sizeof(drops));
+            if (drops > shard.kernel_drops_reported) {
+                Increment(shard.counters.kernel_drops, drops - shard.kernel_drops_reported);
+                shard.kernel_drops_reported = drops;
+            }
+        } else if (message->cmsg_level == SOL_SOCKET && message->cmsg_type == SCM_TIMESTAMPNS) {
+            timespec received;
+            std::memcpy(&received, CMSG_DATA(message), sizeof(received));
+            kernel_time_ns = static_cast<int64_t>(received.tv_sec) * 1000000000 + received.tv_nsec;
+        }
+    }
+    return kernel_time_ns;
+}
+#endif
+
+void TrackerDataReceiver::SetArrivalTime(ReceiverShard& shard, int64_t kernel_time_ns) {
+    // The kernel stamps datagrams on the system clock. Mapped with the offset
+    // read at the wakeup, they can land a little after it (the two clocks are
+    // read one after the other), or far before it if the system clock stepped
+    // in between, in which case the wakeup is used.
+    const int64_t arrival_ns = kernel_time_ns + shard.steady_minus_system_ns;
+    if (kernel_time_ns != 0 && arrival_ns >= shard.wakeup_time_ns - kMaxQueueDelayNs) {
+        shard.arrival_time_ns = std::min(arrival_ns, shard.wakeup_time_ns);
+    } else {
+        shard.arrival_time_ns = shard.wakeup_time_ns;
+    }
+    shard.arrival_unix_us = (shard.arrival_time_ns - shard.steady_minus_system_ns) / 1000;
+}
+
+bool TrackerDataReceiver::ProcessDatagram(ReceiverShard& shard, const uint8_t* data, size_t size,
+                                          const sockaddr_in* sender) {
+    if (IsClockPong(data, size)) {
+        ProcessClockPong(shard, data, size);
         return false;
     }
     
-    // Validate frame
-    if (frame.trackers().size() > 32) { // Sanity check
-        UpdateStats(false, true);
-        DriverLog("Received frame with too many trackers: %d", frame.trackers().size());
+    // Decode straight into the pending snapshot; nothing is published on failure
+    switch (shard.decoder.Decode(data, size, shard.pending_frame)) {
+    case TrackerFrameDecoder::Result::Ok:
+        break;
+    case TrackerFrameDecoder::Result::TooManyTrackers:
+        UpdateStats(shard, false, true);
+        YOLOVR_LOG_EVERY_MS(LogLevel::Warning, 1000, "Received frame with more than %zu trackers", kMaxTrackersPerFrame);
+        return false;
+    case TrackerFrameDecoder::Result::UnsupportedVersion:
+        UpdateStats(shard, false, true);
+        YOLOVR_LOG_EVERY_MS(LogLevel::Warning, 1000, "Received %s frame with unsupported version",
+                            TrackerFrameDecoder::IsBinaryFrame(data, size) ? "binary" : "quantized");
+        return false;
+    case TrackerFrameDecoder::Result::MissingKeyframe:
+        // Not a parse error: the frame is fine, the keyframe before it was lost
+        Increment(shard.counters.frames_missing_keyframe);
+        YOLOVR_LOG_EVERY_MS(LogLevel::Warning, 1000, "Dropped quantized delta frame: its keyframe was not received");
+        return false;
+    case TrackerFrameDecoder::Result::ParseError:
+    default:
+        UpdateStats(shard, false, true);
+        YOLOVR_LOG_EVERY_MS(LogLevel::Warning, 1000, "Failed to parse %s frame of %zu bytes",
+                            TrackerFrameDecoder::IsBinaryFrame(data, size) ? "binary" :
+                            TrackerFrameDecoder::IsQuantizedFrame(data, size) ? "quantized" : "protobuf", size);
         return false;
     }
     
-    // Update latest frame
-    {
-        std::lock_guard<std::mutex> lock(frame_mutex_);
-        latest_frame_ = std::move(frame);
-        last_update_time_ = std::chrono::steady_clock::now();
+    // A late datagram must never replace a newer frame from the same source
+    TrackerFrameSnapshot& frame = shard.pending_frame;
+    frame.arrival_time_ns = shard.arrival_time_ns;
+    FrameSequencer::Verdict verdict = shard.sequencer.Check(frame.source_id, frame.frame_id, frame.arrival_time_ns);
+    UpdateSequenceStats(shard);
+    if (verdict != FrameSequencer::Verdict::Accept) {
+        return false;
+    }
+    shard.decoder.CommitKeyframe(frame);
+    frame.parsed_time_ns = SteadyNowNs();
+    RecordLatency(shard.counters.arrival_to_wakeup_ns_last, shard.counters.arrival_to_wakeup_ns_max,
+                  shard.counters.arrival_to_wakeup_ns_total, static_cast<uint64_t>(shard.wakeup_time_ns - frame.arrival_time_ns));
+    RecordLatency(shard.counters.wakeup_to_parse_ns_last, shard.counters.wakeup_to_parse_ns_max,
+                  shard.counters.wakeup_to_parse_ns_total, static_cast<uint64_t>(frame.parsed_time_ns - shard.wakeup_time_ns));
+    
+    const size_t slot = AcquireSourceSlot(shard, frame.source_id);
+    ApplyClockSync(shard, slot, sender == nullptr);
+    
+    if (latency_monitor_) {
+        latency_monitor_->RecordSource(frame.source_id, LatencyStage::ArrivalToParsed,
+                                       frame.parsed_time_ns - frame.arrival_time_ns);
+        if (frame.timestamp_us != 0) {
+            const SourceCounters& source = shard.source_counters[slot];
+            const int64_t sender_to_arrival_ns = source.clock.IsSynchronized() ?
+                frame.arrival_time_ns - source.clock.ToLocalNs(frame.timestamp_us) :
+                (shard.arrival_unix_us - static_cast<int64_t>(frame.timestamp_us)) * 1000;
+            latency_monitor_->RecordSource(frame.source_id, LatencyStage::SenderToArrival, sender_to_arrival_ns);
+        }
     }
     
-    UpdateStats(true);
+    PublishFrame(shard, slot);
+    UpdateSourceStats(shard, slot, size);
+    UpdateStats(shard, true);
+    
+    ShardCounters& counters = shard.counters;
+    RecordLatency(counters.receive_latency_ns_last, counters.receive_latency_ns_max, counters.receive_latency_ns_total,
+                  static_cast<uint64_t>(SteadyNowNs() - shard.wakeup_time_ns));
+    
+    // Off the publish path: nothing waits for the ping
+    if (sender) {
+        SendClockPing(shard, slot, *sender);
+    }
     return true;
 }
 
-void TrackerDataReceiver::UpdateStats(bool success, bool parse_error) {
-    std::lock_guard<std::mutex> lock(stats_mutex_);
+size_t TrackerDataReceiver::AcquireSourceSlot(ReceiverShard& shard, uint32_t source_id) {
+    // The slot already holding this source, else a free one, else the least recently updated
+    size_t slot = 0;
+    bool found = false;
+    for (size_t i = 0; i < kMaxSourcesPerShard; i++) {
+        const int64_t updated_ns = shard.source_update_ns[i].load(std::memory_order_relaxed);
+        if (updated_ns != 0 && shard.source_ids[i] == source_id) {
+            slot = i;
+            found = true;
+            break;
+        }
+        if (updated_ns < shard.source_update_ns[slot].load(std::memory_order_relaxed)) {
+            slot = i;
+        }
+    }
+    if (!found && shard.source_update_ns[slot].load(std::memory_order_relaxed) != 0) {
+        YOLOVR_LOG_EVERY_MS(LogLevel::Warning, 1000, "Too many tracking sources on receive thread %zu, replacing source %u with %u",
+                            shard.index, shard.source_ids[slot], source_id);
+    }
+    if (!found) {
+        SourceCounters& counters = shard.source_counters[slot];
+        counters.source_id.store(source_id, std::memory_order_relaxed);
+        counters.frames_received.store(0, std::memory_order_relaxed);
+        counters.bytes_received.store(0, std::memory_order_relaxed);
+        counters.interval_ns.store(0, std::memory_order_relaxed);
+        counters.jitter_ns.store(0, std::memory_order_relaxed);
+        counters.last_arrival_ns = 0;
+        counters.last_timestamp_us = 0;
+        counters.clock_synchronized.store(false, std::memory_order_relaxed);
+        counters.clock_offset_ns.store(0, std::memory_order_relaxed);
+        counters.clock_rtt_ns.store(0, std::memory_order_relaxed);
+        counters.clock_drift_ppb.store(0, std::memory_order_relaxed);
+        counters.sample_age_ns.store(0, std::memory_order_relaxed);
+        counters.clock.Reset();
+        counters.ping_outstanding = false;
+        counters.last_ping_ns = 0;
+    }
+    shard.source_ids[slot] = source_id;
+    return slot;
+}
+
+void TrackerDataReceiver::PublishFrame(ReceiverShard& shard, size_t slot) {
+    const TrackerFrameSnapshot& frame = shard.pending_frame;
+    shard.source_frames[slot].Store(frame);
+    shard.source_update_ns[slot].store(frame.arrival_time_ns, std::memory_order_release);
+    latest_location_.store(static_cast<uint32_t>(shard.index * kMaxSourcesPerShard + slot), std::memory_order_release);
+    last_update_time_ns_.store(frame.arrival_time_ns, std::memory_order_release);
+    publish_sequence_.fetch_add(1, std::memory_order_acq_rel);
     
-    if (success) {
-        stats_.frames_received++;
-        stats_.last_frame_time = std::chrono::steady_clock::now();
-    } else {
-        if (parse_error) {
-            stats_.parse_errors++;
+    // Pairs with the increment in WaitForNewFrame: either the waiter sees the
+    // new sequence or we see the waiter and notify it
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (frame_waiters_.load() > 0) {
+        { std::lock_guard<std::mutex> lock(frame_wait_mutex_); }
+        frame_wait_cv_.notify_all();
+    }
+}
+
+void TrackerDataReceiver::ApplyClockSync(ReceiverShard& shard, size_t slot, bool same_host) {
+    TrackerFrameSnapshot& frame = shard.pending_frame;
+    TrackerPoseArrays& poses = frame.poses;
+    SourceCounters& counters = shard.source_counters[slot];
+    const ClockSync& clock = counters.clock;
+    const int64_t oldest_ns = frame.arrival_time_ns - kMaxSampleAgeNs;
+    
+    // Injected frames get no pings: shared memory senders share this host's
+    // system clock, so map with the offset read at the wakeup instead. One
+    // that lands further back than the clamp is not on this clock (a replayed
+    // capture) and is aged from arrival like an unsynchronized sender.
+    auto to_host_ns = [&shard](uint64_t timestamp_us) {
+        return static_cast<int64_t>(timestamp_us) * 1000 + shard.steady_minus_system_ns;
+    };
+    const bool host_clock = same_host && frame.timestamp_us != 0 && to_host_ns(frame.timestamp_us) >= oldest_ns;
+    
+    if ((!clock.IsSynchronized() && !host_clock) || frame.timestamp_us == 0) {
+        for (uint32_t i = 0; i < frame.tracker_count; i++) {
+            poses.sample_time_ns[i] = frame.arrival_time_ns;
+        }
+        return;
+    }
+    auto to_local_ns = [&](uint64_t timestamp_us) {
+        return host_clock ? to_host_ns(timestamp_us) : clock.ToLocalNs(timestamp_us);
+    };
+    
+    // A pose cannot be sampled after it arrived; anything later is estimate error
+    for (uint32_t i = 0; i < frame.tracker_count; i++) {
+        const int64_t sample_ns = poses.timestamp_us[i] != 0 ? to_local_ns(poses.timestamp_us[i]) : frame.arrival_time_ns;
+        poses.sample_time_ns[i] = std::min(std::max(sample_ns, oldest_ns), frame.arrival_time_ns);
+    }
+    
+    const int64_t age_ns = std::max<int64_t>(frame.arrival_time_ns - to_local_ns(frame.timestamp_us), 0);
+    int64_t smoothed_ns = counters.sample_age_ns.load(std::memory_order_relaxed);
+    smoothed_ns = smoothed_ns == 0 ? age_ns : smoothed_ns + (age_ns - smoothed_ns) / 16;
+    counters.sample_age_ns.store(smoothed_ns, std::memory_order_relaxed);
+}
+
+void TrackerDataReceiver::ProcessClockPong(ReceiverShard& shard, const uint8_t* data, size_t size) {
+    ClockPong pong;
+    if (!DecodeClockPong(data, size, pong)) {
+        UpdateStats(shard, false, true);
+        YOLOVR_LOG_EVERY_MS(LogLevel::Warning, 1000, "Failed to parse clock sync pong of %zu bytes", size);
+        return;
+    }
+    
+    // Only the answer to the outstanding ping; a late one for an older ping is ignored
+    for (size_t slot = 0; slot < kMaxSourcesPerShard; slot++) {
+        SourceCounters& counters = shard.source_counters[slot];
+        if (shard.source_update_ns[slot].load(std::memory_order_relaxed) == 0 || shard.source_ids[slot] != pong.ping.source_id ||
+            !counters.ping_outstanding || pong.ping.sequence != counters.ping_sequence ||
+            pong.ping.origin_time_ns != counters.ping_origin_ns) {
+            continue;
+        }
+        counters.ping_outstanding = false;
+        if (!counters.clock.AddSample(pong.ping.origin_time_ns, pong.receive_time_us, pong.transmit_time_us,
+                                      shard.arrival_time_ns)) {
+            return;
+        }
+        Increment(shard.counters.clock_pongs_received);
+        
+        const ClockSync::Estimate estimate = counters.clock.GetEstimate(shard.arrival_time_ns);
+        counters.clock_offset_ns.store(estimate.offset_ns, std::memory_order_relaxed);
+        counters.clock_rtt_ns.store(estimate.rtt_ns, std::memory_order_relaxed);
+        counters.clock_drift_ppb.store(static_cast<int64_t>(estimate.drift_ppm * 1e3), std::memory_order_relaxed);
+        if (estimate.synchronized && !counters.clock_synchronized.load(std::memory_order_relaxed)) {
+            const int64_t system_minus_steady_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count() - SteadyNowNs();
+            DriverLog("Clock of source %u synchronized: %.3f ms ahead of the driver's system clock, round trip %.3f ms",
+                      pong.ping.source_id, (estimate.offset_ns - system_minus_steady_ns) / 1e6, estimate.rtt_ns / 1e6);
+        }
+        counters.clock_synchronized.store(estimate.synchronized, std::memory_order_relaxed);
+        return;
+    }
+}
+
+void TrackerDataReceiver::SendClockPing(ReceiverShard& shard, size_t slot, const sockaddr_in& sender) {
+    if (clock_sync_interval_ns_ <= 0 || shard.socket == INVALID_SOCKET_VALUE) {
+        return;
+    }
+    SourceCounters& counters = shard.source_counters[slot];
+    const int64_t now_ns = SteadyNowNs();
+    if (now_ns - counters.last_ping_ns < clock_sync_interval_ns_) {
+        return;
+    }
+    
+    // An unanswered ping is simply replaced; its pong no longer matches
+    ClockPing ping;
+    ping.source_id = shard.source_ids[slot];
+    ping.sequence = ++counters.ping_sequence;
+    ping.origin_time_ns = now_ns;
+    uint8_t message[kClockPingSize];
+    const size_t message_size = EncodeClockPing(ping, message, sizeof(message));
+    
+    counters.last_ping_ns = now_ns;
+    if (sendto(shard.socket, reinterpret_cast<const char*>(message), static_cast<int>(message_size), 0,
+               reinterpret_cast<const sockaddr*>(&sender), sizeof(sender)) == SOCKET_ERROR_VALUE) {
+        counters.ping_outstanding = false;
+        YOLOVR_LOG_EVERY_MS(LogLevel::Warning, 1000, "Failed to send clock sync ping to source %u", ping.source_id);
+        return;
+    }
+    counters.ping_origin_ns = ping.origin_time_ns;
+    counters.ping_outstanding = true;
+    Increment(shard.counters.clock_pings_sent);
+}
+
+void TrackerDataReceiver::UpdateSequenceStats(ReceiverShard& shard) {
+    // Each shard sequences its own senders; add what changed since the last report.
+    // frames_lost can shrink when a late frame fills a gap, which unsigned wraparound handles.
+    const FrameSequencer::Counters& counters = shard.sequencer.GetCounters();
+    FrameSequencer::Counters& reported = shard.reported_counters;
+    Increment(shard.counters.frames_lost, counters.frames_lost - reported.frames_lost);
+    Increment(shard.counters.frames_reordered, counters.frames_reordered - reported.frames_reordered);
+    Increment(shard.counters.frames_duplicate, counters.frames_duplicate - reported.frames_duplicate);
+    Increment(shard.counters.source_restarts, counters.source_restarts - reported.source_restarts);
+    reported = counters;
+}
+
+void TrackerDataReceiver::UpdateSourceStats(ReceiverShard& shard, size_t slot, size_t size) {
+    const TrackerFrameSnapshot& frame = shard.pending_frame;
+    SourceCounters& counters = shard.source_counters[slot];
+    Increment(counters.frames_received);
+    Increment(counters.bytes_received, size);
+    
+    if (counters.last_arrival_ns != 0) {
+        const int64_t interval_ns = frame.arrival_time_ns - counters.last_arrival_ns;
+        int64_t smoothed_ns = counters.interval_ns.load(std::memory_order_relaxed);
+        
+        // RFC 3550 jitter: how much the arrival spacing differs from the send
+        // spacing. Without sender timestamps, compare with the mean spacing.
+        int64_t deviation_ns;
+        if (frame.timestamp_us != 0 && counters.last_timestamp_us != 0) {
+            deviation_ns = interval_ns -
+                static_cast<int64_t>(frame.timestamp_us - counters.last_timestamp_us) * 1000;
         } else {
-            stats_.network_errors++;
+            deviation_ns = smoothed_ns != 0 ? interval_ns - smoothed_ns : 0;
         }
-        stats_.frames_dropped++;
+        int64_t jitter_ns = counters.jitter_ns.load(std::memory_order_relaxed);
+        jitter_ns += (std::llabs(deviation_ns) - jitter_ns) / 16;
+        counters.jitter_ns.store(jitter_ns, std::memory_order_relaxed);
+        
+        smoothed_ns = smoothed_ns == 0 ? interval_ns : smoothed_ns + (interval_ns - smoothed_ns) / 16;
+        counters.interval_ns.store(smoothed_ns, std::memory_order_relaxed);
+    }
+    counters.last_arrival_ns = frame.arrival_time_ns;
+    counters.last_timestamp_us = frame.timestamp_us;
+}
+
+void TrackerDataReceiver::UpdateStats(ReceiverShard& shard, bool success, bool parse_error) {
+    ShardCounters& counters = shard.counters;
+    if (success) {
+        Increment(counters.frames_received);
+        counters.last_frame_time_ns.store(shard.arrival_time_ns, std::memory_order_relaxed);
+    } else if (parse_error) {
+        Increment(counters.parse_errors);
+    } else {
+        Increment(counters.network_errors);
     }
 }
 
@@ -5,6 +5,7 @@
 #include <atomic>
 #include <thread>
 #include <mutex>
+#include <condition_variable>
 #include <chrono>
 #include <memory>
 
@@ -25,69 +26,359 @@
     #define closesocket close
 #endif
 
-#include "tracker_data.pb.h"
+#ifdef __linux__
+    #include <sys/uio.h>
+#endif
+
+#include <vector>
+
+#include "clock_sync.h"
+#include "datagram_buffer_pool.h"
+#include "datagram_capture.h"
+#include "frame_sequencer.h"
+#include "latency_monitor.h"
+#include "low_latency.h"
+#include "tracker_frame_decoder.h"
+#include "tracker_frame_snapshot.h"
+#include "seqlock.h"
 
 namespace yolovr {
 
+// Receives tracker frames over UDP and keeps the newest frame of every source.
+//
+// Each receive shard is one socket and one thread. With more than one shard
+// the sockets share the port through SO_REUSEPORT (Linux), and the kernel
+// spreads senders across them by address, so one sender always lands on the
+// same shard. Every shard decodes, sequences, publishes and counts on its
+// own; the only state shared between shards is the new-frame notification.
+//
+// Frames are kept per source_id, so tracking systems sending to the same port
+// no longer overwrite each other. Use GetSourceFrames() with SourceFusion to
+// merge them.
+//
+// Each source's clock is synchronized with ping/pong exchanges on the
+// receive socket (see ClockSync), so the poses of senders that answer get a
+// sample time in driver time (TrackerPoseArrays::sample_time_ns). Injected
+// frames (shared memory) share this host's clock and are mapped directly.
+//
+// Frames are stamped with the time the kernel received their datagram
+// (SO_TIMESTAMPNS, Linux), mapped into steady_clock, so their age does not
+// include waiting in the socket queue for the receive thread to wake up.
+// Elsewhere they are stamped with the wakeup.
+//
+// In low latency mode (SetLowLatency) the receive threads keep polling their
+// socket for a while after every datagram instead of going back to sleep,
+// and can be pinned to a core and run SCHED_FIFO.
 class TrackerDataReceiver {
 public:
+    // Sources kept per shard; the least recently updated one is replaced when full
+    static constexpr size_t kMaxSourcesPerShard = 4;
+    static constexpr size_t kMaxShards = 8;
+
     TrackerDataReceiver(const std::string& bind_address = "0.0.0.0", uint16_t port = 9999);
     ~TrackerDataReceiver();
 
-    // Start/stop the UDP receiver thread
+    // Start/stop the UDP receiver threads
     bool Start();
     void Stop();
     
-    // Get the latest received tracker frame
-    bool GetLatestFrame(yolovr::TrackerFrame& frame);
+    // Get the most recently received frame of any source. Wait-free for the
+    // network threads, never blocks on them and never allocates.
+    bool GetLatestFrame(TrackerFrameSnapshot& frame) const;
+    
+    // Copy the newest frame of every source heard from within the source max
+    // age into frames. Returns the number of frames written (at most max_frames).
+    size_t GetSourceFrames(TrackerFrameSnapshot* frames, size_t max_frames) const;
+    
+    // Process a datagram on the calling thread as if the first receive thread
+    // had just received it (capture replay, benchmarks). Only while the
+    // receiver is stopped, and from one thread at a time. Returns true if it
+    // was published as a new frame.
+    bool InjectDatagram(const uint8_t* data, size_t size);
+    
+    // Block until a frame newer than last_sequence has been published or the
+    // timeout expires. On success last_sequence is advanced to the newest frame.
+    // With spin, poll for up to that long first instead of sleeping right away.
+    bool WaitForNewFrame(uint64_t& last_sequence, std::chrono::milliseconds timeout,
+                         std::chrono::microseconds spin = std::chrono::microseconds(0));
     
     // Check if we have recent data
-    bool HasRecentData(std::chrono::milliseconds max_age = std::chrono::milliseconds(100));
+    bool HasRecentData(std::chrono::milliseconds max_age = std::chrono::milliseconds(100)) const;
     
-    // Get receiver statistics
+    // Receiver statistics. Counters are kept per receive thread and summed
+    // here, so reading them never contends with receiving.
     struct Stats {
         uint64_t frames_received;
         uint64_t frames_dropped;
         uint64_t parse_errors;
         uint64_t network_errors;
+        uint64_t bytes_received;          // Payload bytes of every datagram read from the sockets
+        uint64_t kernel_drops;            // Datagrams the kernel dropped on a full socket queue (SO_RXQ_OVFL, Linux)
+        uint64_t receive_batches;         // recvmmsg calls that returned data
+        uint64_t datagrams_received;      // Datagrams pulled by batched receives
+        uint64_t stale_datagrams_skipped; // Superseded by a newer frame of the same source and sender
+        uint64_t wakeups;                 // Times a receiver thread woke with data pending
+        uint64_t arrival_to_wakeup_ns_last; // Kernel receive time -> receiver wakeup, of accepted frames
+        uint64_t arrival_to_wakeup_ns_max;
+        uint64_t arrival_to_wakeup_ns_total; // Divide by frames_received for the mean
+        uint64_t spin_wakeups;            // Of those, found while polling in low latency mode rather than woken
+        uint64_t wakeup_to_parse_ns_last; // Wakeup -> frame parsed and accepted
+        uint64_t wakeup_to_parse_ns_max;
+        uint64_t wakeup_to_parse_ns_total; // Divide by frames_received for the mean
+        uint64_t receive_latency_ns_last; // Wakeup -> frame published
+        uint64_t receive_latency_ns_max;
+        uint64_t receive_latency_ns_total; // Divide by frames_received for the mean
+        uint64_t stop_latency_ns;         // Stop() request -> receiver thread exit
+        uint64_t frames_lost;             // frame_id gaps per source_id that were never filled
+        uint64_t frames_reordered;        // Rejected: older than a frame already published
+        uint64_t frames_duplicate;        // Rejected: frame_id already published
+        uint64_t source_restarts;         // Sender sequences that started over
+        uint64_t frames_missing_keyframe; // Quantized delta frames dropped: their keyframe was not received
+        uint64_t clock_pings_sent;
+        uint64_t clock_pongs_received;    // Answers that matched the outstanding ping
+        uint64_t interarrival_jitter_ns;  // Largest jitter of the sources within the source max age
+        uint64_t receive_buffer_bytes;    // Effective SO_RCVBUF of the sockets
         std::chrono::steady_clock::time_point last_frame_time;
     };
     
     Stats GetStats() const;
     
+    // Per-source receive statistics
+    struct SourceStats {
+        uint32_t source_id;
+        uint64_t frames_received;       // Frames accepted by the sequencer
+        uint64_t bytes_received;
+        double frame_rate_hz;           // From the smoothed inter-arrival time, 0 once the source is stale
+        double jitter_ms;               // RFC 3550 inter-arrival jitter
+        double age_ms;                  // Time since the last frame
+        
+        // Clock sync, valid once clock_synchronized is set
+        bool clock_synchronized;
+        double clock_offset_ms;         // Sender clock minus the driver's system clock
+        double clock_rtt_ms;
+        double clock_drift_ppm;
+        double sample_age_ms;           // Smoothed sender timestamp -> arrival, in driver time
+    };
+    
+    // Copy the stats of every source currently held into sources. Returns the
+    // number written (at most max_sources).
+    size_t GetSourceStats(SourceStats* sources, size_t max_sources) const;
+    
+    // Write Stats and SourceStats as JSON into out, always NUL-terminated.
+    // Returns the length the full report needs (like snprintf).
+    size_t FormatStatsReport(char* out, size_t out_size) const;
+    
     // Configuration
+    // Upper bound on how long the receiver thread waits before rechecking for
+    // Stop() on platforms without a wakeup descriptor (Windows)
     void SetTimeout(std::chrono::milliseconds timeout) { timeout_ms_ = timeout; }
     void SetMaxFrameSize(size_t max_size) { max_frame_size_ = max_size; }
+    
+    // Requested SO_RCVBUF per socket in bytes, 0 for the system default. The
+    // kernel caps it (net.core.rmem_max on Linux); Stats reports what was
+    // granted. Takes effect on the next Start().
+    void SetReceiveBufferSize(size_t bytes) { receive_buffer_bytes_ = bytes; }
+    
+    // Drain all queued datagrams with one recvmmsg call and only parse the newest
+    // frame per sender address and source_id (Linux only). Takes effect on the
+    // next Start().
+    void SetBatchReceive(bool enable, size_t batch_size = 32) {
+        batch_receive_ = enable;
+        batch_size_ = batch_size > 0 ? batch_size : 1;
+    }
+    
+    // Number of SO_REUSEPORT sockets and threads to receive on (Linux only,
+    // other platforms always use one). Takes effect on the next Start().
+    void SetShardCount(size_t shard_count);
+    
+    // Record per-source receive latency into monitor (may be null). Call before Start().
+    void SetLatencyMonitor(LatencyMonitor* monitor) { latency_monitor_ = monitor; }
+    
+    // Append every datagram received on the sockets to writer (may be null).
+    // Call before Start().
+    void SetCaptureWriter(DatagramCaptureWriter* writer) { capture_writer_ = writer; }
+    
+    // Sources not heard from for this long are left out of GetSourceFrames()
+    void SetSourceMaxAge(std::chrono::milliseconds max_age) { source_max_age_ns_ = max_age.count() * 1000000; }
+    
+    // How often each source is sent a clock sync ping, 0 to never
+    void SetClockSyncInterval(std::chrono::milliseconds interval) { clock_sync_interval_ns_ = interval.count() * 1000000; }
+    
+    // Busy polling, spin-then-block receive, CPU pinning and SCHED_FIFO for
+    // the receive threads. Takes effect on the next Start().
+    void SetLowLatency(const LowLatencySettings& settings) { low_latency_ = settings; }
 
 private:
+    // Counters of one shard. Only the shard's thread writes them, so updates
+    // are plain relaxed load/store pairs; GetStats() sums all shards.
+    struct ShardCounters {
+        std::atomic<uint64_t> frames_received{0};
+        std::atomic<uint64_t> parse_errors{0};
+        std::atomic<uint64_t> network_errors{0};
+        std::atomic<uint64_t> bytes_received{0};
+        std::atomic<uint64_t> kernel_drops{0};
+        std::atomic<uint64_t> receive_batches{0};
+        std::atomic<uint64_t> datagrams_received{0};
+        std::atomic<uint64_t> stale_datagrams_skipped{0};
+        std::atomic<uint64_t> wakeups{0};
+        std::atomic<uint64_t> arrival_to_wakeup_ns_last{0};
+        std::atomic<uint64_t> arrival_to_wakeup_ns_max{0};
+        std::atomic<uint64_t> arrival_to_wakeup_ns_total{0};
+        std::atomic<uint64_t> spin_wakeups{0};
+        std::atomic<uint64_t> wakeup_to_parse_ns_last{0};
+        std::atomic<uint64_t> wakeup_to_parse_ns_max{0};
+        std::atomic<uint64_t> wakeup_to_parse_ns_total{0};
+        std::atomic<uint64_t> receive_latency_ns_last{0};
+        std::atomic<uint64_t> receive_latency_ns_max{0};
+        std::atomic<uint64_t> receive_latency_ns_total{0};
+        std::atomic<uint64_t> frames_lost{0};
+        std::atomic<uint64_t> frames_reordered{0};
+        std::atomic<uint64_t> frames_duplicate{0};
+        std::atomic<uint64_t> source_restarts{0};
+        std::atomic<uint64_t> frames_missing_keyframe{0};
+        std::atomic<uint64_t> clock_pings_sent{0};
+        std::atomic<uint64_t> clock_pongs_received{0};
+        std::atomic<int64_t> last_frame_time_ns{0};
+    };
+    
+    // Receive statistics of one source slot, reset when the slot changes hands
+    struct SourceCounters {
+        std::atomic<uint32_t> source_id{0};
+        std::atomic<uint64_t> frames_received{0};
+        std::atomic<uint64_t> bytes_received{0};
+        std::atomic<int64_t> interval_ns{0};   // Smoothed inter-arrival time
+        std::atomic<int64_t> jitter_ns{0};
+        
+        // Clock sync estimate, published after every exchange
+        std::atomic<bool> clock_synchronized{false};
+        std::atomic<int64_t> clock_offset_ns{0};    // Sender clock minus steady_clock
+        std::atomic<int64_t> clock_rtt_ns{0};
+        std::atomic<int64_t> clock_drift_ppb{0};
+        std::atomic<int64_t> sample_age_ns{0};
+        
+        // Writer side
+        int64_t last_arrival_ns = 0;
+        uint64_t last_timestamp_us = 0;
+        ClockSync clock;
+        bool ping_outstanding = false;
+        uint32_t ping_sequence = 0;
+        int64_t ping_origin_ns = 0;
+        int64_t last_ping_ns = 0;
+    };
+    
+    // One socket, its receive thread and everything that thread owns
+    struct ReceiverShard {
+        size_t index = 0;
+        socket_t socket = INVALID_SOCKET_VALUE;
+        std::thread thread;
+        int64_t wakeup_time_ns = 0;
+        int64_t steady_minus_system_ns = 0; // Clock offset read at the wakeup, to map kernel timestamps
+        int64_t arrival_time_ns = 0;    // Kernel receive time of the datagram being processed, steady_clock
+        int64_t arrival_unix_us = 0;    // Same instant on the system clock, to compare with sender timestamps
+        
+        TrackerFrameSnapshot pending_frame{};
+        TrackerFrameDecoder decoder;
+        FrameSequencer sequencer;
+        FrameSequencer::Counters reported_counters{};
+        ShardCounters counters;
+        uint32_t kernel_drops_reported = 0; // Socket drop count at the last SO_RXQ_OVFL message
+        
+        // Newest frame per source. source_ids is writer-side bookkeeping;
+        // readers go by the source_id inside the snapshot.
+        uint32_t source_ids[kMaxSourcesPerShard] = {};
+        std::atomic<int64_t> source_update_ns[kMaxSourcesPerShard] = {};
+        SeqLock<TrackerFrameSnapshot> source_frames[kMaxSourcesPerShard];
+        SourceCounters source_counters[kMaxSourcesPerShard];
+        
+        // Receive buffers, allocated in Start()
+        DatagramBufferPool buffer_pool;
+#ifdef __linux__
+        std::vector<mmsghdr> batch_headers;
+        std::vector<iovec> batch_iovecs;
+        std::vector<sockaddr_in> batch_addresses;
+        std::vector<uint8_t> batch_is_latest;
+        std::vector<uint8_t> batch_control;   // kControlBufferSize bytes per datagram
+        std::vector<int64_t> batch_kernel_time_ns;
+        std::vector<uint8_t> batch_has_frame_id;  // Header peeked into batch_source_ids / batch_frame_ids
+        std::vector<uint32_t> batch_source_ids;
+        std::vector<uint64_t> batch_frame_ids;
+#endif
+    };
+    
     // Network configuration
     std::string bind_address_;
     uint16_t port_;
-    socket_t socket_;
     
     // Threading
     std::atomic<bool> running_;
-    std::thread receiver_thread_;
+    std::atomic<int64_t> stop_requested_time_ns_;
+    std::atomic<int> running_shards_;
+#ifndef _WIN32
+    int wakeup_fds_[2] = { -1, -1 }; // eventfd on Linux (both ends equal), pipe elsewhere
+#endif
     
-    // Data storage
-    mutable std::mutex frame_mutex_;
-    yolovr::TrackerFrame latest_frame_;
-    std::chrono::steady_clock::time_point last_update_time_;
+    // Shards are created on first use and live as long as the receiver, so
+    // readers can walk them without synchronizing with Start()
+    std::unique_ptr<ReceiverShard> shards_[kMaxShards];
+    std::atomic<size_t> shard_count_;
+    size_t configured_shard_count_;
     
-    // Statistics
-    mutable std::mutex stats_mutex_;
-    Stats stats_;
+    // Publication, shared by all shards
+    std::atomic<uint64_t> publish_sequence_;
+    std::atomic<uint32_t> latest_location_;       // shard * kMaxSourcesPerShard + source slot
+    std::atomic<int64_t> last_update_time_ns_;    // steady_clock nanoseconds
+    int64_t source_max_age_ns_;
+    int64_t clock_sync_interval_ns_;
+    LatencyMonitor* latency_monitor_;
+    DatagramCaptureWriter* capture_writer_;
+    
+    // New-frame notification; receiver threads only touch the mutex when
+    // someone is waiting
+    std::mutex frame_wait_mutex_;
+    std::condition_variable frame_wait_cv_;
+    std::atomic<int> frame_waiters_;
+    
+    // Statistics not owned by a single shard
+    std::atomic<uint64_t> stop_latency_ns_;
+    std::atomic<uint64_t> receive_buffer_bytes_granted_;
     
     // Configuration
     std::chrono::milliseconds timeout_ms_;
     size_t max_frame_size_;
+    size_t receive_buffer_bytes_;
+    bool batch_receive_;
+    size_t batch_size_;
+    LowLatencySettings low_latency_;
     
     // Internal methods
-    void ReceiverThreadFunction();
-    bool InitializeSocket();
-    void CleanupSocket();
-    bool ReceiveFrame();
-    void UpdateStats(bool success, bool parse_error = false);
+    void ReceiverThreadFunction(ReceiverShard& shard);
+    bool InitializeSocket(ReceiverShard& shard, bool reuse_port);
+    void CleanupSocket(ReceiverShard& shard);
+    bool InitializeWakeup();
+    void CleanupWakeup();
+    void SignalWakeup();
+    // block false only checks whether a datagram is pending
+    bool WaitForReadable(ReceiverShard& shard, bool block);
+    bool ReceiveFrame(ReceiverShard& shard);
+#ifdef __linux__
+    size_t ReceiveBatch(ReceiverShard& shard);
+    // Returns the kernel receive timestamp (system clock), 0 if there is none
+    int64_t ReadControlMessages(ReceiverShard& shard, const msghdr& header);
+#endif
+    // kernel_time_ns is a system clock receive timestamp, or 0 to use the wakeup
+    void SetArrivalTime(ReceiverShard& shard, int64_t kernel_time_ns);
+    // sender is null for datagrams that did not come from the sockets
+    bool ProcessDatagram(ReceiverShard& shard, const uint8_t* data, size_t size, const sockaddr_in* sender);
+    size_t AcquireSourceSlot(ReceiverShard& shard, uint32_t source_id);
+    void PublishFrame(ReceiverShard& shard, size_t slot);
+    // same_host for injected frames, whose timestamps are on this host's clock
+    void ApplyClockSync(ReceiverShard& shard, size_t slot, bool same_host);
+    void ProcessClockPong(ReceiverShard& shard, const uint8_t* data, size_t size);
+    void SendClockPing(ReceiverShard& shard, size_t slot, const sockaddr_in& sender);
+    void StopShards();
+    void UpdateStats(ReceiverShard& shard, bool success, bool parse_error = false);
+    void UpdateSequenceStats(ReceiverShard& shard);
+    void UpdateSourceStats(ReceiverShard& shard, size_t slot, size_t size);
     
 #ifdef _WIN32
     // Windows-specific initialization
@@ -1,9 +1,14 @@
 //============ Copyright (c) Valve Corporation, All rights reserved. ============
 #include "tracker_device_driver.h"
 
-#include <chrono>
+#include "async_logger.h"
 #include "driverlog.h"
-#include "vrmath.h"
+#include "pose_publisher.h"
+#include "tracker_data_receiver.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
 
 // Let's create some variables for strings used in getting settings.
 // This is the section where all of the settings we want are stored. A section name can be anything,
@@ -21,12 +26,8 @@ static const char* tracker_names[] = {
     "LeftForearm", "RightForearm", "Head"
 };
 
-// Default positions relative to HMD (in meters)
-struct TrackerOffset {
-    float x, y, z;
-};
-
-static const TrackerOffset tracker_offsets[] = {
+// Default positions relative to HMD (in meters), x, y, z
+const float my_tracker_fallback_offsets[ MyTrackerCount ][ 3 ] = {
     {-0.15f, -1.2f, 0.0f},  // LeftLegTracker
     {0.15f, -1.2f, 0.0f},   // RightLegTracker  
     {-0.2f, -0.6f, 0.0f},   // LeftThighTracker
@@ -41,6 +42,8 @@ static const TrackerOffset tracker_offsets[] = {
     {0.0f, 0.0f, 0.0f}      // HeadTracker (same as HMD)
 };
 
+static_assert( MyTrackerCount <= yolovr::HmdPoseCache::kMaxTrackers, "every tracker needs an HmdPoseCache offset" );
+
 // Tracker roles for SteamVR
 static const vr::ETrackedControllerRole tracker_roles[] = {
     vr::TrackedControllerRole_Invalid, // LeftLegTracker
@@ -57,11 +60,15 @@ static const vr::ETrackedControllerRole tracker_roles[] = {
     vr::TrackedControllerRole_Invalid  // HeadTracker
 };
 
-MyTrackerDeviceDriver::MyTrackerDeviceDriver( unsigned int my_tracker_id )
+MyTrackerDeviceDriver::MyTrackerDeviceDriver( unsigned int my_tracker_id, yolovr::PosePublisher *pose_publisher,
+	const yolovr::DriverSettings &settings )
 {
+	pose_publisher_ = pose_publisher;
+	prediction_ = settings.prediction;
+	pose_hold_timeout_ns_ = static_cast< int64_t >( settings.pose_hold_timeout_ms ) * 1000000;
+
 	// Set a member to keep track of whether we've activated yet or not
 	is_active_ = false;
-	has_udp_data_ = false;
 
 	my_tracker_id_ = my_tracker_id;
 
@@ -139,7 +146,8 @@ vr::EVRInitError MyTrackerDeviceDriver::Activate( uint32_t unObjectId )
 
 	// Trackers don't have inputs, so we skip all the input setup
 
-	my_pose_update_thread_ = std::thread( &MyTrackerDeviceDriver::MyPoseUpdateThread, this );
+	// We don't start a pose thread of our own: the provider's PosePublisher submits our pose
+	// alongside every other tracker's as soon as we're active.
 
 	// We've activated everything successfully!
 	// Let's tell SteamVR that by saying we don't have any errors.
@@ -160,12 +168,35 @@ void *MyTrackerDeviceDriver::GetComponent( const char *pchComponentNameAndVersio
 //-----------------------------------------------------------------------------
 // Purpose: This is called by vrserver when a debug request has been made from an application to the driver.
 // What is in the response and request is up to the application and driver to figure out themselves.
+//
+// "latency"        - JSON p50/p90/p99/max of every pipeline stage for this tracker and for every source
+// "latency_reset"  - clear all latency histograms
+// "receiver_stats" - JSON receive counters, latencies and per-source rate, jitter and clock sync state
 //-----------------------------------------------------------------------------
 void MyTrackerDeviceDriver::DebugRequest(
 	const char *pchRequest, char *pchResponseBuffer, uint32_t unResponseBufferSize )
 {
 	if ( unResponseBufferSize >= 1 )
 		pchResponseBuffer[ 0 ] = 0;
+
+	if ( !pose_publisher_ || !pchRequest )
+		return;
+
+	yolovr::LatencyMonitor *latency_monitor = pose_publisher_->GetLatencyMonitor();
+	yolovr::TrackerDataReceiver *receiver = pose_publisher_->GetReceiver();
+	if ( latency_monitor && std::strcmp( pchRequest, "latency" ) == 0 )
+	{
+		latency_monitor->FormatReport( my_tracker_id_, pchResponseBuffer, unResponseBufferSize );
+	}
+	else if ( latency_monitor && std::strcmp( pchRequest, "latency_reset" ) == 0 )
+	{
+		latency_monitor->Reset();
+		snprintf( pchResponseBuffer, unResponseBufferSize, "{\"reset\":true}" );
+	}
+	else if ( receiver && std::strcmp( pchRequest, "receiver_stats" ) == 0 )
+	{
+		receiver->FormatStatsReport( pchResponseBuffer, unResponseBufferSize );
+	}
 }
 
 //-----------------------------------------------------------------------------
@@ -181,83 +212,99 @@ vr::DriverPose_t MyTrackerDeviceDriver::GetPose()
 	pose.qWorldFromDriverRotation.w = 1.f;
 	pose.qDriverFromHeadRotation.w = 1.f;
 
-	// Check if we have UDP data for this tracker
-	bool use_udp = has_udp_data_.load();
+	// Our slot holds the last pose received while tracking; read it without locking
+	const int64_t now_ns = std::chrono::duration_cast< std::chrono::nanoseconds >(
+		std::chrono::steady_clock::now().time_since_epoch() ).count();
+	yolovr::TrackerSlot slot;
+	bool use_udp = pose_publisher_ && pose_publisher_->GetSlotTable().Read( my_tracker_id_, slot ) &&
+				   now_ns - slot.pose_arrival_time_ns <= pose_hold_timeout_ns_;
 	
-	if (use_udp) {
-		// Use UDP tracking data
-		std::lock_guard<std::mutex> lock(udp_data_mutex_);
-		
-		// Set position from UDP data
-		pose.vecPosition[0] = udp_pose_.position().x();
-		pose.vecPosition[1] = udp_pose_.position().y();
-		pose.vecPosition[2] = udp_pose_.position().z();
-		
-		// Set rotation from UDP data
-		pose.qRotation.x = udp_pose_.rotation().x();
-		pose.qRotation.y = udp_pose_.rotation().y();
-		pose.qRotation.z = udp_pose_.rotation().z();
-		pose.qRotation.w = udp_pose_.rotation().w();
-		
-		// Set velocities if available
-		if (udp_pose_.has_velocity()) {
-			pose.vecVelocity[0] = udp_pose_.velocity().x();
-			pose.vecVelocity[1] = udp_pose_.velocity().y();
-			pose.vecVelocity[2] = udp_pose_.velocity().z();
-			pose.vecWorldFromDriverTranslation[0] = pose.vecVelocity[0];
-			pose.vecWorldFromDriverTranslation[1] = pose.vecVelocity[1];
-			pose.vecWorldFromDriverTranslation[2] = pose.vecVelocity[2];
+	if (use_udp && slot.is_tracking) {
+		// The pose is as old as the time since the sender sampled it (its arrival, for senders
+		// without clock sync); either extrapolate it to now (+ lookahead) or tell SteamVR how
+		// old it is via poseTimeOffset so it can extrapolate it itself
+		const double data_age_s = ( now_ns - slot.pose.sample_time_ns ) * 1e-9;
+		const yolovr::PredictionTiming timing = yolovr::ComputePredictionTiming( prediction_, data_age_s );
+
+		float position[ 3 ];
+		float rotation[ 4 ];
+		yolovr::ExtrapolatePose( slot.pose, timing.extrapolate_s, position, rotation );
+		pose.poseTimeOffset = timing.pose_time_offset_s;
+
+		pose.vecPosition[0] = position[0];
+		pose.vecPosition[1] = position[1];
+		pose.vecPosition[2] = position[2];
+
+		pose.qRotation.x = rotation[0];
+		pose.qRotation.y = rotation[1];
+		pose.qRotation.z = rotation[2];
+		pose.qRotation.w = rotation[3];
+
+		// Velocities are world space; qWorldFromDriverRotation is identity so no transform is needed
+		if (slot.pose.has_velocity) {
+			pose.vecVelocity[0] = slot.pose.velocity[0];
+			pose.vecVelocity[1] = slot.pose.velocity[1];
+			pose.vecVelocity[2] = slot.pose.velocity[2];
+		}
+		if (slot.pose.has_angular_velocity) {
+			pose.vecAngularVelocity[0] = slot.pose.angular_velocity[0];
+			pose.vecAngularVelocity[1] = slot.pose.angular_velocity[1];
+			pose.vecAngularVelocity[2] = slot.pose.angular_velocity[2];
 		}
 		
-		// Set tracking confidence
-		pose.poseIsValid = udp_pose_.is_tracking();
+		pose.poseIsValid = true;
 		pose.deviceIsConnected = true;
-		pose.result = udp_pose_.is_tracking() ? vr::TrackingResult_Running_OK : vr::TrackingResult_Running_OutOfRange;
+		pose.result = vr::TrackingResult_Running_OK;
 		
-		DriverLog("Tracker %s using UDP data: pos(%.3f,%.3f,%.3f) tracking=%s", 
-			tracker_names[my_tracker_id_], 
-			udp_pose_.position().x(), udp_pose_.position().y(), udp_pose_.position().z(),
-			udp_pose_.is_tracking() ? "true" : "false");
+		YOLOVR_LOG_HOT( "Tracker %s using UDP data: pos(%.3f,%.3f,%.3f)",
+			tracker_names[ my_tracker_id_ ],
+			slot.pose.position[ 0 ], slot.pose.position[ 1 ], slot.pose.position[ 2 ] );
+		
+	} else if (use_udp) {
+		// Lost or missing from the latest frame: hold the last valid pose where it was
+		pose.vecPosition[0] = slot.pose.position[0];
+		pose.vecPosition[1] = slot.pose.position[1];
+		pose.vecPosition[2] = slot.pose.position[2];
+
+		pose.qRotation.x = slot.pose.rotation[0];
+		pose.qRotation.y = slot.pose.rotation[1];
+		pose.qRotation.z = slot.pose.rotation[2];
+		pose.qRotation.w = slot.pose.rotation[3];
+
+		pose.poseIsValid = true;
+		pose.deviceIsConnected = true;
+		pose.result = vr::TrackingResult_Running_OutOfRange;
 		
 	} else {
-		// Fallback to fake data when no UDP data available
-		vr::TrackedDevicePose_t hmd_pose{};
-		vr::VRServerDriverHost()->GetRawTrackedDevicePoses( 0.f, &hmd_pose, 1 );
-
-		// Get the position of the hmd from the 3x4 matrix GetRawTrackedDevicePoses returns
-		const vr::HmdVector3_t hmd_position = HmdVector3_From34Matrix( hmd_pose.mDeviceToAbsoluteTracking );
-		// Get the orientation of the hmd from the 3x4 matrix GetRawTrackedDevicePoses returns
-		const vr::HmdQuaternion_t hmd_orientation = HmdQuaternion_FromMatrix( hmd_pose.mDeviceToAbsoluteTracking );
-
-		// For HeadTracker, attach directly to HMD position
-		if (my_tracker_id_ == HeadTracker) {
-			pose.qRotation = hmd_orientation;
-			pose.vecPosition[0] = hmd_position.v[0];
-			pose.vecPosition[1] = hmd_position.v[1];
-			pose.vecPosition[2] = hmd_position.v[2];
+		// Fallback to fake data when no UDP data available: follow the HMD at our offset. The pose publisher
+		// fetches the HMD pose once per pass for every fallback tracker and applies all offsets in one go;
+		// ask it to keep doing so, and fetch it ourselves if its last sample is too old (or there is no publisher).
+		yolovr::HmdPoseCache::Sample hmd;
+		bool has_hmd_sample = false;
+		if ( pose_publisher_ ) {
+			pose_publisher_->RequestHmdPose();
+			has_hmd_sample = pose_publisher_->GetHmdPoseCache().Read( now_ns, hmd );
+		}
+
+		float position[ 3 ];
+		if ( has_hmd_sample ) {
+			position[0] = hmd.tracker_position[0][my_tracker_id_];
+			position[1] = hmd.tracker_position[1][my_tracker_id_];
+			position[2] = hmd.tracker_position[2][my_tracker_id_];
 		} else {
-			// For other trackers, use the predefined offset
-			const TrackerOffset& offset = tracker_offsets[my_tracker_id_];
-			
-			// Set the pose orientation to match HMD orientation for body trackers
-			pose.qRotation = hmd_orientation;
-
-			const vr::HmdVector3_t offset_position = {
-				offset.x,
-				offset.y,
-				offset.z
-			};
-
-			// Rotate our offset by the hmd quaternion (so the trackers maintain relative position to user), 
-			// and then add the position of the hmd to put it into position.
-			const vr::HmdVector3_t position = hmd_position + (offset_position * hmd_orientation);
-
-			// copy our position to our pose
-			pose.vecPosition[0] = position.v[0];
-			pose.vecPosition[1] = position.v[1];
-			pose.vecPosition[2] = position.v[2];
+			yolovr::HmdPoseCache::FetchHmdPose( now_ns, hmd );
+			const float *const offset[ 3 ] = { &my_tracker_fallback_offsets[ my_tracker_id_ ][ 0 ],
+				&my_tracker_fallback_offsets[ my_tracker_id_ ][ 1 ], &my_tracker_fallback_offsets[ my_tracker_id_ ][ 2 ] };
+			float *const out[ 3 ] = { &position[ 0 ], &position[ 1 ], &position[ 2 ] };
+			yolovr::HmdPoseCache::TransformOffsets( hmd.hmd_to_world, offset, 1, out );
 		}
 
+		// Set the pose orientation to match HMD orientation, so the trackers maintain relative position to user
+		pose.qRotation = hmd.hmd_rotation;
+		pose.vecPosition[0] = position[0];
+		pose.vecPosition[1] = position[1];
+		pose.vecPosition[2] = position[2];
+
 		// The pose we provided is valid.
 		pose.poseIsValid = true;
 		pose.deviceIsConnected = true;
@@ -267,17 +314,17 @@ vr::DriverPose_t MyTrackerDeviceDriver::GetPose()
 	return pose;
 }
 
-void MyTrackerDeviceDriver::MyPoseUpdateThread()
+//-----------------------------------------------------------------------------
+// Purpose: Used by the PosePublisher to decide whether to submit our pose, and where to.
+//-----------------------------------------------------------------------------
+bool MyTrackerDeviceDriver::MyIsActive() const
 {
-	while ( is_active_ )
-	{
-		// Inform the vrserver that our tracked device's pose has updated, giving it the pose returned by our GetPose().
-		vr::VRServerDriverHost()->TrackedDevicePoseUpdated( my_device_index_, GetPose(), sizeof( vr::DriverPose_t ) );
+	return is_active_;
+}
 
-		// Update our pose every five milliseconds.
-		// In reality, you should update the pose whenever you have new data from your device.
-		std::this_thread::sleep_for( std::chrono::milliseconds( 5 ) );
-	}
+vr::TrackedDeviceIndex_t MyTrackerDeviceDriver::MyGetDeviceIndex() const
+{
+	return my_device_index_;
 }
 
 //-----------------------------------------------------------------------------
@@ -297,12 +344,11 @@ void MyTrackerDeviceDriver::EnterStandby()
 //-----------------------------------------------------------------------------
 void MyTrackerDeviceDriver::Deactivate()
 {
-	// Let's join our pose thread that's running
-	// by first checking then setting is_active_ to false to break out
-	// of the while loop, if it's running, then call .join() on the thread
-	if ( is_active_.exchange( false ) )
+	// Stop the pose publisher from submitting our pose:
+	// clear is_active_ and then wait out any publish pass that may still be using our index
+	if ( is_active_.exchange( false ) && pose_publisher_ )
 	{
-		my_pose_update_thread_.join();
+		pose_publisher_->WaitForPublishPass();
 	}
 
 	// unassign our controller index (we don't want to be calling vrserver anymore after Deactivate() has been called
@@ -310,25 +356,6 @@ void MyTrackerDeviceDriver::Deactivate()
 }
 
 
-//-----------------------------------------------------------------------------
-// Purpose: Update tracker with data from UDP
-//-----------------------------------------------------------------------------
-void MyTrackerDeviceDriver::MyUpdateFromUDP( const yolovr::TrackerFrame &frame )
-{
-	// Find our tracker in the UDP frame
-	for (const auto& tracker_pose : frame.trackers()) {
-		if (tracker_pose.tracker_id() == my_tracker_id_) {
-			std::lock_guard<std::mutex> lock(udp_data_mutex_);
-			udp_pose_ = tracker_pose;
-			has_udp_data_.store(tracker_pose.is_tracking());
-			return;
-		}
-	}
-	
-	// If we didn't find our tracker in the frame, mark as not tracking
-	has_udp_data_.store(false);
-}
-
 //-----------------------------------------------------------------------------
 // Purpose: This is called by our IServerTrackedDeviceProvider when its RunFrame() method gets called.
 // It's not part of the ITrackedDeviceServerDriver interface, we created it ourselves.
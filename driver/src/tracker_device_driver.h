@@ -3,12 +3,16 @@
 
 #include <array>
 #include <string>
-#include <mutex>
 
 #include "openvr_driver.h"
 #include <atomic>
-#include <thread>
-#include "tracker_data.pb.h"
+#include "driver_settings.h"
+#include "pose_predictor.h"
+#include "tracker_slot_table.h"
+
+namespace yolovr {
+class PosePublisher;
+}
 
 enum MyTrackers
 {
@@ -24,7 +28,12 @@ enum MyTrackers
 	LeftElbowTracker = 9,
 	RightElbowTracker = 10,
 	HeadTracker = 11, // only for ground-truth tracking setups
+	MyTrackerCount = 12, // number of tracker types above, not a tracker
 };
+
+// Where each tracker sits relative to the HMD (x, y, z in meters, HMD space) while it has no UDP data
+extern const float my_tracker_fallback_offsets[ MyTrackerCount ][ 3 ];
+
 //-----------------------------------------------------------------------------
 // Purpose: Represents a single tracked device in the system.
 // What this device actually is (controller, hmd) depends on the
@@ -33,7 +42,8 @@ enum MyTrackers
 class MyTrackerDeviceDriver : public vr::ITrackedDeviceServerDriver
 {
 public:
-	MyTrackerDeviceDriver( unsigned int my_tracker_id );
+	MyTrackerDeviceDriver( unsigned int my_tracker_id, yolovr::PosePublisher *pose_publisher,
+		const yolovr::DriverSettings &settings );
 
 	vr::EVRInitError Activate( uint32_t unObjectId ) override;
 
@@ -53,9 +63,9 @@ public:
 
 	void MyRunFrame();
 	void MyProcessEvent( const vr::VREvent_t &vrevent );
-	void MyUpdateFromUDP( const yolovr::TrackerFrame &frame );
 
-	void MyPoseUpdateThread();
+	bool MyIsActive() const;
+	vr::TrackedDeviceIndex_t MyGetDeviceIndex() const;
 
 private:
 	unsigned int my_tracker_id_;
@@ -65,11 +75,14 @@ private:
 	std::string my_device_model_number_;
 	std::string my_device_serial_number_;
 
-	// UDP tracking data
-	std::atomic<bool> has_udp_data_;
-	yolovr::TrackerPose udp_pose_;
-	std::mutex udp_data_mutex_;
-
 	std::atomic< bool > is_active_;
-	std::thread my_pose_update_thread_;
+
+	// How UDP poses are extrapolated to hide pipeline latency
+	yolovr::PredictionSettings prediction_;
+
+	// How long our last UDP pose is held once the tracker stops tracking
+	int64_t pose_hold_timeout_ns_;
+
+	// Submits our pose together with every other tracker's, and owns the slot table we read UDP poses from
+	yolovr::PosePublisher *pose_publisher_;
 };
\ No newline at end of file
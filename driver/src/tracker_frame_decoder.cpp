@@ -0,0 +1,532 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+#include "tracker_frame_decoder.h"
+#include "tracker_wire_format.h"
+
+#include <cstring>
+#include <limits>
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/wire_format_lite.h>
+
+namespace yolovr {
+
+namespace {
+
+using google::protobuf::io::CodedInputStream;
+using google::protobuf::internal::WireFormatLite;
+
+// Field numbers from proto/tracker_data.proto
+enum FrameField {
+    kFrameId = 1,
+    kFrameTimestamp = 2,
+    kFrameSourceId = 3,
+    kFrameTrackers = 5,
+    kFrameSystemFps = 7,
+    kFrameIsCalibrated = 8,
+};
+
+enum PoseField {
+    kPoseTrackerId = 1,
+    kPosePosition = 3,
+    kPoseRotation = 4,
+    kPoseIsTracking = 5,
+    kPoseConfidence = 6,
+    kPoseTimestamp = 7,
+    kPoseVelocity = 8,
+    kPoseAngularVelocity = 9,
+};
+
+bool IsWireType(uint32_t tag, WireFormatLite::WireType type) {
+    return WireFormatLite::GetTagWireType(tag) == type;
+}
+
+bool ReadFloat(CodedInputStream& input, float& value) {
+    uint32_t bits;
+    if (!input.ReadLittleEndian32(&bits)) {
+        return false;
+    }
+    std::memcpy(&value, &bits, sizeof(value));
+    return true;
+}
+
+bool ReadBool(CodedInputStream& input, bool& value) {
+    uint64_t raw;
+    if (!input.ReadVarint64(&raw)) {
+        return false;
+    }
+    value = raw != 0;
+    return true;
+}
+
+// Reads a length-delimited Vector3 (x=1, y=2, z=3) or Quaternion (x=1..w=4)
+// into components[axis][index]. Repeated occurrences merge, as protobuf does.
+bool ReadFloatMessage(CodedInputStream& input, float (*components)[kMaxTrackersPerFrame], size_t index, int count) {
+    uint32_t length;
+    if (!input.ReadVarint32(&length)) {
+        return false;
+    }
+    CodedInputStream::Limit limit = input.PushLimit(static_cast<int>(length));
+    while (uint32_t tag = input.ReadTag()) {
+        int field = WireFormatLite::GetTagFieldNumber(tag);
+        if (field >= 1 && field <= count && IsWireType(tag, WireFormatLite::WIRETYPE_FIXED32)) {
+            if (!ReadFloat(input, components[field - 1][index])) {
+                return false;
+            }
+        } else if (!WireFormatLite::SkipField(&input, tag)) {
+            return false;
+        }
+    }
+    if (!input.ConsumedEntireMessage()) {
+        return false;
+    }
+    input.PopLimit(limit);
+    return true;
+}
+
+bool ReadPose(CodedInputStream& input, TrackerPoseArrays& poses, size_t index) {
+    uint32_t length;
+    if (!input.ReadVarint32(&length)) {
+        return false;
+    }
+    CodedInputStream::Limit limit = input.PushLimit(static_cast<int>(length));
+    while (uint32_t tag = input.ReadTag()) {
+        const int field = WireFormatLite::GetTagFieldNumber(tag);
+        bool ok;
+        if (field == kPoseTrackerId && IsWireType(tag, WireFormatLite::WIRETYPE_VARINT)) {
+            ok = input.ReadVarint32(&poses.tracker_id[index]);
+        } else if (field == kPosePosition && IsWireType(tag, WireFormatLite::WIRETYPE_LENGTH_DELIMITED)) {
+            ok = ReadFloatMessage(input, poses.position, index, 3);
+        } else if (field == kPoseRotation && IsWireType(tag, WireFormatLite::WIRETYPE_LENGTH_DELIMITED)) {
+            ok = ReadFloatMessage(input, poses.rotation, index, 4);
+        } else if (field == kPoseIsTracking && IsWireType(tag, WireFormatLite::WIRETYPE_VARINT)) {
+            bool value = false;
+            ok = ReadBool(input, value);
+            poses.is_tracking[index] = value ? 1 : 0;
+        } else if (field == kPoseConfidence && IsWireType(tag, WireFormatLite::WIRETYPE_FIXED32)) {
+            ok = ReadFloat(input, poses.confidence[index]);
+        } else if (field == kPoseTimestamp && IsWireType(tag, WireFormatLite::WIRETYPE_VARINT)) {
+            ok = input.ReadVarint64(&poses.timestamp_us[index]);
+        } else if (field == kPoseVelocity && IsWireType(tag, WireFormatLite::WIRETYPE_LENGTH_DELIMITED)) {
+            ok = ReadFloatMessage(input, poses.velocity, index, 3);
+            poses.has_velocity[index] = 1;
+        } else if (field == kPoseAngularVelocity && IsWireType(tag, WireFormatLite::WIRETYPE_LENGTH_DELIMITED)) {
+            ok = ReadFloatMessage(input, poses.angular_velocity, index, 3);
+            poses.has_angular_velocity[index] = 1;
+        } else {
+            // Unused (tracker_name), unknown or mismatched wire type: skip like protobuf does
+            ok = WireFormatLite::SkipField(&input, tag);
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+    if (!input.ConsumedEntireMessage()) {
+        return false;
+    }
+    input.PopLimit(limit);
+    return true;
+}
+
+// Proto3 defaults for one tracker slot, since the wire may omit any field
+void ClearPose(TrackerPoseArrays& poses, size_t index) {
+    poses.tracker_id[index] = 0;
+    poses.is_tracking[index] = 0;
+    poses.has_velocity[index] = 0;
+    poses.has_angular_velocity[index] = 0;
+    poses.confidence[index] = 0.0f;
+    poses.timestamp_us[index] = 0;
+    for (int axis = 0; axis < 3; axis++) {
+        poses.position[axis][index] = 0.0f;
+        poses.velocity[axis][index] = 0.0f;
+        poses.angular_velocity[axis][index] = 0.0f;
+    }
+    for (int axis = 0; axis < 4; axis++) {
+        poses.rotation[axis][index] = 0.0f;
+    }
+}
+
+// Little-endian loads; every platform SteamVR runs on is little-endian
+template <typename T>
+T Load(const uint8_t* data) {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+struct QuantizedSteps {
+    float position;
+    float velocity;
+    float angular_velocity;
+};
+
+void DecodeQuantizedRecord(const uint8_t* record, const QuantizedSteps& steps, uint64_t frame_timestamp_us,
+                           TrackerPoseArrays& poses, size_t index) {
+    const uint8_t flags = record[quantized_record::kFlags];
+    poses.tracker_id[index] = record[quantized_record::kTrackerId];
+    poses.is_tracking[index] = (flags & kBinaryTracking) ? 1 : 0;
+    poses.has_velocity[index] = (flags & kBinaryHasVelocity) ? 1 : 0;
+    poses.has_angular_velocity[index] = (flags & kBinaryHasAngularVelocity) ? 1 : 0;
+    poses.confidence[index] = record[quantized_record::kConfidence] * (1.0f / 255.0f);
+    poses.timestamp_us[index] = frame_timestamp_us +
+        static_cast<int64_t>(Load<int32_t>(record + quantized_record::kTimestampOffset));
+
+    for (size_t axis = 0; axis < 3; axis++) {
+        poses.position[axis][index] =
+            Load<int16_t>(record + quantized_record::kPosition + axis * sizeof(int16_t)) * steps.position;
+        poses.velocity[axis][index] =
+            Load<int16_t>(record + quantized_record::kVelocity + axis * sizeof(int16_t)) * steps.velocity;
+        poses.angular_velocity[axis][index] =
+            Load<int16_t>(record + quantized_record::kAngularVelocity + axis * sizeof(int16_t)) * steps.angular_velocity;
+    }
+
+    float rotation[4];
+    UnpackQuaternion(Load<uint32_t>(record + quantized_record::kRotation), rotation);
+    for (size_t axis = 0; axis < 4; axis++) {
+        poses.rotation[axis][index] = rotation[axis];
+    }
+}
+
+} // namespace
+
+TrackerFrameDecoder::TrackerFrameDecoder()
+    : use_counter_(0)
+    , keyframe_decoded_(false)
+{
+    Reset();
+}
+
+void TrackerFrameDecoder::Reset() {
+    for (Keyframe& keyframe : keyframes_) {
+        keyframe.in_use = false;
+        keyframe.source_id = 0;
+        keyframe.keyframe_id = 0;
+        keyframe.last_used = 0;
+        keyframe.tracker_count = 0;
+    }
+    use_counter_ = 0;
+    keyframe_decoded_ = false;
+}
+
+void TrackerFrameDecoder::CommitKeyframe(const TrackerFrameSnapshot& frame) {
+    if (!keyframe_decoded_) {
+        return;
+    }
+    keyframe_decoded_ = false;
+
+    Keyframe* keyframe = FindKeyframe(frame.source_id);
+    if (!keyframe) {
+        keyframe = &ClaimKeyframe(frame.source_id);
+    }
+    keyframe->keyframe_id = frame.frame_id;
+    keyframe->last_used = ++use_counter_;
+    keyframe->tracker_count = frame.tracker_count;
+    keyframe->poses = frame.poses;
+}
+
+bool TrackerFrameDecoder::IsBinaryFrame(const uint8_t* data, size_t size) {
+    return size >= sizeof(kBinaryMagic) && std::memcmp(data, kBinaryMagic, sizeof(kBinaryMagic)) == 0;
+}
+
+bool TrackerFrameDecoder::IsQuantizedFrame(const uint8_t* data, size_t size) {
+    return size >= sizeof(kQuantizedMagic) && std::memcmp(data, kQuantizedMagic, sizeof(kQuantizedMagic)) == 0;
+}
+
+bool TrackerFrameDecoder::IsQuantizedKeyframe(const uint8_t* data, size_t size) {
+    return size >= kQuantizedHeaderSize && IsQuantizedFrame(data, size) &&
+        (Load<uint32_t>(data + quantized_header::kFlags) & kQuantizedKeyframe) != 0;
+}
+
+bool TrackerFrameDecoder::PeekFrameId(const uint8_t* data, size_t size, uint32_t& source_id, uint64_t& frame_id) {
+    // The same header checks Decode() makes, so a frame it would reject is
+    // not sequenced and cannot turn the valid resend of its frame_id into a
+    // duplicate
+    if (IsBinaryFrame(data, size)) {
+        if (size < kBinaryHeaderSize || Load<uint16_t>(data + binary_header::kVersion) != kBinaryFormatVersion) {
+            return false;
+        }
+        const size_t header_size = Load<uint16_t>(data + binary_header::kHeaderSize);
+        const size_t record_size = Load<uint16_t>(data + binary_header::kRecordSize);
+        const size_t count = Load<uint16_t>(data + binary_header::kTrackerCount);
+        if (header_size < kBinaryHeaderSize || record_size < kBinaryRecordSize ||
+            header_size + count * record_size > size || count > kMaxTrackersPerFrame) {
+            return false;
+        }
+        source_id = Load<uint32_t>(data + binary_header::kSourceId);
+        frame_id = Load<uint64_t>(data + binary_header::kFrameId);
+        return true;
+    }
+    if (IsQuantizedFrame(data, size)) {
+        if (size < kQuantizedHeaderSize ||
+            Load<uint16_t>(data + quantized_header::kVersion) != kQuantizedFormatVersion) {
+            return false;
+        }
+        const size_t header_size = Load<uint16_t>(data + quantized_header::kHeaderSize);
+        const size_t record_size = Load<uint16_t>(data + quantized_header::kRecordSize);
+        const size_t count = Load<uint16_t>(data + quantized_header::kTrackerCount);
+        if (header_size < kQuantizedHeaderSize || record_size < kQuantizedRecordSize ||
+            header_size + count * record_size > size || count > kMaxTrackersPerFrame) {
+            return false;
+        }
+        source_id = Load<uint32_t>(data + quantized_header::kSourceId);
+        frame_id = Load<uint64_t>(data + quantized_header::kFrameId);
+        return true;
+    }
+    if (size > static_cast<size_t>(std::numeric_limits<int>::max())) {
+        return false;
+    }
+
+    // Trackers are skipped by their length, not parsed; a field the sender
+    // left at its default is absent, so this walks the whole frame
+    source_id = 0;
+    frame_id = 0;
+    size_t tracker_count = 0;
+    CodedInputStream input(data, static_cast<int>(size));
+    while (uint32_t tag = input.ReadTag()) {
+        const int field = WireFormatLite::GetTagFieldNumber(tag);
+        bool ok;
+        if (field == kFrameId && IsWireType(tag, WireFormatLite::WIRETYPE_VARINT)) {
+            ok = input.ReadVarint64(&frame_id);
+        } else if (field == kFrameSourceId && IsWireType(tag, WireFormatLite::WIRETYPE_VARINT)) {
+            ok = input.ReadVarint32(&source_id);
+        } else {
+            if (field == kFrameTrackers && ++tracker_count > kMaxTrackersPerFrame) {
+                return false;
+            }
+            ok = WireFormatLite::SkipField(&input, tag);
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+    return input.ConsumedEntireMessage();
+}
+
+TrackerFrameDecoder::Result TrackerFrameDecoder::Decode(
+    const uint8_t* data, size_t size, TrackerFrameSnapshot& frame) {
+    keyframe_decoded_ = false;
+    if (IsBinaryFrame(data, size)) {
+        return DecodeBinary(data, size, frame);
+    }
+    if (IsQuantizedFrame(data, size)) {
+        return DecodeQuantized(data, size, frame);
+    }
+    return DecodeProtobuf(data, size, frame);
+}
+
+TrackerFrameDecoder::Result TrackerFrameDecoder::DecodeBinary(
+    const uint8_t* data, size_t size, TrackerFrameSnapshot& frame) const {
+    if (size < kBinaryHeaderSize) {
+        return Result::ParseError;
+    }
+    if (Load<uint16_t>(data + binary_header::kVersion) != kBinaryFormatVersion) {
+        return Result::UnsupportedVersion;
+    }
+
+    const size_t header_size = Load<uint16_t>(data + binary_header::kHeaderSize);
+    const size_t record_size = Load<uint16_t>(data + binary_header::kRecordSize);
+    const size_t count = Load<uint16_t>(data + binary_header::kTrackerCount);
+    if (header_size < kBinaryHeaderSize || record_size < kBinaryRecordSize ||
+        header_size + count * record_size > size) {
+        return Result::ParseError;
+    }
+    if (count > kMaxTrackersPerFrame) {
+        return Result::TooManyTrackers;
+    }
+
+    frame.frame_id = Load<uint64_t>(data + binary_header::kFrameId);
+    frame.timestamp_us = Load<uint64_t>(data + binary_header::kTimestamp);
+    frame.source_id = Load<uint32_t>(data + binary_header::kSourceId);
+    frame.system_fps = Load<float>(data + binary_header::kSystemFps);
+    frame.is_calibrated = (Load<uint32_t>(data + binary_header::kFlags) & kBinaryFrameCalibrated) != 0;
+    frame.tracker_count = static_cast<uint32_t>(count);
+
+    // Fixed stride, no per-field branches: each output channel is a straight
+    // strided load into a contiguous array
+    TrackerPoseArrays& poses = frame.poses;
+    const uint8_t* records = data + header_size;
+    for (size_t i = 0; i < count; i++) {
+        const uint8_t* record = records + i * record_size;
+        const uint16_t flags = Load<uint16_t>(record + binary_record::kFlags);
+
+        poses.tracker_id[i] = Load<uint16_t>(record + binary_record::kTrackerId);
+        poses.is_tracking[i] = (flags & kBinaryTracking) ? 1 : 0;
+        poses.has_velocity[i] = (flags & kBinaryHasVelocity) ? 1 : 0;
+        poses.has_angular_velocity[i] = (flags & kBinaryHasAngularVelocity) ? 1 : 0;
+        poses.confidence[i] = Load<float>(record + binary_record::kConfidence);
+        poses.timestamp_us[i] = frame.timestamp_us +
+            static_cast<int64_t>(Load<int32_t>(record + binary_record::kTimestampOffset));
+
+        for (size_t axis = 0; axis < 3; axis++) {
+            poses.position[axis][i] = Load<float>(record + binary_record::kPosition + axis * sizeof(float));
+            poses.velocity[axis][i] = Load<float>(record + binary_record::kVelocity + axis * sizeof(float));
+            poses.angular_velocity[axis][i] =
+                Load<float>(record + binary_record::kAngularVelocity + axis * sizeof(float));
+        }
+        for (size_t axis = 0; axis < 4; axis++) {
+            poses.rotation[axis][i] = Load<float>(record + binary_record::kRotation + axis * sizeof(float));
+        }
+    }
+    return Result::Ok;
+}
+
+TrackerFrameDecoder::Result TrackerFrameDecoder::DecodeProtobuf(
+    const uint8_t* data, size_t size, TrackerFrameSnapshot& frame) const {
+    if (size > static_cast<size_t>(std::numeric_limits<int>::max())) {
+        return Result::ParseError;
+    }
+
+    // Proto3 defaults for everything the wire may omit
+    frame.frame_id = 0;
+    frame.timestamp_us = 0;
+    frame.source_id = 0;
+    frame.is_calibrated = false;
+    frame.system_fps = 0.0f;
+    frame.tracker_count = 0;
+
+    CodedInputStream input(data, static_cast<int>(size));
+    while (uint32_t tag = input.ReadTag()) {
+        const int field = WireFormatLite::GetTagFieldNumber(tag);
+        bool ok;
+        if (field == kFrameId && IsWireType(tag, WireFormatLite::WIRETYPE_VARINT)) {
+            ok = input.ReadVarint64(&frame.frame_id);
+        } else if (field == kFrameTimestamp && IsWireType(tag, WireFormatLite::WIRETYPE_VARINT)) {
+            ok = input.ReadVarint64(&frame.timestamp_us);
+        } else if (field == kFrameSourceId && IsWireType(tag, WireFormatLite::WIRETYPE_VARINT)) {
+            ok = input.ReadVarint32(&frame.source_id);
+        } else if (field == kFrameTrackers && IsWireType(tag, WireFormatLite::WIRETYPE_LENGTH_DELIMITED)) {
+            if (frame.tracker_count >= kMaxTrackersPerFrame) {
+                return Result::TooManyTrackers;
+            }
+            const size_t index = frame.tracker_count++;
+            ClearPose(frame.poses, index);
+            ok = ReadPose(input, frame.poses, index);
+        } else if (field == kFrameSystemFps && IsWireType(tag, WireFormatLite::WIRETYPE_FIXED32)) {
+            ok = ReadFloat(input, frame.system_fps);
+        } else if (field == kFrameIsCalibrated && IsWireType(tag, WireFormatLite::WIRETYPE_VARINT)) {
+            ok = ReadBool(input, frame.is_calibrated);
+        } else {
+            // Unused (hmd_pose, system_name), unknown or mismatched wire type
+            ok = WireFormatLite::SkipField(&input, tag);
+        }
+        if (!ok) {
+            return Result::ParseError;
+        }
+    }
+
+    // ReadTag() returns 0 both at the end of input and on a malformed tag
+    if (!input.ConsumedEntireMessage()) {
+        return Result::ParseError;
+    }
+    return Result::Ok;
+}
+
+TrackerFrameDecoder::Result TrackerFrameDecoder::DecodeQuantized(
+    const uint8_t* data, size_t size, TrackerFrameSnapshot& frame) {
+    if (size < kQuantizedHeaderSize) {
+        return Result::ParseError;
+    }
+    if (Load<uint16_t>(data + quantized_header::kVersion) != kQuantizedFormatVersion) {
+        return Result::UnsupportedVersion;
+    }
+
+    const size_t header_size = Load<uint16_t>(data + quantized_header::kHeaderSize);
+    const size_t record_size = Load<uint16_t>(data + quantized_header::kRecordSize);
+    const size_t count = Load<uint16_t>(data + quantized_header::kTrackerCount);
+    if (header_size < kQuantizedHeaderSize || record_size < kQuantizedRecordSize ||
+        header_size + count * record_size > size) {
+        return Result::ParseError;
+    }
+    if (count > kMaxTrackersPerFrame) {
+        return Result::TooManyTrackers;
+    }
+
+    const uint32_t flags = Load<uint32_t>(data + quantized_header::kFlags);
+    const uint64_t frame_id = Load<uint64_t>(data + quantized_header::kFrameId);
+    const uint64_t keyframe_id = Load<uint64_t>(data + quantized_header::kKeyframeId);
+    const uint32_t source_id = Load<uint32_t>(data + quantized_header::kSourceId);
+    const bool is_keyframe = (flags & kQuantizedKeyframe) != 0;
+
+    // A delta frame is only usable on top of exactly the keyframe it names
+    Keyframe* keyframe = FindKeyframe(source_id);
+    if (!is_keyframe && (!keyframe || keyframe->keyframe_id != keyframe_id)) {
+        return Result::MissingKeyframe;
+    }
+
+    frame.frame_id = frame_id;
+    frame.timestamp_us = Load<uint64_t>(data + quantized_header::kTimestamp);
+    frame.source_id = source_id;
+    frame.system_fps = Load<float>(data + quantized_header::kSystemFps);
+    frame.is_calibrated = (flags & kQuantizedFrameCalibrated) != 0;
+
+    const QuantizedSteps steps = {
+        Load<float>(data + quantized_header::kPositionStep),
+        Load<float>(data + quantized_header::kVelocityStep),
+        Load<float>(data + quantized_header::kAngularVelocityStep),
+    };
+    TrackerPoseArrays& poses = frame.poses;
+    const uint8_t* records = data + header_size;
+
+    if (is_keyframe) {
+        for (size_t i = 0; i < count; i++) {
+            DecodeQuantizedRecord(records + i * record_size, steps, frame.timestamp_us, poses, i);
+        }
+        frame.tracker_count = static_cast<uint32_t>(count);
+        keyframe_decoded_ = true;
+        return Result::Ok;
+    }
+
+    // Start from the keyframe; trackers the sender left out have not moved
+    // since, so only their timestamp advances
+    keyframe->last_used = ++use_counter_;
+    size_t tracker_count = keyframe->tracker_count;
+    poses = keyframe->poses;
+    for (size_t i = 0; i < tracker_count; i++) {
+        poses.timestamp_us[i] = frame.timestamp_us;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        const uint8_t* record = records + i * record_size;
+        const uint32_t tracker_id = record[quantized_record::kTrackerId];
+        size_t index = 0;
+        while (index < tracker_count && poses.tracker_id[index] != tracker_id) {
+            index++;
+        }
+        if (index == tracker_count) {
+            if (tracker_count == kMaxTrackersPerFrame) {
+                return Result::TooManyTrackers;
+            }
+            tracker_count++;
+        }
+        DecodeQuantizedRecord(record, steps, frame.timestamp_us, poses, index);
+    }
+    frame.tracker_count = static_cast<uint32_t>(tracker_count);
+    return Result::Ok;
+}
+
+TrackerFrameDecoder::Keyframe* TrackerFrameDecoder::FindKeyframe(uint32_t source_id) {
+    for (Keyframe& keyframe : keyframes_) {
+        if (keyframe.in_use && keyframe.source_id == source_id) {
+            return &keyframe;
+        }
+    }
+    return nullptr;
+}
+
+TrackerFrameDecoder::Keyframe& TrackerFrameDecoder::ClaimKeyframe(uint32_t source_id) {
+    // A free entry, else the least recently used
+    Keyframe* claimed = &keyframes_[0];
+    for (Keyframe& keyframe : keyframes_) {
+        if (!keyframe.in_use) {
+            claimed = &keyframe;
+            break;
+        }
+        if (keyframe.last_used < claimed->last_used) {
+            claimed = &keyframe;
+        }
+    }
+    claimed->in_use = true;
+    claimed->source_id = source_id;
+    return *claimed;
+}
+
+} // namespace yolovr
@@ -0,0 +1,85 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "tracker_frame_snapshot.h"
+
+namespace yolovr {
+
+// Decodes tracker frame datagrams straight into a TrackerFrameSnapshot.
+//
+// Three wire formats are accepted and told apart by the leading magic bytes:
+// the compact fixed-layout binary format and the quantized keyframe/delta
+// format (both in tracker_wire_format.h), and a serialized yolovr::TrackerFrame.
+//
+// Quantized delta frames are rebuilt on top of the newest keyframe of their
+// source, which the decoder keeps for up to kMaxKeyframeSources sources (the
+// least recently used one is replaced). A decoded keyframe is only kept once
+// CommitKeyframe() says it passed sequencing. One decoder therefore has to
+// see all datagrams of a source; the receiver keeps one per receive thread.
+//
+// The protobuf wire format is walked with CodedInputStream instead of
+// materializing a TrackerFrame: the generated Clear() frees every nested
+// message and long strings are heap-allocated even on an arena, so a reused
+// message still allocates per frame. This path performs no heap allocations
+// and only needs the protobuf lite runtime. Fields the driver does not use
+// (tracker_name, hmd_pose, system_name) and unknown fields are skipped.
+class TrackerFrameDecoder {
+public:
+    enum class Result {
+        Ok,
+        ParseError,
+        TooManyTrackers,
+        UnsupportedVersion,
+        MissingKeyframe,    // Quantized delta frame whose keyframe is not the one held for its source
+    };
+
+    static constexpr size_t kMaxKeyframeSources = 8;
+
+    TrackerFrameDecoder();
+
+    Result Decode(const uint8_t* data, size_t size, TrackerFrameSnapshot& frame);
+
+    // Keep the keyframe the last Decode() call wrote into frame, once the
+    // sequencer accepted it, so a late or duplicate keyframe cannot replace a
+    // newer one and strand the deltas built on it. Does nothing if that frame
+    // was not a quantized keyframe.
+    void CommitKeyframe(const TrackerFrameSnapshot& frame);
+
+    // Forget every keyframe held
+    void Reset();
+
+    static bool IsBinaryFrame(const uint8_t* data, size_t size);
+    static bool IsQuantizedFrame(const uint8_t* data, size_t size);
+    static bool IsQuantizedKeyframe(const uint8_t* data, size_t size);
+
+    // source_id and frame_id of a frame without decoding its trackers, for
+    // sequencing datagrams the receiver skips. False if they cannot be read;
+    // Decode() may still reject a frame this accepts.
+    static bool PeekFrameId(const uint8_t* data, size_t size, uint32_t& source_id, uint64_t& frame_id);
+
+private:
+    struct Keyframe {
+        bool in_use;
+        uint32_t source_id;
+        uint64_t keyframe_id;
+        uint64_t last_used;
+        uint32_t tracker_count;
+        TrackerPoseArrays poses;
+    };
+
+    Result DecodeBinary(const uint8_t* data, size_t size, TrackerFrameSnapshot& frame) const;
+    Result DecodeProtobuf(const uint8_t* data, size_t size, TrackerFrameSnapshot& frame) const;
+    Result DecodeQuantized(const uint8_t* data, size_t size, TrackerFrameSnapshot& frame);
+
+    Keyframe* FindKeyframe(uint32_t source_id);
+    Keyframe& ClaimKeyframe(uint32_t source_id);
+
+    Keyframe keyframes_[kMaxKeyframeSources];
+    uint64_t use_counter_;
+    bool keyframe_decoded_;     // The last Decode() was of a keyframe, not yet committed
+};
+
+} // namespace yolovr
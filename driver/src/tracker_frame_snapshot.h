@@ -0,0 +1,83 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace yolovr {
+
+// Upper bound on trackers accepted in a single frame
+constexpr size_t kMaxTrackersPerFrame = 32;
+
+// Plain-old-data copy of a yolovr::TrackerPose. Safe to copy without allocating.
+struct TrackerPoseSnapshot {
+    uint32_t tracker_id;
+    bool is_tracking;
+    bool has_velocity;
+    bool has_angular_velocity;
+    float confidence;
+    uint64_t timestamp_us;          // Sender clock, Unix microseconds
+    int64_t sample_time_ns;         // steady_clock time the pose was sampled, see TrackerPoseArrays
+
+    float position[3];              // x, y, z (meters)
+    float rotation[4];              // x, y, z, w
+    float velocity[3];              // m/s
+    float angular_velocity[3];      // rad/s
+};
+
+// Structure-of-arrays storage for every tracker in a frame. Index i is the i-th
+// tracker in the frame (not the tracker_id). Vector components are stored one
+// array per axis, e.g. position[1][i] is the y position of tracker i, so
+// per-channel loops over all trackers are contiguous and vectorize.
+struct TrackerPoseArrays {
+    uint32_t tracker_id[kMaxTrackersPerFrame];
+    uint8_t is_tracking[kMaxTrackersPerFrame];
+    uint8_t has_velocity[kMaxTrackersPerFrame];
+    uint8_t has_angular_velocity[kMaxTrackersPerFrame];
+    float confidence[kMaxTrackersPerFrame];
+    uint64_t timestamp_us[kMaxTrackersPerFrame];
+
+    // timestamp_us in driver time, set by the receiver: mapped through clock
+    // sync when the sender answers pings, else the frame's arrival time
+    int64_t sample_time_ns[kMaxTrackersPerFrame];
+
+    alignas(32) float position[3][kMaxTrackersPerFrame];
+    alignas(32) float rotation[4][kMaxTrackersPerFrame];    // x, y, z, w
+    alignas(32) float velocity[3][kMaxTrackersPerFrame];
+    alignas(32) float angular_velocity[3][kMaxTrackersPerFrame];
+
+    // Gather tracker i into a single pose
+    void GetPose(size_t i, TrackerPoseSnapshot& pose) const {
+        pose.tracker_id = tracker_id[i];
+        pose.is_tracking = is_tracking[i] != 0;
+        pose.has_velocity = has_velocity[i] != 0;
+        pose.has_angular_velocity = has_angular_velocity[i] != 0;
+        pose.confidence = confidence[i];
+        pose.timestamp_us = timestamp_us[i];
+        pose.sample_time_ns = sample_time_ns[i];
+        for (int axis = 0; axis < 3; axis++) {
+            pose.position[axis] = position[axis][i];
+            pose.velocity[axis] = velocity[axis][i];
+            pose.angular_velocity[axis] = angular_velocity[axis][i];
+        }
+        for (int axis = 0; axis < 4; axis++) {
+            pose.rotation[axis] = rotation[axis][i];
+        }
+    }
+};
+
+// Plain-old-data copy of a yolovr::TrackerFrame, as published by TrackerDataReceiver.
+struct TrackerFrameSnapshot {
+    uint64_t frame_id;
+    uint64_t timestamp_us;          // Sender clock, Unix microseconds
+    uint32_t source_id;
+    bool is_calibrated;
+    float system_fps;
+    int64_t arrival_time_ns;        // steady_clock time the kernel received the frame, or the receiver woke up for it
+    int64_t parsed_time_ns;         // steady_clock time the frame was decoded
+
+    uint32_t tracker_count;
+    TrackerPoseArrays poses;
+};
+
+} // namespace yolovr
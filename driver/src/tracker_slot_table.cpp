@@ -0,0 +1,75 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+#include "tracker_slot_table.h"
+
+#include <cstring>
+
+namespace yolovr {
+
+static_assert(kMaxTrackerSlots <= 64, "present_mask_ and ever_seen_mask_ hold one bit per slot");
+
+TrackerSlotTable::TrackerSlotTable() {
+    Reset();
+}
+
+void TrackerSlotTable::Reset() {
+    std::memset(shadow_, 0, sizeof(shadow_));
+    present_mask_ = 0;
+    ever_seen_mask_.store(0, std::memory_order_release);
+    for (size_t id = 0; id < kMaxTrackerSlots; id++) {
+        slots_[id].Store(shadow_[id]);
+    }
+}
+
+void TrackerSlotTable::Demux(const TrackerFrameSnapshot& frame) {
+    const TrackerPoseArrays& poses = frame.poses;
+    uint64_t seen_mask = 0;
+
+    for (uint32_t i = 0; i < frame.tracker_count; i++) {
+        const uint32_t id = poses.tracker_id[i];
+        if (id >= kMaxTrackerSlots) {
+            continue;
+        }
+        const uint64_t bit = uint64_t(1) << id;
+        if (seen_mask & bit) {
+            continue; // Duplicate id in one frame: the first entry wins
+        }
+        seen_mask |= bit;
+
+        TrackerSlot& slot = shadow_[id];
+        slot.last_seen_time_ns = frame.arrival_time_ns;
+        slot.source_id = frame.source_id;
+        slot.is_tracking = poses.is_tracking[i] != 0;
+        if (slot.is_tracking) {
+            poses.GetPose(i, slot.pose);
+            slot.pose_arrival_time_ns = frame.arrival_time_ns;
+            slot.frame_id = frame.frame_id;
+            slot.has_pose = true;
+        }
+        slots_[id].Store(slot);
+    }
+
+    // Trackers that dropped out of the frame stop tracking but keep their last pose
+    const uint64_t missing_mask = present_mask_ & ~seen_mask;
+    for (size_t id = 0; missing_mask && id < kMaxTrackerSlots; id++) {
+        if (missing_mask & (uint64_t(1) << id)) {
+            shadow_[id].is_tracking = false;
+            slots_[id].Store(shadow_[id]);
+        }
+    }
+    present_mask_ = seen_mask;
+
+    const uint64_t ever_seen_mask = ever_seen_mask_.load(std::memory_order_relaxed);
+    if (seen_mask & ~ever_seen_mask) {
+        ever_seen_mask_.store(ever_seen_mask | seen_mask, std::memory_order_release);
+    }
+}
+
+bool TrackerSlotTable::Read(uint32_t tracker_id, TrackerSlot& slot) const {
+    if (tracker_id >= kMaxTrackerSlots) {
+        return false;
+    }
+    slots_[tracker_id].Load(slot);
+    return slot.has_pose;
+}
+
+} // namespace yolovr
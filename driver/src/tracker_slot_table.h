@@ -0,0 +1,64 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "seqlock.h"
+#include "tracker_frame_snapshot.h"
+
+namespace yolovr {
+
+// Number of tracker_ids with a slot; higher ids in a frame are ignored
+constexpr size_t kMaxTrackerSlots = kMaxTrackersPerFrame;
+
+// Everything a device needs to know about its tracker, as of the newest frame
+struct TrackerSlot {
+    TrackerPoseSnapshot pose;       // Last pose received while tracking
+    int64_t pose_arrival_time_ns;   // steady_clock arrival of the frame pose came from
+    int64_t last_seen_time_ns;      // steady_clock arrival of the newest frame carrying this tracker
+    uint64_t frame_id;              // Frame pose came from
+    uint32_t source_id;
+    bool has_pose;                  // pose holds a valid pose
+    bool is_tracking;               // The newest frame had this tracker, tracking
+};
+
+// Per-tracker_id view of the incoming frames.
+//
+// Demux() walks a frame once and publishes each tracker's pose into the slot
+// for its tracker_id; each slot is its own cache-aligned SeqLock, so a device
+// reads its slot without locks and without contending with other devices. A
+// slot keeps the last pose received while tracking when the tracker is lost
+// or missing from later frames.
+//
+// Demux() and Reset() must only be called from one thread (the pose publisher).
+class TrackerSlotTable {
+public:
+    TrackerSlotTable();
+
+    TrackerSlotTable(const TrackerSlotTable&) = delete;
+    TrackerSlotTable& operator=(const TrackerSlotTable&) = delete;
+
+    void Demux(const TrackerFrameSnapshot& frame);
+
+    // Copy the slot for tracker_id. Returns false if the id has no slot or the
+    // tracker has never been received while tracking.
+    bool Read(uint32_t tracker_id, TrackerSlot& slot) const;
+
+    // Bit per tracker_id that has appeared in any frame since Reset(). Any thread.
+    uint64_t SeenMask() const { return ever_seen_mask_.load(std::memory_order_acquire); }
+
+    // Clear every slot
+    void Reset();
+
+private:
+    SeqLock<TrackerSlot> slots_[kMaxTrackerSlots];
+
+    // Writer-side copy of each slot, so Demux never reads back through the SeqLock
+    TrackerSlot shadow_[kMaxTrackerSlots];
+    uint64_t present_mask_;                     // Slots in the previous frame
+    std::atomic<uint64_t> ever_seen_mask_;      // Slots in any frame so far
+};
+
+} // namespace yolovr
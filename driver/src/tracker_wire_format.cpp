@@ -0,0 +1,261 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+#include "tracker_wire_format.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace yolovr {
+
+namespace {
+
+template <typename T>
+void Store(uint8_t* data, T value) {
+    std::memcpy(data, &value, sizeof(T));
+}
+
+template <typename T>
+T Load(const uint8_t* data) {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+constexpr float kSqrtHalf = 0.70710678f;
+constexpr uint32_t kQuaternionComponentMax = 1023;
+
+bool IsClockSyncMessage(const uint8_t* data, size_t size, const uint8_t (&magic)[4], size_t message_size) {
+    return size >= message_size && std::memcmp(data, magic, sizeof(magic)) == 0 &&
+        Load<uint16_t>(data + clock_sync_message::kVersion) == kClockSyncVersion &&
+        Load<uint16_t>(data + clock_sync_message::kSize) >= message_size;
+}
+
+void StoreClockSyncHeader(const uint8_t (&magic)[4], size_t message_size, const ClockPing& ping, uint8_t* out) {
+    std::memcpy(out + clock_sync_message::kMagic, magic, sizeof(magic));
+    Store<uint16_t>(out + clock_sync_message::kVersion, kClockSyncVersion);
+    Store<uint16_t>(out + clock_sync_message::kSize, static_cast<uint16_t>(message_size));
+    Store<uint32_t>(out + clock_sync_message::kSourceId, ping.source_id);
+    Store<uint32_t>(out + clock_sync_message::kSequence, ping.sequence);
+    Store<int64_t>(out + clock_sync_message::kOriginTime, ping.origin_time_ns);
+}
+
+void LoadClockSyncHeader(const uint8_t* data, ClockPing& ping) {
+    ping.source_id = Load<uint32_t>(data + clock_sync_message::kSourceId);
+    ping.sequence = Load<uint32_t>(data + clock_sync_message::kSequence);
+    ping.origin_time_ns = Load<int64_t>(data + clock_sync_message::kOriginTime);
+}
+
+// value / step rounded into an int16, saturating at the ends of the range
+int16_t Quantize(float value, float step) {
+    if (!(step > 0.0f)) {
+        return 0;
+    }
+    const float units = std::round(value / step);
+    if (std::isnan(units)) {
+        return 0;
+    }
+    if (units <= -32767.0f) {
+        return -32767;
+    }
+    return units < 32767.0f ? static_cast<int16_t>(units) : 32767;
+}
+
+uint8_t QuantizeConfidence(float confidence) {
+    if (!(confidence > 0.0f)) {
+        return 0;
+    }
+    return confidence < 1.0f ? static_cast<uint8_t>(std::lround(confidence * 255.0f)) : 255;
+}
+
+} // namespace
+
+size_t EncodeBinaryFrame(const TrackerFrameSnapshot& frame, uint8_t* out, size_t capacity) {
+    const size_t count = frame.tracker_count;
+    const size_t size = BinaryFrameSize(count);
+    if (count > kMaxTrackersPerFrame || capacity < size) {
+        return 0;
+    }
+
+    std::memcpy(out + binary_header::kMagic, kBinaryMagic, sizeof(kBinaryMagic));
+    Store<uint16_t>(out + binary_header::kVersion, kBinaryFormatVersion);
+    Store<uint16_t>(out + binary_header::kHeaderSize, static_cast<uint16_t>(kBinaryHeaderSize));
+    Store<uint64_t>(out + binary_header::kFrameId, frame.frame_id);
+    Store<uint64_t>(out + binary_header::kTimestamp, frame.timestamp_us);
+    Store<uint32_t>(out + binary_header::kSourceId, frame.source_id);
+    Store<uint16_t>(out + binary_header::kTrackerCount, static_cast<uint16_t>(count));
+    Store<uint16_t>(out + binary_header::kRecordSize, static_cast<uint16_t>(kBinaryRecordSize));
+    Store<float>(out + binary_header::kSystemFps, frame.system_fps);
+    Store<uint32_t>(out + binary_header::kFlags, frame.is_calibrated ? kBinaryFrameCalibrated : 0u);
+
+    const TrackerPoseArrays& poses = frame.poses;
+    for (size_t i = 0; i < count; i++) {
+        uint8_t* record = out + kBinaryHeaderSize + i * kBinaryRecordSize;
+        uint16_t flags = 0;
+        flags |= poses.is_tracking[i] ? kBinaryTracking : 0;
+        flags |= poses.has_velocity[i] ? kBinaryHasVelocity : 0;
+        flags |= poses.has_angular_velocity[i] ? kBinaryHasAngularVelocity : 0;
+
+        Store<uint16_t>(record + binary_record::kTrackerId, static_cast<uint16_t>(poses.tracker_id[i]));
+        Store<uint16_t>(record + binary_record::kFlags, flags);
+        Store<float>(record + binary_record::kConfidence, poses.confidence[i]);
+        for (size_t axis = 0; axis < 3; axis++) {
+            Store<float>(record + binary_record::kPosition + axis * sizeof(float), poses.position[axis][i]);
+            Store<float>(record + binary_record::kVelocity + axis * sizeof(float), poses.velocity[axis][i]);
+            Store<float>(record + binary_record::kAngularVelocity + axis * sizeof(float), poses.angular_velocity[axis][i]);
+        }
+        for (size_t axis = 0; axis < 4; axis++) {
+            Store<float>(record + binary_record::kRotation + axis * sizeof(float), poses.rotation[axis][i]);
+        }
+        Store<int32_t>(record + binary_record::kTimestampOffset,
+                       static_cast<int32_t>(static_cast<int64_t>(poses.timestamp_us[i] - frame.timestamp_us)));
+    }
+    return size;
+}
+
+size_t EncodeQuantizedFrame(const TrackerFrameSnapshot& frame, uint64_t keyframe_id, const QuantizationSteps& steps,
+                            uint8_t* out, size_t capacity) {
+    const size_t count = frame.tracker_count;
+    const size_t size = QuantizedFrameSize(count);
+    if (count > kMaxTrackersPerFrame || capacity < size) {
+        return 0;
+    }
+
+    uint32_t frame_flags = frame.is_calibrated ? kQuantizedFrameCalibrated : 0u;
+    frame_flags |= keyframe_id == frame.frame_id ? kQuantizedKeyframe : 0u;
+
+    std::memcpy(out + quantized_header::kMagic, kQuantizedMagic, sizeof(kQuantizedMagic));
+    Store<uint16_t>(out + quantized_header::kVersion, kQuantizedFormatVersion);
+    Store<uint16_t>(out + quantized_header::kHeaderSize, static_cast<uint16_t>(kQuantizedHeaderSize));
+    Store<uint64_t>(out + quantized_header::kFrameId, frame.frame_id);
+    Store<uint64_t>(out + quantized_header::kTimestamp, frame.timestamp_us);
+    Store<uint64_t>(out + quantized_header::kKeyframeId, keyframe_id);
+    Store<uint32_t>(out + quantized_header::kSourceId, frame.source_id);
+    Store<uint16_t>(out + quantized_header::kTrackerCount, static_cast<uint16_t>(count));
+    Store<uint16_t>(out + quantized_header::kRecordSize, static_cast<uint16_t>(kQuantizedRecordSize));
+    Store<float>(out + quantized_header::kSystemFps, frame.system_fps);
+    Store<uint32_t>(out + quantized_header::kFlags, frame_flags);
+    Store<float>(out + quantized_header::kPositionStep, steps.position);
+    Store<float>(out + quantized_header::kVelocityStep, steps.velocity);
+    Store<float>(out + quantized_header::kAngularVelocityStep, steps.angular_velocity);
+
+    const TrackerPoseArrays& poses = frame.poses;
+    for (size_t i = 0; i < count; i++) {
+        uint8_t* record = out + kQuantizedHeaderSize + i * kQuantizedRecordSize;
+        uint8_t flags = 0;
+        flags |= poses.is_tracking[i] ? kBinaryTracking : 0;
+        flags |= poses.has_velocity[i] ? kBinaryHasVelocity : 0;
+        flags |= poses.has_angular_velocity[i] ? kBinaryHasAngularVelocity : 0;
+
+        record[quantized_record::kTrackerId] = static_cast<uint8_t>(poses.tracker_id[i]);
+        record[quantized_record::kFlags] = flags;
+        record[quantized_record::kConfidence] = QuantizeConfidence(poses.confidence[i]);
+        record[quantized_record::kReserved] = 0;
+        Store<uint32_t>(record + quantized_record::kRotation,
+                        PackQuaternion(poses.rotation[0][i], poses.rotation[1][i], poses.rotation[2][i], poses.rotation[3][i]));
+        for (size_t axis = 0; axis < 3; axis++) {
+            Store<int16_t>(record + quantized_record::kPosition + axis * sizeof(int16_t),
+                           Quantize(poses.position[axis][i], steps.position));
+            Store<int16_t>(record + quantized_record::kVelocity + axis * sizeof(int16_t),
+                           Quantize(poses.velocity[axis][i], steps.velocity));
+            Store<int16_t>(record + quantized_record::kAngularVelocity + axis * sizeof(int16_t),
+                           Quantize(poses.angular_velocity[axis][i], steps.angular_velocity));
+        }
+        Store<int32_t>(record + quantized_record::kTimestampOffset,
+                       static_cast<int32_t>(static_cast<int64_t>(poses.timestamp_us[i] - frame.timestamp_us)));
+    }
+    return size;
+}
+
+uint32_t PackQuaternion(float x, float y, float z, float w) {
+    const float q[4] = { x, y, z, w };
+    uint32_t largest = 0;
+    for (uint32_t axis = 1; axis < 4; axis++) {
+        if (std::fabs(q[axis]) > std::fabs(q[largest])) {
+            largest = axis;
+        }
+    }
+
+    // q and -q are the same rotation; flip so the dropped component is positive
+    const float sign = q[largest] < 0.0f ? -1.0f : 1.0f;
+    uint32_t packed = largest << 30;
+    int shift = 20;
+    for (uint32_t axis = 0; axis < 4; axis++) {
+        if (axis == largest) {
+            continue;
+        }
+        float unit = (sign * q[axis] / kSqrtHalf + 1.0f) * 0.5f;
+        unit = unit < 0.0f ? 0.0f : (unit > 1.0f ? 1.0f : unit);
+        packed |= static_cast<uint32_t>(std::lround(unit * kQuaternionComponentMax)) << shift;
+        shift -= 10;
+    }
+    return packed;
+}
+
+void UnpackQuaternion(uint32_t packed, float rotation[4]) {
+    const uint32_t largest = packed >> 30;
+    float sum = 0.0f;
+    int shift = 20;
+    for (uint32_t axis = 0; axis < 4; axis++) {
+        if (axis == largest) {
+            continue;
+        }
+        const uint32_t units = (packed >> shift) & kQuaternionComponentMax;
+        rotation[axis] = (units * (2.0f / kQuaternionComponentMax) - 1.0f) * kSqrtHalf;
+        sum += rotation[axis] * rotation[axis];
+        shift -= 10;
+    }
+    rotation[largest] = sum < 1.0f ? std::sqrt(1.0f - sum) : 0.0f;
+
+    // Rounding can leave the three small components slightly too long
+    if (sum > 1.0f) {
+        const float scale = 1.0f / std::sqrt(sum);
+        for (uint32_t axis = 0; axis < 4; axis++) {
+            rotation[axis] *= scale;
+        }
+    }
+}
+
+bool IsClockPing(const uint8_t* data, size_t size) {
+    return size >= 4 && std::memcmp(data, kClockPingMagic, sizeof(kClockPingMagic)) == 0;
+}
+
+bool IsClockPong(const uint8_t* data, size_t size) {
+    return size >= 4 && std::memcmp(data, kClockPongMagic, sizeof(kClockPongMagic)) == 0;
+}
+
+size_t EncodeClockPing(const ClockPing& ping, uint8_t* out, size_t capacity) {
+    if (capacity < kClockPingSize) {
+        return 0;
+    }
+    StoreClockSyncHeader(kClockPingMagic, kClockPingSize, ping, out);
+    return kClockPingSize;
+}
+
+size_t EncodeClockPong(const ClockPong& pong, uint8_t* out, size_t capacity) {
+    if (capacity < kClockPongSize) {
+        return 0;
+    }
+    StoreClockSyncHeader(kClockPongMagic, kClockPongSize, pong.ping, out);
+    Store<uint64_t>(out + clock_sync_message::kReceiveTime, pong.receive_time_us);
+    Store<uint64_t>(out + clock_sync_message::kTransmitTime, pong.transmit_time_us);
+    return kClockPongSize;
+}
+
+bool DecodeClockPing(const uint8_t* data, size_t size, ClockPing& ping) {
+    if (!IsClockSyncMessage(data, size, kClockPingMagic, kClockPingSize)) {
+        return false;
+    }
+    LoadClockSyncHeader(data, ping);
+    return true;
+}
+
+bool DecodeClockPong(const uint8_t* data, size_t size, ClockPong& pong) {
+    if (!IsClockSyncMessage(data, size, kClockPongMagic, kClockPongSize)) {
+        return false;
+    }
+    LoadClockSyncHeader(data, pong.ping);
+    pong.receive_time_us = Load<uint64_t>(data + clock_sync_message::kReceiveTime);
+    pong.transmit_time_us = Load<uint64_t>(data + clock_sync_message::kTransmitTime);
+    return true;
+}
+
+} // namespace yolovr
@@ -0,0 +1,266 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "tracker_frame_snapshot.h"
+
+namespace yolovr {
+
+// Compact fixed-layout binary frame format, an alternative to the protobuf
+// TrackerFrame for low-latency senders. TrackerDataReceiver tells the two apart
+// by the magic bytes at the start of the datagram.
+//
+// All fields are little-endian; offsets are in bytes.
+//
+// Frame header (kBinaryHeaderSize bytes):
+//   0  char[4]  magic "YVRB"
+//   4  uint16   version (kBinaryFormatVersion)
+//   6  uint16   header_size - offset of the first record
+//   8  uint64   frame_id
+//   16 uint64   timestamp, sender clock, Unix microseconds
+//   24 uint32   source_id
+//   28 uint16   tracker_count
+//   30 uint16   record_size - stride between records
+//   32 float    system_fps
+//   36 uint32   frame flags (kBinaryFrameCalibrated)
+//
+// Tracker record (kBinaryRecordSize bytes), tracker_count of them:
+//   0  uint16   tracker_id
+//   2  uint16   record flags (kBinaryTracking, kBinaryHasVelocity, kBinaryHasAngularVelocity)
+//   4  float    confidence
+//   8  float[3] position x, y, z (meters)
+//   20 float[4] rotation x, y, z, w
+//   36 float[3] velocity (m/s)
+//   48 float[3] angular velocity (rad/s)
+//   60 int32    pose timestamp minus frame timestamp (microseconds)
+//
+// Newer versions may only grow header_size and record_size; readers use the
+// sizes from the header and ignore trailing bytes they do not understand.
+
+constexpr uint8_t kBinaryMagic[4] = { 'Y', 'V', 'R', 'B' };
+constexpr uint16_t kBinaryFormatVersion = 1;
+
+constexpr size_t kBinaryHeaderSize = 40;
+constexpr size_t kBinaryRecordSize = 64;
+
+constexpr uint32_t kBinaryFrameCalibrated = 1u << 0;
+
+constexpr uint16_t kBinaryTracking = 1u << 0;
+constexpr uint16_t kBinaryHasVelocity = 1u << 1;
+constexpr uint16_t kBinaryHasAngularVelocity = 1u << 2;
+
+namespace binary_header {
+constexpr size_t kMagic = 0;
+constexpr size_t kVersion = 4;
+constexpr size_t kHeaderSize = 6;
+constexpr size_t kFrameId = 8;
+constexpr size_t kTimestamp = 16;
+constexpr size_t kSourceId = 24;
+constexpr size_t kTrackerCount = 28;
+constexpr size_t kRecordSize = 30;
+constexpr size_t kSystemFps = 32;
+constexpr size_t kFlags = 36;
+} // namespace binary_header
+
+namespace binary_record {
+constexpr size_t kTrackerId = 0;
+constexpr size_t kFlags = 2;
+constexpr size_t kConfidence = 4;
+constexpr size_t kPosition = 8;
+constexpr size_t kRotation = 20;
+constexpr size_t kVelocity = 36;
+constexpr size_t kAngularVelocity = 48;
+constexpr size_t kTimestampOffset = 60;
+} // namespace binary_record
+
+// Size of an encoded binary frame carrying tracker_count trackers
+constexpr size_t BinaryFrameSize(size_t tracker_count) {
+    return kBinaryHeaderSize + tracker_count * kBinaryRecordSize;
+}
+
+// Encode a frame in the binary format. Returns the number of bytes written,
+// or 0 if out is smaller than BinaryFrameSize(frame.tracker_count).
+size_t EncodeBinaryFrame(const TrackerFrameSnapshot& frame, uint8_t* out, size_t capacity);
+
+// Quantized keyframe/delta format, for links where bandwidth or airtime is
+// scarce (e.g. Wi-Fi from a separate inference machine). Same conventions as
+// the binary format: little-endian, sizes taken from the header.
+//
+// A keyframe carries every tracker. A delta frame carries only the trackers
+// whose pose moved past the sender's thresholds since the keyframe it names;
+// the receiver takes the others from that keyframe. Records always hold the
+// full quantized state, so a lost delta frame costs nothing, but a delta whose
+// keyframe was not received cannot be reconstructed and is dropped until the
+// next keyframe arrives. Senders send keyframes periodically to bound that.
+//
+// Frame header (kQuantizedHeaderSize bytes):
+//   0  char[4]  magic "YVRQ"
+//   4  uint16   version (kQuantizedFormatVersion)
+//   6  uint16   header_size - offset of the first record
+//   8  uint64   frame_id
+//   16 uint64   timestamp, sender clock, Unix microseconds
+//   24 uint64   keyframe_id - frame_id of the keyframe this frame builds on
+//               (its own frame_id for keyframes)
+//   32 uint32   source_id
+//   36 uint16   tracker_count - records in this datagram
+//   38 uint16   record_size - stride between records
+//   40 float    system_fps
+//   44 uint32   frame flags (kQuantizedFrameCalibrated, kQuantizedKeyframe)
+//   48 float    position step (meters per unit)
+//   52 float    velocity step (m/s per unit)
+//   56 float    angular velocity step (rad/s per unit)
+//
+// Tracker record (kQuantizedRecordSize bytes):
+//   0  uint8    tracker_id
+//   1  uint8    record flags (kBinaryTracking, kBinaryHasVelocity, kBinaryHasAngularVelocity)
+//   2  uint8    confidence * 255
+//   3  uint8    reserved, 0
+//   4  uint32   rotation, smallest three: bits 30-31 index of the dropped
+//               (largest) component, then three 10-bit components in
+//               [-1/sqrt(2), 1/sqrt(2)], highest bits first. The dropped
+//               component is made positive before packing.
+//   8  int16[3] position in position steps
+//   14 int16[3] velocity in velocity steps
+//   20 int16[3] angular velocity in angular velocity steps
+//   26 int32    pose timestamp minus frame timestamp (microseconds)
+
+constexpr uint8_t kQuantizedMagic[4] = { 'Y', 'V', 'R', 'Q' };
+constexpr uint16_t kQuantizedFormatVersion = 1;
+
+constexpr size_t kQuantizedHeaderSize = 60;
+constexpr size_t kQuantizedRecordSize = 30;
+
+constexpr uint32_t kQuantizedFrameCalibrated = 1u << 0;
+constexpr uint32_t kQuantizedKeyframe = 1u << 1;
+
+// Steps the Python client uses unless told otherwise: 1 mm (+-32 m),
+// 1 mm/s and 1 mrad/s
+constexpr float kDefaultPositionStep = 0.001f;
+constexpr float kDefaultVelocityStep = 0.001f;
+constexpr float kDefaultAngularVelocityStep = 0.001f;
+
+namespace quantized_header {
+constexpr size_t kMagic = 0;
+constexpr size_t kVersion = 4;
+constexpr size_t kHeaderSize = 6;
+constexpr size_t kFrameId = 8;
+constexpr size_t kTimestamp = 16;
+constexpr size_t kKeyframeId = 24;
+constexpr size_t kSourceId = 32;
+constexpr size_t kTrackerCount = 36;
+constexpr size_t kRecordSize = 38;
+constexpr size_t kSystemFps = 40;
+constexpr size_t kFlags = 44;
+constexpr size_t kPositionStep = 48;
+constexpr size_t kVelocityStep = 52;
+constexpr size_t kAngularVelocityStep = 56;
+} // namespace quantized_header
+
+namespace quantized_record {
+constexpr size_t kTrackerId = 0;
+constexpr size_t kFlags = 1;
+constexpr size_t kConfidence = 2;
+constexpr size_t kReserved = 3;
+constexpr size_t kRotation = 4;
+constexpr size_t kPosition = 8;
+constexpr size_t kVelocity = 14;
+constexpr size_t kAngularVelocity = 20;
+constexpr size_t kTimestampOffset = 26;
+} // namespace quantized_record
+
+struct QuantizationSteps {
+    float position = kDefaultPositionStep;
+    float velocity = kDefaultVelocityStep;
+    float angular_velocity = kDefaultAngularVelocityStep;
+};
+
+constexpr size_t QuantizedFrameSize(size_t tracker_count) {
+    return kQuantizedHeaderSize + tracker_count * kQuantizedRecordSize;
+}
+
+// Encode every tracker in frame as one quantized frame. It is a keyframe when
+// keyframe_id equals frame.frame_id; otherwise the caller has left only the
+// changed trackers in frame. Returns the number of bytes written, or 0 if out
+// is smaller than QuantizedFrameSize(frame.tracker_count).
+size_t EncodeQuantizedFrame(const TrackerFrameSnapshot& frame, uint64_t keyframe_id, const QuantizationSteps& steps,
+                            uint8_t* out, size_t capacity);
+
+// Smallest-three quaternion packing, see the record layout above. Unpacking
+// returns a unit quaternion.
+uint32_t PackQuaternion(float x, float y, float z, float w);
+void UnpackQuaternion(uint32_t packed, float rotation[4]);
+
+// Clock synchronization, NTP-style. The driver periodically sends a ping to
+// the address each source's frames come from; the sender answers with a pong
+// from the same socket, stamped with its own clock (the clock of the frame
+// timestamps). From the four times of one exchange the driver estimates the
+// offset between the sender clock and its own, and the round-trip time.
+// Senders that never answer keep working; their poses are just aged from
+// their arrival time. Same conventions as the frame formats.
+//
+// Ping (kClockPingSize bytes), driver to sender:
+//   0  char[4]  magic "YVRP"
+//   4  uint16   version (kClockSyncVersion)
+//   6  uint16   size - bytes in the ping
+//   8  uint32   source_id the ping is for
+//   12 uint32   sequence
+//   16 int64    origin time, driver clock (opaque to the sender)
+//
+// Pong (kClockPongSize bytes), sender to driver:
+//   0  char[4]  magic "YVRO"
+//   4  uint16   version (kClockSyncVersion)
+//   6  uint16   size - bytes in the pong
+//   8  uint32   source_id, sequence and origin time
+//   12 uint32       copied from the ping
+//   16 int64
+//   24 uint64   receive time - when the ping arrived, sender clock, Unix microseconds
+//   32 uint64   transmit time - when the pong was sent, same clock
+//
+// The receive time should be taken as close to the ping's arrival as
+// possible (e.g. the kernel receive timestamp): time the ping waits before
+// the sender reads it counts as round trip if it is not.
+
+constexpr uint8_t kClockPingMagic[4] = { 'Y', 'V', 'R', 'P' };
+constexpr uint8_t kClockPongMagic[4] = { 'Y', 'V', 'R', 'O' };
+constexpr uint16_t kClockSyncVersion = 1;
+
+constexpr size_t kClockPingSize = 24;
+constexpr size_t kClockPongSize = 40;
+
+namespace clock_sync_message {
+constexpr size_t kMagic = 0;
+constexpr size_t kVersion = 4;
+constexpr size_t kSize = 6;
+constexpr size_t kSourceId = 8;
+constexpr size_t kSequence = 12;
+constexpr size_t kOriginTime = 16;
+constexpr size_t kReceiveTime = 24;
+constexpr size_t kTransmitTime = 32;
+} // namespace clock_sync_message
+
+struct ClockPing {
+    uint32_t source_id;
+    uint32_t sequence;
+    int64_t origin_time_ns;
+};
+
+struct ClockPong {
+    ClockPing ping;
+    uint64_t receive_time_us;
+    uint64_t transmit_time_us;
+};
+
+bool IsClockPing(const uint8_t* data, size_t size);
+bool IsClockPong(const uint8_t* data, size_t size);
+
+// Return the number of bytes written, or 0 if out is too small
+size_t EncodeClockPing(const ClockPing& ping, uint8_t* out, size_t capacity);
+size_t EncodeClockPong(const ClockPong& pong, uint8_t* out, size_t capacity);
+
+// Return false unless data is a complete message of a version we understand
+bool DecodeClockPing(const uint8_t* data, size_t size, ClockPing& ping);
+bool DecodeClockPong(const uint8_t* data, size_t size, ClockPong& pong);
+
+} // namespace yolovr
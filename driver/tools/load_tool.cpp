@@ -0,0 +1,709 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+// Load generator and soak harness for the receive path. Simulated sources send
+// tracker frames over loopback UDP to a TrackerDataReceiver in this process,
+// and a publisher thread consumes them the way PosePublisher does (fusion,
+// smoothing filter, slot table demux).
+//
+//   yolovr_load [--sources 4] [--trackers 12] [--rate 90] [--duration 10]
+//               [--format binary|protobuf] [--burst 1] [--malformed 0] [--reorder 0] [--oversize 0]
+//               [--threads 1] [--shards 1] [--batch 0] [--rcvbuf 0]
+//               [--low-latency 0] [--receiver-cpu -1]
+//               [--port 19999] [--report 5] [--seed 1]
+//
+// --rate is per source, so the aggregate rate is sources x rate; tens of kHz
+// need a few --threads. --burst sends a source's frames that many at a time,
+// back to back, so batch receive drains several per sender and parses only
+// the newest. --malformed, --reorder and --oversize are the fraction
+// of datagrams sent corrupted, swapped with the following frame of the same
+// source, or with more trackers than a frame may carry. --duration 0 runs
+// until interrupted. --low-latency 1 receives in low latency mode with the
+// driver's defaults (see LowLatencySettings), pinned to --receiver-cpu.
+//
+// Every --report seconds, and once more at the end, it prints the send and
+// publish rates, how many valid frames did not make it (kernel drops,
+// sequencing losses), receiver plus publisher CPU time per received frame,
+// latency percentiles from the kernel receiving a datagram, and from the
+// sender, to the frame being demultiplexed, and the receiver's mean
+// kernel-arrival-to-wakeup and wakeup-to-parse times. It exits with status 3
+// if the receiver counted frames as lost although the kernel dropped none and
+// every send succeeded: frames skipped by drain-to-latest, rejected or
+// reordered must not show up as losses.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#include <time.h>
+#endif
+
+#include "latency_histogram.h"
+#include "pose_filter_bank.h"
+#include "source_fusion.h"
+#include "tracker_data.pb.h"
+#include "tracker_data_receiver.h"
+#include "tracker_slot_table.h"
+#include "tracker_wire_format.h"
+
+// The driver logs through vrserver; print to stderr instead
+void DriverLog(const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    std::vfprintf(stderr, format, args);
+    std::fputc('\n', stderr);
+    va_end(args);
+}
+
+namespace {
+
+std::atomic<bool> g_interrupted(false);
+
+void OnInterrupt(int) {
+    g_interrupted.store(true);
+}
+
+int64_t SteadyNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int64_t UnixNowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// CPU time of the whole process and of the calling thread
+int64_t ProcessCpuNs() {
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user);
+    ULARGE_INTEGER k, u;
+    k.LowPart = kernel.dwLowDateTime;
+    k.HighPart = kernel.dwHighDateTime;
+    u.LowPart = user.dwLowDateTime;
+    u.HighPart = user.dwHighDateTime;
+    return static_cast<int64_t>(k.QuadPart + u.QuadPart) * 100;
+#else
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return (static_cast<int64_t>(usage.ru_utime.tv_sec) + usage.ru_stime.tv_sec) * 1000000000 +
+           (static_cast<int64_t>(usage.ru_utime.tv_usec) + usage.ru_stime.tv_usec) * 1000;
+#endif
+}
+
+int64_t ThreadCpuNs() {
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user);
+    ULARGE_INTEGER k, u;
+    k.LowPart = kernel.dwLowDateTime;
+    k.HighPart = kernel.dwHighDateTime;
+    u.LowPart = user.dwLowDateTime;
+    u.HighPart = user.dwHighDateTime;
+    return static_cast<int64_t>(k.QuadPart + u.QuadPart) * 100;
+#else
+    timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return static_cast<int64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+#endif
+}
+
+enum class Format { Binary, Protobuf };
+
+struct Options {
+    int sources = 4;
+    int trackers = 12;
+    double rate_hz = 90.0;
+    double duration_s = 10.0;
+    Format format = Format::Binary;
+    int burst = 1;
+    double malformed = 0.0;
+    double reorder = 0.0;
+    double oversize = 0.0;
+    int threads = 1;
+    int shards = 1;
+    bool batch = false;
+    int receive_buffer_bytes = 0;
+    bool low_latency = false;
+    int receiver_cpu = -1;
+    uint16_t port = 19999;
+    double report_interval_s = 5.0;
+    uint32_t seed = 1;
+};
+
+// Trackers sent in an oversized frame, above kMaxTrackersPerFrame
+constexpr int kOversizeTrackers = static_cast<int>(yolovr::kMaxTrackersPerFrame) + 16;
+
+// What the sender threads did, written by one sender thread each
+struct alignas(64) SenderCounters {
+    std::atomic<uint64_t> valid{0};         // Well-formed frames sent in order
+    std::atomic<uint64_t> reordered{0};     // Well-formed frames sent after their successor
+    std::atomic<uint64_t> malformed{0};
+    std::atomic<uint64_t> oversized{0};
+    std::atomic<uint64_t> send_errors{0};
+    std::atomic<int64_t> cpu_ns{0};
+};
+
+void Add(std::atomic<uint64_t>& counter, uint64_t n = 1) {
+    counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+// One simulated tracking system with its own socket, frame_id sequence and
+// motion phase
+class SimulatedSource {
+public:
+    SimulatedSource(uint32_t source_id, const Options& options)
+        : source_id_(source_id)
+        , options_(options)
+        , socket_(socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP))
+        , random_(options.seed * 7919u + source_id)
+        , frame_id_(0)
+        , interval_ns_(static_cast<int64_t>(1e9 * options.burst / options.rate_hz))
+        , next_due_ns_(0)
+        , frame_{}
+    {
+        std::memset(&destination_, 0, sizeof(destination_));
+        destination_.sin_family = AF_INET;
+        destination_.sin_port = htons(options.port);
+        inet_pton(AF_INET, "127.0.0.1", &destination_.sin_addr);
+        datagram_.resize(yolovr::BinaryFrameSize(kOversizeTrackers) + 64);
+        held_.resize(datagram_.size());
+    }
+
+    ~SimulatedSource() {
+        if (socket_ != INVALID_SOCKET_VALUE) {
+            closesocket(socket_);
+        }
+    }
+
+    bool IsOpen() const { return socket_ != INVALID_SOCKET_VALUE; }
+
+    void Schedule(int64_t start_ns) { next_due_ns_ = start_ns + interval_ns_ * source_id_ / (options_.sources + 1); }
+    int64_t NextDueNs() const { return next_due_ns_; }
+
+    // Send the frames that are due and schedule the next ones
+    void SendNext(SenderCounters& counters) {
+        next_due_ns_ += interval_ns_;
+        for (int i = 0; i < options_.burst; i++) {
+            SendFrame(counters);
+        }
+    }
+
+private:
+    void SendFrame(SenderCounters& counters) {
+        const double kind = std::uniform_real_distribution<double>(0.0, 1.0)(random_);
+
+        // Rejected datagrams reuse the next frame_id, so they leave no gap in
+        // the sequence for the sequencer to count as lost
+        if (kind < options_.oversize + options_.malformed) {
+            const uint64_t frame_id = frame_id_ + 1;
+            if (kind < options_.oversize) {
+                Send(datagram_.data(), Encode(frame_id, kOversizeTrackers), counters);
+                Add(counters.oversized);
+            } else {
+                Send(datagram_.data(), Corrupt(Encode(frame_id, options_.trackers)), counters);
+                Add(counters.malformed);
+            }
+            return;
+        }
+
+        const uint64_t frame_id = ++frame_id_;
+        if (held_size_ == 0 && kind < options_.oversize + options_.malformed + options_.reorder) {
+            // Hold this frame back and send it after the next one, which makes it late
+            held_size_ = Encode(frame_id, options_.trackers);
+            if (held_.size() < held_size_) {
+                held_.resize(held_size_);
+            }
+            std::memcpy(held_.data(), datagram_.data(), held_size_);
+        } else {
+            Send(datagram_.data(), Encode(frame_id, options_.trackers), counters);
+            Add(counters.valid);
+            if (held_size_ != 0) {
+                Send(held_.data(), held_size_, counters);
+                Add(counters.reordered);
+                held_size_ = 0;
+            }
+        }
+    }
+
+    // Walking-in-place motion: every tracker bobs and sways at the step rate
+    // with its own phase, and the body turns slowly
+    void FillFrame(uint64_t frame_id, int tracker_count) {
+        const double t = frame_id / options_.rate_hz;
+        const int64_t now_us = UnixNowUs();
+        frame_.frame_id = frame_id;
+        frame_.timestamp_us = static_cast<uint64_t>(now_us);
+        frame_.source_id = source_id_;
+        frame_.is_calibrated = true;
+        frame_.system_fps = static_cast<float>(options_.rate_hz);
+        frame_.tracker_count = static_cast<uint32_t>(tracker_count);
+
+        const double step_rad_s = 2.0 * 3.14159265358979 * 1.8;
+        const double yaw = 0.3 * t;
+        yolovr::TrackerPoseArrays& poses = frame_.poses;
+        for (int i = 0; i < tracker_count; i++) {
+            const double phase = step_rad_s * t + 0.5 * i;
+            const float side = (i % 2 == 0) ? -0.15f : 0.15f;
+            poses.tracker_id[i] = static_cast<uint32_t>(i);
+            poses.is_tracking[i] = 1;
+            poses.has_velocity[i] = 1;
+            poses.has_angular_velocity[i] = 1;
+            poses.confidence[i] = 0.8f + 0.2f * static_cast<float>(std::sin(0.7 * t + i) * 0.5 + 0.5);
+            poses.timestamp_us[i] = static_cast<uint64_t>(now_us);
+            poses.position[0][i] = side + 0.03f * static_cast<float>(std::sin(phase));
+            poses.position[1][i] = 1.6f - 0.12f * (i % 12) + 0.04f * static_cast<float>(std::sin(2.0 * phase));
+            poses.position[2][i] = 0.1f * static_cast<float>(std::cos(phase));
+            poses.rotation[0][i] = 0.0f;
+            poses.rotation[1][i] = static_cast<float>(std::sin(0.5 * yaw));
+            poses.rotation[2][i] = 0.0f;
+            poses.rotation[3][i] = static_cast<float>(std::cos(0.5 * yaw));
+            poses.velocity[0][i] = 0.03f * static_cast<float>(step_rad_s * std::cos(phase));
+            poses.velocity[1][i] = 0.08f * static_cast<float>(step_rad_s * std::cos(2.0 * phase));
+            poses.velocity[2][i] = -0.1f * static_cast<float>(step_rad_s * std::sin(phase));
+            poses.angular_velocity[0][i] = 0.0f;
+            poses.angular_velocity[1][i] = 0.3f;
+            poses.angular_velocity[2][i] = 0.0f;
+        }
+    }
+
+    // Encode frame frame_id with tracker_count trackers into datagram_
+    size_t Encode(uint64_t frame_id, int tracker_count) {
+        const int filled = tracker_count < static_cast<int>(yolovr::kMaxTrackersPerFrame)
+                               ? tracker_count : static_cast<int>(yolovr::kMaxTrackersPerFrame);
+        FillFrame(frame_id, filled);
+
+        if (options_.format == Format::Binary) {
+            size_t size = yolovr::EncodeBinaryFrame(frame_, datagram_.data(), datagram_.size());
+            // Oversized: repeat the last record and claim them all in the header
+            for (int i = filled; i < tracker_count; i++) {
+                std::memcpy(datagram_.data() + size, datagram_.data() + size - yolovr::kBinaryRecordSize,
+                            yolovr::kBinaryRecordSize);
+                size += yolovr::kBinaryRecordSize;
+            }
+            const uint16_t count = static_cast<uint16_t>(tracker_count);
+            std::memcpy(datagram_.data() + yolovr::binary_header::kTrackerCount, &count, sizeof(count));
+            return size;
+        }
+
+        message_.Clear();
+        message_.set_frame_id(frame_.frame_id);
+        message_.set_timestamp(frame_.timestamp_us);
+        message_.set_source_id(frame_.source_id);
+        message_.set_system_name("yolovr_load");
+        message_.set_system_fps(frame_.system_fps);
+        message_.set_is_calibrated(frame_.is_calibrated);
+        const yolovr::TrackerPoseArrays& poses = frame_.poses;
+        for (int n = 0; n < tracker_count; n++) {
+            const int i = n < filled ? n : filled - 1;
+            yolovr::TrackerPose* pose = message_.add_trackers();
+            pose->set_tracker_id(static_cast<uint32_t>(n));
+            pose->mutable_position()->set_x(poses.position[0][i]);
+            pose->mutable_position()->set_y(poses.position[1][i]);
+            pose->mutable_position()->set_z(poses.position[2][i]);
+            pose->mutable_rotation()->set_x(poses.rotation[0][i]);
+            pose->mutable_rotation()->set_y(poses.rotation[1][i]);
+            pose->mutable_rotation()->set_z(poses.rotation[2][i]);
+            pose->mutable_rotation()->set_w(poses.rotation[3][i]);
+            pose->mutable_velocity()->set_x(poses.velocity[0][i]);
+            pose->mutable_velocity()->set_y(poses.velocity[1][i]);
+            pose->mutable_velocity()->set_z(poses.velocity[2][i]);
+            pose->mutable_angular_velocity()->set_y(poses.angular_velocity[1][i]);
+            pose->set_is_tracking(true);
+            pose->set_confidence(poses.confidence[i]);
+            pose->set_timestamp(poses.timestamp_us[i]);
+        }
+        const size_t size = message_.ByteSizeLong();
+        if (size > datagram_.size()) {
+            datagram_.resize(size);
+        }
+        message_.SerializeToArray(datagram_.data(), static_cast<int>(size));
+        return size;
+    }
+
+    // Break the frame in datagram_ so the decoder must reject it
+    size_t Corrupt(size_t size) {
+        if (options_.format == Format::Binary) {
+            // Cut off in the middle of the first record
+            return yolovr::kBinaryHeaderSize + yolovr::kBinaryRecordSize / 2;
+        }
+        // Field 1 with wire type 7, which does not exist
+        datagram_[0] = 0x0F;
+        return size;
+    }
+
+    void Send(const uint8_t* data, size_t size, SenderCounters& counters) {
+        if (sendto(socket_, reinterpret_cast<const char*>(data), static_cast<int>(size), 0,
+                   reinterpret_cast<const sockaddr*>(&destination_), sizeof(destination_)) < 0) {
+            Add(counters.send_errors);
+        }
+    }
+
+    uint32_t source_id_;
+    const Options& options_;
+    socket_t socket_;
+    sockaddr_in destination_;
+    std::mt19937 random_;
+    uint64_t frame_id_;
+    int64_t interval_ns_;
+    int64_t next_due_ns_;
+    yolovr::TrackerFrameSnapshot frame_;
+    yolovr::TrackerFrame message_;
+    std::vector<uint8_t> datagram_;
+    std::vector<uint8_t> held_;
+    size_t held_size_ = 0;
+};
+
+// Sends for a share of the sources, each on its own schedule, until stop
+void SenderThreadFunction(std::vector<std::unique_ptr<SimulatedSource>>* sources, SenderCounters* counters,
+                          const std::atomic<bool>* stop) {
+    const int64_t cpu_start_ns = ThreadCpuNs();
+    const int64_t start_ns = SteadyNowNs();
+    for (auto& source : *sources) {
+        source->Schedule(start_ns);
+    }
+
+    while (!stop->load(std::memory_order_relaxed)) {
+        SimulatedSource* due = nullptr;
+        for (auto& source : *sources) {
+            if (!due || source->NextDueNs() < due->NextDueNs()) {
+                due = source.get();
+            }
+        }
+        // Sleep until shortly before the deadline, then spin the rest, so high
+        // rates keep their spacing without burning a core at low rates
+        const int64_t wait_ns = due->NextDueNs() - SteadyNowNs();
+        if (wait_ns > 200000) {
+            std::this_thread::sleep_for(std::chrono::nanoseconds(wait_ns - 100000));
+            continue;
+        }
+        while (SteadyNowNs() < due->NextDueNs()) {
+            std::this_thread::yield();
+        }
+        due->SendNext(*counters);
+        counters->cpu_ns.store(ThreadCpuNs() - cpu_start_ns, std::memory_order_relaxed);
+    }
+}
+
+// PosePublisher's per-frame work without devices, timing each frame from the
+// receiver waking up (and from the sender) to the end of the demux
+class Publisher {
+public:
+    explicit Publisher(yolovr::TrackerDataReceiver* receiver)
+        : receiver_(receiver)
+        , frame_{}
+        , frames_(0)
+    {
+        fusion_.SetMaxAge(100000000);
+    }
+
+    void Start() {
+        running_.store(true);
+        thread_ = std::thread(&Publisher::ThreadFunction, this);
+    }
+
+    void Stop() {
+        running_.store(false);
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    uint64_t Frames() const { return frames_.load(std::memory_order_relaxed); }
+
+    yolovr::LatencyHistogram arrival_to_demux[2];   // [0] since the last report, [1] whole run
+    yolovr::LatencyHistogram sender_to_demux[2];
+
+private:
+    void ThreadFunction() {
+        uint64_t last_sequence = 0;
+        while (running_.load(std::memory_order_relaxed)) {
+            if (!receiver_->WaitForNewFrame(last_sequence, std::chrono::milliseconds(5))) {
+                continue;
+            }
+            const size_t source_count = receiver_->GetSourceFrames(fusion_.Sources(), yolovr::SourceFusion::kMaxSources);
+            if (!fusion_.Fuse(source_count, SteadyNowNs(), frame_)) {
+                continue;
+            }
+            filter_bank_.Apply(frame_);
+            slot_table_.Demux(frame_);
+
+            const int64_t demux_ns = SteadyNowNs();
+            const int64_t demux_unix_us = UnixNowUs();
+            for (auto& histogram : arrival_to_demux) {
+                histogram.Record(static_cast<uint64_t>(demux_ns - frame_.arrival_time_ns));
+            }
+            // The fused frame has no sender timestamp; every pose keeps its own
+            const int64_t sent_us = static_cast<int64_t>(frame_.poses.timestamp_us[0]);
+            if (frame_.tracker_count > 0 && sent_us != 0) {
+                for (auto& histogram : sender_to_demux) {
+                    histogram.Record(static_cast<uint64_t>(demux_unix_us - sent_us) * 1000);
+                }
+            }
+            frames_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    yolovr::TrackerDataReceiver* receiver_;
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+    yolovr::SourceFusion fusion_;
+    yolovr::PoseFilterBank filter_bank_;
+    yolovr::TrackerSlotTable slot_table_;
+    yolovr::TrackerFrameSnapshot frame_;
+    std::atomic<uint64_t> frames_;
+};
+
+struct Totals {
+    uint64_t sent_valid;
+    uint64_t sent_reordered;
+    uint64_t sent_malformed;
+    uint64_t sent_oversized;
+    uint64_t send_errors;
+    int64_t sender_cpu_ns;
+};
+
+Totals SumSenders(const std::vector<std::unique_ptr<SenderCounters>>& counters) {
+    Totals totals = {};
+    for (const auto& c : counters) {
+        totals.sent_valid += c->valid.load(std::memory_order_relaxed);
+        totals.sent_reordered += c->reordered.load(std::memory_order_relaxed);
+        totals.sent_malformed += c->malformed.load(std::memory_order_relaxed);
+        totals.sent_oversized += c->oversized.load(std::memory_order_relaxed);
+        totals.send_errors += c->send_errors.load(std::memory_order_relaxed);
+        totals.sender_cpu_ns += c->cpu_ns.load(std::memory_order_relaxed);
+    }
+    return totals;
+}
+
+struct Snapshot {
+    double time_s;
+    Totals sent;
+    yolovr::TrackerDataReceiver::Stats received;
+    uint64_t published;
+    int64_t process_cpu_ns;
+};
+
+void PrintReport(const char* label, const Snapshot& from, const Snapshot& to, yolovr::LatencyHistogram& arrival,
+                 yolovr::LatencyHistogram& sender) {
+    const double seconds = to.time_s - from.time_s;
+    const uint64_t sent = (to.sent.sent_valid + to.sent.sent_reordered + to.sent.sent_malformed + to.sent.sent_oversized) -
+                          (from.sent.sent_valid + from.sent.sent_reordered + from.sent.sent_malformed + from.sent.sent_oversized);
+    // In-order valid frames are the ones the receiver should have accepted
+    const uint64_t expected = to.sent.sent_valid - from.sent.sent_valid;
+    const uint64_t received = to.received.frames_received - from.received.frames_received;
+    const uint64_t missing = expected > received ? expected - received : 0;
+    const uint64_t wakeups = to.received.wakeups - from.received.wakeups;
+    const int64_t receive_cpu_ns = (to.process_cpu_ns - from.process_cpu_ns) -
+                                   (to.sent.sender_cpu_ns - from.sent.sender_cpu_ns);
+
+    const yolovr::LatencyHistogram::Summary a = arrival.Summarize();
+    const yolovr::LatencyHistogram::Summary s = sender.Summarize();
+    std::printf("%s %7.1fs  sent %8.0f/s  received %8.0f/s  published %8.0f/s  missing %6.3f%%  "
+                "kernel drops %llu  lost %llu  parse errors %llu  reordered %llu  cpu %.2f us/frame\n"
+                "    arrival->demux p50 %.1f p99 %.1f max %.1f us   sender->demux p50 %.1f p99 %.1f max %.1f us   "
+                "arrival->wakeup mean %.2f us   wakeup->parse mean %.2f us   spin wakeups %.1f%%\n",
+                label, to.time_s, seconds > 0 ? sent / seconds : 0.0, seconds > 0 ? received / seconds : 0.0,
+                seconds > 0 ? (to.published - from.published) / seconds : 0.0,
+                expected > 0 ? 100.0 * missing / expected : 0.0,
+                static_cast<unsigned long long>(to.received.kernel_drops - from.received.kernel_drops),
+                static_cast<unsigned long long>(to.received.frames_lost - from.received.frames_lost),
+                static_cast<unsigned long long>(to.received.parse_errors - from.received.parse_errors),
+                static_cast<unsigned long long>(to.received.frames_reordered - from.received.frames_reordered),
+                received > 0 ? receive_cpu_ns / 1e3 / received : 0.0,
+                a.p50_ns / 1e3, a.p99_ns / 1e3, a.max_ns / 1e3, s.p50_ns / 1e3, s.p99_ns / 1e3, s.max_ns / 1e3,
+                received > 0 ? (to.received.arrival_to_wakeup_ns_total - from.received.arrival_to_wakeup_ns_total) / 1e3 / received : 0.0,
+                received > 0 ? (to.received.wakeup_to_parse_ns_total - from.received.wakeup_to_parse_ns_total) / 1e3 / received : 0.0,
+                wakeups > 0 ? 100.0 * (to.received.spin_wakeups - from.received.spin_wakeups) / wakeups : 0.0);
+    std::fflush(stdout);
+}
+
+bool ParseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; i += 2) {
+        if (i + 1 >= argc) {
+            return false;
+        }
+        const char* name = argv[i];
+        const char* value = argv[i + 1];
+        if (std::strcmp(name, "--sources") == 0) {
+            options.sources = std::atoi(value);
+        } else if (std::strcmp(name, "--trackers") == 0) {
+            options.trackers = std::atoi(value);
+        } else if (std::strcmp(name, "--rate") == 0) {
+            options.rate_hz = std::atof(value);
+        } else if (std::strcmp(name, "--duration") == 0) {
+            options.duration_s = std::atof(value);
+        } else if (std::strcmp(name, "--format") == 0) {
+            if (std::strcmp(value, "binary") == 0) {
+                options.format = Format::Binary;
+            } else if (std::strcmp(value, "protobuf") == 0) {
+                options.format = Format::Protobuf;
+            } else {
+                return false;
+            }
+        } else if (std::strcmp(name, "--burst") == 0) {
+            options.burst = std::atoi(value);
+        } else if (std::strcmp(name, "--malformed") == 0) {
+            options.malformed = std::atof(value);
+        } else if (std::strcmp(name, "--reorder") == 0) {
+            options.reorder = std::atof(value);
+        } else if (std::strcmp(name, "--oversize") == 0) {
+            options.oversize = std::atof(value);
+        } else if (std::strcmp(name, "--threads") == 0) {
+            options.threads = std::atoi(value);
+        } else if (std::strcmp(name, "--shards") == 0) {
+            options.shards = std::atoi(value);
+        } else if (std::strcmp(name, "--batch") == 0) {
+            options.batch = std::atoi(value) != 0;
+        } else if (std::strcmp(name, "--rcvbuf") == 0) {
+            options.receive_buffer_bytes = std::atoi(value);
+        } else if (std::strcmp(name, "--low-latency") == 0) {
+            options.low_latency = std::atoi(value) != 0;
+        } else if (std::strcmp(name, "--receiver-cpu") == 0) {
+            options.receiver_cpu = std::atoi(value);
+        } else if (std::strcmp(name, "--port") == 0) {
+            options.port = static_cast<uint16_t>(std::atoi(value));
+        } else if (std::strcmp(name, "--report") == 0) {
+            options.report_interval_s = std::atof(value);
+        } else if (std::strcmp(name, "--seed") == 0) {
+            options.seed = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+        } else {
+            return false;
+        }
+    }
+    return options.sources > 0 && options.trackers > 0 &&
+           options.trackers <= static_cast<int>(yolovr::kMaxTrackersPerFrame) && options.rate_hz > 0.0 &&
+           options.burst > 0 && options.threads > 0 && options.report_interval_s > 0.0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!ParseOptions(argc, argv, options)) {
+        std::fprintf(stderr,
+                     "usage: %s [--sources N] [--trackers M] [--rate Hz] [--duration s] [--format binary|protobuf]\n"
+                     "       [--burst N] [--malformed f] [--reorder f] [--oversize f] [--threads N] [--shards N] [--batch 0|1]\n"
+                     "       [--rcvbuf bytes] [--low-latency 0|1] [--receiver-cpu N] [--port N] [--report s] [--seed N]\n",
+                     argv[0]);
+        return 2;
+    }
+    if (options.threads > options.sources) {
+        options.threads = options.sources;
+    }
+    std::signal(SIGINT, OnInterrupt);
+
+    yolovr::TrackerDataReceiver receiver("127.0.0.1", options.port);
+    receiver.SetShardCount(static_cast<size_t>(options.shards));
+    receiver.SetBatchReceive(options.batch);
+    receiver.SetReceiveBufferSize(static_cast<size_t>(options.receive_buffer_bytes));
+    yolovr::LowLatencySettings low_latency;
+    low_latency.enabled = options.low_latency;
+    low_latency.receiver_cpu = options.receiver_cpu;
+    receiver.SetLowLatency(low_latency);
+    if (!receiver.Start()) {
+        return 1;
+    }
+    Publisher publisher(&receiver);
+    publisher.Start();
+
+    // Sources are dealt round-robin to the sender threads; source_ids start at 1
+    std::vector<std::vector<std::unique_ptr<SimulatedSource>>> thread_sources(options.threads);
+    for (int i = 0; i < options.sources; i++) {
+        std::unique_ptr<SimulatedSource> source(new SimulatedSource(static_cast<uint32_t>(i + 1), options));
+        if (!source->IsOpen()) {
+            std::fprintf(stderr, "Failed to create a sender socket\n");
+            return 1;
+        }
+        thread_sources[i % options.threads].push_back(std::move(source));
+    }
+
+    std::printf("%d sources x %d trackers at %.0f Hz (%.0f frames/s), %s, %d sender threads, %d shards%s%s\n",
+                options.sources, options.trackers, options.rate_hz, options.sources * options.rate_hz,
+                options.format == Format::Binary ? "binary" : "protobuf", options.threads, options.shards,
+                options.batch ? ", batch receive" : "", options.low_latency ? ", low latency" : "");
+    std::fflush(stdout);
+
+    std::atomic<bool> stop(false);
+    std::vector<std::unique_ptr<SenderCounters>> counters;
+    std::vector<std::thread> senders;
+    for (int i = 0; i < options.threads; i++) {
+        counters.emplace_back(new SenderCounters());
+        senders.emplace_back(SenderThreadFunction, &thread_sources[i], counters.back().get(), &stop);
+    }
+
+    const int64_t start_ns = SteadyNowNs();
+    auto take_snapshot = [&]() {
+        Snapshot snapshot;
+        snapshot.time_s = (SteadyNowNs() - start_ns) / 1e9;
+        snapshot.sent = SumSenders(counters);
+        snapshot.received = receiver.GetStats();
+        snapshot.published = publisher.Frames();
+        snapshot.process_cpu_ns = ProcessCpuNs();
+        return snapshot;
+    };
+    const Snapshot first = take_snapshot();
+    Snapshot last = first;
+
+    double next_report_s = options.report_interval_s;
+    while (!g_interrupted.load() && (options.duration_s <= 0.0 || last.time_s < options.duration_s)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        const double elapsed_s = (SteadyNowNs() - start_ns) / 1e9;
+        if (elapsed_s < next_report_s && (options.duration_s <= 0.0 || elapsed_s < options.duration_s)) {
+            continue;
+        }
+        const Snapshot now = take_snapshot();
+        PrintReport("interval", last, now, publisher.arrival_to_demux[0], publisher.sender_to_demux[0]);
+        publisher.arrival_to_demux[0].Reset();
+        publisher.sender_to_demux[0].Reset();
+        last = now;
+        next_report_s += options.report_interval_s;
+    }
+
+    stop.store(true);
+    for (auto& sender : senders) {
+        sender.join();
+    }
+    // Let the last datagrams drain before counting
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    const Snapshot end = take_snapshot();
+    publisher.Stop();
+    receiver.Stop();
+
+    PrintReport("total   ", first, end, publisher.arrival_to_demux[1], publisher.sender_to_demux[1]);
+    std::printf("sent %llu valid, %llu reordered, %llu malformed, %llu oversized, %llu send errors; "
+                "sender cpu %.2f us/datagram including pacing\n",
+                static_cast<unsigned long long>(end.sent.sent_valid),
+                static_cast<unsigned long long>(end.sent.sent_reordered),
+                static_cast<unsigned long long>(end.sent.sent_malformed),
+                static_cast<unsigned long long>(end.sent.sent_oversized),
+                static_cast<unsigned long long>(end.sent.send_errors),
+                end.sent.sender_cpu_ns / 1e3 /
+                    std::max<uint64_t>(1, end.sent.sent_valid + end.sent.sent_reordered +
+                                              end.sent.sent_malformed + end.sent.sent_oversized));
+
+    char stats[2048];
+    receiver.FormatStatsReport(stats, sizeof(stats));
+    std::printf("%s\n", stats);
+
+    if (end.received.kernel_drops == first.received.kernel_drops && end.sent.send_errors == 0 &&
+        end.received.frames_lost != first.received.frames_lost) {
+        std::printf("FAIL: %llu frames counted as lost without kernel drops or send errors\n",
+                    static_cast<unsigned long long>(end.received.frames_lost - first.received.frames_lost));
+        return 3;
+    }
+    return 0;
+}
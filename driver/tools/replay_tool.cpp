@@ -0,0 +1,155 @@
+//============ Copyright (c) YoloVr Project, All rights reserved. ============
+// Replays a capture file (capture_path setting) through the driver's frame
+// pipeline without SteamVR: TrackerDataReceiver decode and sequencing, source
+// fusion, the smoothing filter and the tracker slot table, all on this thread.
+//
+//   yolovr_replay <capture file> [--speed <factor>] [--smoothing <factor>]
+//
+// --speed 0 (the default) replays as fast as possible and reports throughput;
+// 1 keeps the recorded timing. The pose digest is a hash of every demultiplexed
+// pose, so two runs of the same capture through the same code print the same
+// digest at --speed 0 with a single source.
+
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#include "datagram_capture.h"
+#include "pose_filter_bank.h"
+#include "source_fusion.h"
+#include "tracker_data_receiver.h"
+#include "tracker_slot_table.h"
+
+// The driver logs through vrserver; print to stderr instead
+void DriverLog(const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    std::vfprintf(stderr, format, args);
+    std::fputc('\n', stderr);
+    va_end(args);
+}
+
+namespace {
+
+int64_t SteadyNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// FNV-1a over the bytes of value
+void HashBytes(uint64_t& hash, const void* value, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(value);
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+}
+
+// Receiver that runs the publisher's per-frame work whenever a datagram is
+// published, so the replay drives the whole pipeline
+class PipelineReplay {
+public:
+    explicit PipelineReplay(float smoothing_factor) : frame_{}, pipeline_ns_(0), frames_(0), digest_(1469598103934665603ull) {
+        yolovr::FilterSettings filter;
+        filter.smoothing_factor = smoothing_factor;
+        filter_bank_.Configure(filter);
+    }
+
+    void OnFramePublished(const yolovr::TrackerDataReceiver& receiver) {
+        const int64_t start_ns = SteadyNowNs();
+        const size_t source_count = receiver.GetSourceFrames(fusion_.Sources(), yolovr::SourceFusion::kMaxSources);
+        if (!fusion_.Fuse(source_count, start_ns, frame_)) {
+            return;
+        }
+        filter_bank_.Apply(frame_);
+        slot_table_.Demux(frame_);
+        pipeline_ns_ += SteadyNowNs() - start_ns;
+        frames_++;
+
+        for (uint32_t i = 0; i < frame_.tracker_count; i++) {
+            yolovr::TrackerSlot slot;
+            if (slot_table_.Read(frame_.poses.tracker_id[i], slot)) {
+                HashBytes(digest_, slot.pose.position, sizeof(slot.pose.position));
+                HashBytes(digest_, slot.pose.rotation, sizeof(slot.pose.rotation));
+            }
+        }
+    }
+
+    uint64_t Frames() const { return frames_; }
+    int64_t PipelineNs() const { return pipeline_ns_; }
+    uint64_t Digest() const { return digest_; }
+
+private:
+    yolovr::SourceFusion fusion_;
+    yolovr::PoseFilterBank filter_bank_;
+    yolovr::TrackerSlotTable slot_table_;
+    yolovr::TrackerFrameSnapshot frame_;
+    int64_t pipeline_ns_;
+    uint64_t frames_;
+    uint64_t digest_;
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <capture file> [--speed <factor>] [--smoothing <factor>]\n", argv[0]);
+        return 2;
+    }
+
+    float speed = 0.0f;
+    float smoothing_factor = 0.5f;
+    for (int i = 2; i + 1 < argc; i += 2) {
+        if (std::strcmp(argv[i], "--speed") == 0) {
+            speed = static_cast<float>(std::atof(argv[i + 1]));
+        } else if (std::strcmp(argv[i], "--smoothing") == 0) {
+            smoothing_factor = static_cast<float>(std::atof(argv[i + 1]));
+        }
+    }
+
+    yolovr::TrackerDataReceiver receiver;
+    // Captured sessions may be older than the default source max age once
+    // replayed slower than recorded
+    receiver.SetSourceMaxAge(std::chrono::milliseconds(1000));
+
+    yolovr::DatagramCaptureReader reader;
+    if (!reader.Open(argv[1])) {
+        return 1;
+    }
+
+    PipelineReplay pipeline(smoothing_factor);
+    const int64_t start_ns = SteadyNowNs();
+    int64_t first_arrival_ns = 0;
+    uint64_t datagrams = 0;
+
+    size_t offset = reader.FirstOffset();
+    yolovr::DatagramCaptureReader::Record record;
+    while (reader.Next(offset, record)) {
+        if (datagrams == 0) {
+            first_arrival_ns = record.arrival_time_ns;
+        }
+        // Same pacing as CaptureReplay
+        if (speed > 0.0f) {
+            const int64_t due_ns = start_ns + static_cast<int64_t>((record.arrival_time_ns - first_arrival_ns) / speed);
+            std::this_thread::sleep_until(std::chrono::steady_clock::time_point(std::chrono::nanoseconds(due_ns)));
+        }
+        if (receiver.InjectDatagram(record.data, record.size)) {
+            pipeline.OnFramePublished(receiver);
+        }
+        datagrams++;
+    }
+    const double duration_s = (SteadyNowNs() - start_ns) / 1e9;
+
+    char stats[2048];
+    receiver.FormatStatsReport(stats, sizeof(stats));
+    std::printf("datagrams %llu, frames %llu in %.3f s (%.0f datagrams/s)\n",
+                static_cast<unsigned long long>(datagrams), static_cast<unsigned long long>(pipeline.Frames()),
+                duration_s, duration_s > 0.0 ? datagrams / duration_s : 0.0);
+    std::printf("fusion+filter+demux %.2f us per frame\n",
+                pipeline.Frames() > 0 ? pipeline.PipelineNs() / 1e3 / pipeline.Frames() : 0.0);
+    std::printf("pose digest %016llx\n", static_cast<unsigned long long>(pipeline.Digest()));
+    std::printf("%s\n", stats);
+    return 0;
+}
@@ -0,0 +1,123 @@
+"""
+Compact fixed-layout binary frame format for low-latency senders
+
+Mirrors driver/src/tracker_wire_format.h. The driver tells binary frames and
+protobuf TrackerFrame messages apart by the leading magic bytes, so both can
+be sent to the same port.
+"""
+
+import struct
+from typing import Dict, Iterable, Optional, Tuple
+
+MAGIC = b'YVRB'
+VERSION = 1
+
+# magic, version, header_size, frame_id, timestamp, source_id,
+# tracker_count, record_size, system_fps, flags
+HEADER = struct.Struct('<4sHHQQIHHfI')
+
+# tracker_id, flags, confidence, position[3], rotation[4], velocity[3],
+# angular_velocity[3], timestamp offset from the frame timestamp (us)
+RECORD = struct.Struct('<HHf3f4f3f3fi')
+
+FRAME_CALIBRATED = 1 << 0
+
+TRACKING = 1 << 0
+HAS_VELOCITY = 1 << 1
+HAS_ANGULAR_VELOCITY = 1 << 2
+
+MAX_TRACKERS = 32
+
+_ZERO3 = (0.0, 0.0, 0.0)
+
+
+def encode_binary_frame(frame_id: int,
+                        timestamp_us: int,
+                        source_id: int,
+                        trackers: Dict[int, dict],
+                        system_fps: float = 0.0,
+                        is_calibrated: bool = False) -> bytes:
+    """Encode one frame in the binary wire format
+
+    Args:
+        frame_id: Monotonically increasing frame number
+        timestamp_us: Frame timestamp in Unix microseconds
+        source_id: Identifier for the tracking system
+        trackers: Dict mapping tracker_id to the dicts TrackerFrameBuilder keeps
+                  ('position', 'rotation', 'velocity', 'angular_velocity',
+                  'confidence', 'is_tracking', optional 'timestamp')
+        system_fps: Tracking system frame rate
+        is_calibrated: Whether the tracking system is calibrated
+
+    Returns:
+        Encoded datagram
+    """
+    if len(trackers) > MAX_TRACKERS:
+        raise ValueError(f"At most {MAX_TRACKERS} trackers per frame, got {len(trackers)}")
+
+    parts = [HEADER.pack(MAGIC, VERSION, HEADER.size, frame_id, timestamp_us, source_id,
+                         len(trackers), RECORD.size, system_fps,
+                         FRAME_CALIBRATED if is_calibrated else 0)]
+
+    for tracker_id, data in trackers.items():
+        velocity: Optional[Iterable[float]] = data.get('velocity')
+        angular_velocity: Optional[Iterable[float]] = data.get('angular_velocity')
+
+        flags = TRACKING if data.get('is_tracking', True) else 0
+        if velocity is not None:
+            flags |= HAS_VELOCITY
+        if angular_velocity is not None:
+            flags |= HAS_ANGULAR_VELOCITY
+
+        timestamp_offset = data.get('timestamp', timestamp_us) - timestamp_us
+
+        parts.append(RECORD.pack(tracker_id, flags, data.get('confidence', 1.0),
+                                 *data['position'][:3],
+                                 *data.get('rotation', (0, 0, 0, 1))[:4],
+                                 *(velocity if velocity is not None else _ZERO3),
+                                 *(angular_velocity if angular_velocity is not None else _ZERO3),
+                                 timestamp_offset))
+
+    return b''.join(parts)
+
+
+def is_binary_frame(data: bytes) -> bool:
+    """Check whether a datagram uses the binary format"""
+    return data[:len(MAGIC)] == MAGIC
+
+
+def decode_binary_frame(data: bytes) -> Tuple[dict, Dict[int, dict]]:
+    """Decode a binary frame, mainly for tests and tooling
+
+    Returns:
+        (header dict, dict mapping tracker_id to tracker dict)
+    """
+    (magic, version, header_size, frame_id, timestamp_us, source_id,
+     tracker_count, record_size, system_fps, flags) = HEADER.unpack_from(data, 0)
+    if magic != MAGIC:
+        raise ValueError("Not a binary tracker frame")
+    if version != VERSION:
+        raise ValueError(f"Unsupported binary frame version {version}")
+
+    header = {
+        'frame_id': frame_id,
+        'timestamp': timestamp_us,
+        'source_id': source_id,
+        'system_fps': system_fps,
+        'is_calibrated': bool(flags & FRAME_CALIBRATED),
+    }
+
+    trackers = {}
+    for i in range(tracker_count):
+        fields = RECORD.unpack_from(data, header_size + i * record_size)
+        tracker_id, record_flags, confidence = fields[0:3]
+        trackers[tracker_id] = {
+            'position': fields[3:6],
+            'rotation': fields[6:10],
+            'velocity': fields[10:13] if record_flags & HAS_VELOCITY else None,
+            'angular_velocity': fields[13:16] if record_flags & HAS_ANGULAR_VELOCITY else None,
+            'confidence': confidence,
+            'is_tracking': bool(record_flags & TRACKING),
+            'timestamp': timestamp_us + fields[16],
+        }
+    return header, trackers
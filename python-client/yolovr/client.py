@@ -14,22 +14,46 @@ except ImportError:
     except ImportError:
         raise ImportError("tracker_data_pb2 not found. Run scripts/generate_proto.py first.")
 
+from .clock_sync import ClockSyncResponder
 from .frame import TrackerFrameBuilder
+from .quantized_format import QuantizedFrameEncoder
+
+
+WIRE_FORMAT_PROTOBUF = 'protobuf'
+WIRE_FORMAT_BINARY = 'binary'
+WIRE_FORMAT_QUANTIZED = 'quantized'
 
 
 class TrackerClient:
     """High-level client for sending tracker data to YoloVr via UDP"""
     
-    def __init__(self, host: str = 'localhost', port: int = 9999):
+    def __init__(self, host: str = 'localhost', port: int = 9999,
+                 wire_format: str = WIRE_FORMAT_PROTOBUF,
+                 quantized_encoder: Optional[QuantizedFrameEncoder] = None,
+                 answer_clock_sync: bool = True):
         """Initialize tracker client
         
         Args:
             host: Target hostname or IP address
             port: Target UDP port
+            wire_format: 'protobuf' (TrackerFrame message), 'binary'
+                         (compact fixed-layout format for low-latency senders)
+                         or 'quantized' (keyframes and delta frames for
+                         bandwidth-constrained links such as Wi-Fi)
+            quantized_encoder: Keyframe interval, thresholds and steps for the
+                               'quantized' format (defaults if omitted)
+            answer_clock_sync: Answer the driver's clock sync pings before
+                               each frame, so it can age poses from their
+                               timestamps rather than their arrival
         """
+        if wire_format not in (WIRE_FORMAT_PROTOBUF, WIRE_FORMAT_BINARY, WIRE_FORMAT_QUANTIZED):
+            raise ValueError(f"Unknown wire format: {wire_format}")
         self.host = host
         self.port = port
+        self.wire_format = wire_format
+        self.quantized_encoder = quantized_encoder or QuantizedFrameEncoder()
         self.socket = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        self.clock_sync = ClockSyncResponder(self.socket) if answer_clock_sync else None
         self.frame_id = 0
         self.source_id = 1
         self.system_name = "YoloVr Python Client"
@@ -64,8 +88,14 @@ class TrackerClient:
             True if sent successfully, False on error
         """
         try:
-            frame = frame_builder.build()
-            data = frame.SerializeToString()
+            if self.clock_sync:
+                self.clock_sync.poll()
+            if self.wire_format == WIRE_FORMAT_BINARY:
+                data = frame_builder.build_binary()
+            elif self.wire_format == WIRE_FORMAT_QUANTIZED:
+                data = frame_builder.build_quantized(self.quantized_encoder)
+            else:
+                data = frame_builder.build().SerializeToString()
             self.socket.sendto(data, (self.host, self.port))
             self.frame_id += 1
             return True
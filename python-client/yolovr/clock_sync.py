@@ -0,0 +1,111 @@
+"""
+Clock sync responder
+
+The driver periodically sends every sender a small ping; answering it with a
+pong stamped with the sender's clock (the clock of the frame timestamps) lets
+the driver estimate the offset between the two clocks and age each pose from
+when it was sampled rather than from when it arrived. Mirrors the clock sync
+messages in driver/src/tracker_wire_format.h.
+"""
+
+import select
+import socket
+import struct
+import sys
+import time
+from typing import Optional, Tuple
+
+PING_MAGIC = b'YVRP'
+PONG_MAGIC = b'YVRO'
+VERSION = 1
+
+# magic, version, size, source_id, sequence, origin time (driver clock, opaque)
+PING = struct.Struct('<4sHHIIq')
+# ping fields, receive time, transmit time (sender clock, Unix microseconds)
+PONG = struct.Struct('<4sHHIIqQQ')
+
+# Linux value, for Pythons that do not export the constant
+_SO_TIMESTAMPNS = getattr(socket, 'SO_TIMESTAMPNS', 35)
+_TIMESPEC = struct.Struct('@qq')
+
+
+def _now_us() -> int:
+    return time.time_ns() // 1000
+
+
+def decode_ping(data: bytes) -> Optional[Tuple[int, int, int]]:
+    """(source_id, sequence, origin_time) of a ping, or None"""
+    if len(data) < PING.size or data[:4] != PING_MAGIC:
+        return None
+    magic, version, size, source_id, sequence, origin = PING.unpack_from(data)
+    if version != VERSION or size < PING.size:
+        return None
+    return source_id, sequence, origin
+
+
+def encode_pong(source_id: int, sequence: int, origin: int, receive_us: int, transmit_us: int) -> bytes:
+    return PONG.pack(PONG_MAGIC, VERSION, PONG.size, source_id, sequence, origin, receive_us, transmit_us)
+
+
+class ClockSyncResponder:
+    """Answers the driver's clock sync pings arriving on a sender's UDP socket
+
+    Call poll() regularly from the sending thread, e.g. before every frame;
+    TrackerClient does. On Linux the ping's kernel arrival time is used, so a
+    ping that waits until the next poll() does not count as network delay.
+    Elsewhere it is stamped when read, and answering promptly matters more.
+    """
+
+    def __init__(self, sock: socket.socket):
+        self.socket = sock
+        self.pongs_sent = 0
+        self.kernel_timestamps = False
+        if sys.platform.startswith('linux'):
+            try:
+                sock.setsockopt(socket.SOL_SOCKET, _SO_TIMESTAMPNS, 1)
+                self.kernel_timestamps = True
+            except OSError:
+                pass
+
+    def _receive(self) -> Optional[Tuple[bytes, int, tuple]]:
+        if self.kernel_timestamps:
+            try:
+                data, ancillary, _, address = self.socket.recvmsg(64, 64, socket.MSG_DONTWAIT)
+            except (BlockingIOError, InterruptedError):
+                return None
+            receive_us = 0
+            for level, kind, value in ancillary:
+                if level == socket.SOL_SOCKET and kind == _SO_TIMESTAMPNS and len(value) >= _TIMESPEC.size:
+                    seconds, nanoseconds = _TIMESPEC.unpack_from(value)
+                    receive_us = seconds * 1000000 + nanoseconds // 1000
+            return data, receive_us, address
+        readable, _, _ = select.select([self.socket], [], [], 0)
+        if not readable:
+            return None
+        data, address = self.socket.recvfrom(64)
+        return data, _now_us(), address
+
+    def poll(self) -> int:
+        """Answer every pending ping; returns how many were answered"""
+        answered = 0
+        while True:
+            try:
+                received = self._receive()
+            except OSError:
+                # e.g. ICMP port unreachable reported for an earlier frame
+                return answered
+            if received is None:
+                return answered
+            data, receive_us, address = received
+            ping = decode_ping(data)
+            if ping is None:
+                continue
+            transmit_us = _now_us()
+            if receive_us == 0 or receive_us > transmit_us:
+                receive_us = transmit_us
+            try:
+                self.socket.sendto(encode_pong(*ping, receive_us, transmit_us), address)
+            except OSError:
+                continue
+            answered += 1
+            self.pongs_sent += 1
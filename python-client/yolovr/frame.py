@@ -13,6 +13,9 @@ except ImportError:
     except ImportError:
         raise ImportError("tracker_data_pb2 not found. Run scripts/generate_proto.py first.")
 
+from .binary_format import encode_binary_frame
+from .quantized_format import QuantizedFrameEncoder
+
 
 class TrackerFrameBuilder:
     """Builder class for constructing TrackerFrame messages"""
@@ -146,6 +149,32 @@ class TrackerFrameBuilder:
         
         return frame
     
+    def build_binary(self) -> bytes:
+        """Build the frame in the compact fixed-layout binary format
+        
+        Returns:
+            Encoded datagram, accepted by the driver alongside protobuf frames
+        """
+        return encode_binary_frame(self.frame_id,
+                                   int(time.time() * 1_000_000),  # Microseconds
+                                   self.source_id,
+                                   self.trackers)
+    
+    def build_quantized(self, encoder: QuantizedFrameEncoder) -> bytes:
+        """Build the frame in the quantized keyframe/delta format
+        
+        Args:
+            encoder: Encoder of the stream this frame belongs to; it decides
+                     whether this is a keyframe and which trackers to send
+        
+        Returns:
+            Encoded datagram, accepted by the driver alongside protobuf frames
+        """
+        return encoder.encode(self.frame_id,
+                              int(time.time() * 1_000_000),  # Microseconds
+                              self.source_id,
+                              self.trackers)
+    
     def get_tracker_count(self) -> int:
         """Get the number of trackers in the frame
         
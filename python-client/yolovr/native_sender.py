@@ -0,0 +1,215 @@
+"""
+NativeSender - ctypes binding of the native sender library (libyolovr_sender)
+
+Encodes and sends whole frames in C++ straight from numpy arrays, one call per
+frame, instead of building them field by field in Python. Intended for
+inference loops sending many trackers at high rates. Build the library with
+-DYOLOVR_BUILD_SENDER=ON (see driver/README.md); the C interface is documented
+in driver/sender/yolovr_sender.h.
+"""
+
+import ctypes
+import ctypes.util
+import os
+from typing import Optional
+
+import numpy as np
+
+
+WIRE_FORMATS = {'protobuf': 0, 'binary': 1, 'quantized': 2}
+
+ABI_VERSION = 1
+
+SEND_OK = 0
+_SEND_ERRORS = {
+    -1: 'invalid argument',
+    -2: 'too many trackers',
+    -3: 'socket send failed',
+    -4: 'shared memory ring full (is the driver running?)',
+}
+
+_LIBRARY_NAMES = ('libyolovr_sender.so', 'libyolovr_sender.dylib', 'yolovr_sender.dll', 'libyolovr_sender.dll')
+
+_library = None
+
+
+class NativeSenderError(RuntimeError):
+    pass
+
+
+def _find_library(library_path: Optional[str]) -> str:
+    if library_path:
+        return library_path
+    from_env = os.environ.get('YOLOVR_SENDER_LIBRARY')
+    if from_env:
+        return from_env
+    found = ctypes.util.find_library('yolovr_sender')
+    if found:
+        return found
+    here = os.path.dirname(os.path.abspath(__file__))
+    for name in _LIBRARY_NAMES:
+        candidate = os.path.join(here, name)
+        if os.path.exists(candidate):
+            return candidate
+    raise NativeSenderError(
+        "libyolovr_sender not found; build it with -DYOLOVR_BUILD_SENDER=ON and "
+        "set YOLOVR_SENDER_LIBRARY or pass library_path")
+
+
+def load_library(library_path: Optional[str] = None) -> ctypes.CDLL:
+    """Load libyolovr_sender once and declare its functions"""
+    global _library
+    if _library is not None:
+        return _library
+
+    lib = ctypes.CDLL(_find_library(library_path))
+    sender_p = ctypes.c_void_p
+
+    lib.yolovr_sender_abi_version.restype = ctypes.c_uint32
+    lib.yolovr_sender_abi_version.argtypes = []
+    if lib.yolovr_sender_abi_version() < ABI_VERSION:
+        raise NativeSenderError("libyolovr_sender is older than this binding")
+
+    lib.yolovr_sender_max_trackers.restype = ctypes.c_uint32
+    lib.yolovr_sender_max_trackers.argtypes = []
+    lib.yolovr_sender_create_udp.restype = sender_p
+    lib.yolovr_sender_create_udp.argtypes = [ctypes.c_char_p, ctypes.c_uint16, ctypes.c_int]
+    lib.yolovr_sender_create_shm.restype = sender_p
+    lib.yolovr_sender_create_shm.argtypes = [ctypes.c_char_p, ctypes.c_int]
+    lib.yolovr_sender_destroy.restype = None
+    lib.yolovr_sender_destroy.argtypes = [sender_p]
+    lib.yolovr_sender_set_source.restype = None
+    lib.yolovr_sender_set_source.argtypes = [sender_p, ctypes.c_uint32, ctypes.c_float, ctypes.c_int]
+    lib.yolovr_sender_set_quantization.restype = None
+    lib.yolovr_sender_set_quantization.argtypes = [sender_p, ctypes.c_uint32, ctypes.c_float, ctypes.c_float,
+                                                   ctypes.c_float]
+    # Array arguments are plain addresses so numpy's arr.ctypes.data passes
+    # through without conversion
+    lib.yolovr_sender_send.restype = ctypes.c_int
+    lib.yolovr_sender_send.argtypes = [sender_p, ctypes.c_uint32] + [ctypes.c_void_p] * 7 + [ctypes.c_uint64]
+    for name in ('next_frame_id', 'frames_sent', 'bytes_sent', 'send_errors'):
+        function = getattr(lib, 'yolovr_sender_' + name)
+        function.restype = ctypes.c_uint64
+        function.argtypes = [sender_p]
+
+    _library = lib
+    return lib
+
+
+def _address(array: Optional[np.ndarray], dtype, columns: int, count: int, name: str):
+    """Address of array as count x columns values of dtype, and the array that owns it"""
+    if array is None:
+        return None, None
+    array = np.ascontiguousarray(array, dtype=dtype)
+    if array.size != count * columns:
+        raise ValueError(f"{name} has {array.size} values, expected {count * columns}")
+    return array.ctypes.data, array
+
+
+class NativeSender:
+    """Sends tracker frames through libyolovr_sender over UDP or shared memory"""
+
+    def __init__(self, host: str = 'localhost', port: int = 9999, wire_format: str = 'binary',
+                 shared_memory_name: Optional[str] = None, library_path: Optional[str] = None,
+                 source_id: int = 1, system_fps: float = 0.0, is_calibrated: bool = False):
+        """Create a sender
+
+        Args:
+            host: Target hostname or IP address
+            port: Target UDP port
+            wire_format: 'protobuf', 'binary' or 'quantized'
+            shared_memory_name: Write into the driver's shared memory ring with
+                                this name (its shared_memory_name setting)
+                                instead of sending UDP; Linux only
+            library_path: Path of libyolovr_sender; otherwise taken from the
+                          YOLOVR_SENDER_LIBRARY environment variable or the
+                          system library search path
+            source_id, system_fps, is_calibrated: Frame header fields
+        """
+        if wire_format not in WIRE_FORMATS:
+            raise ValueError(f"Unknown wire format: {wire_format}")
+        self._lib = load_library(library_path)
+        if shared_memory_name:
+            self._sender = self._lib.yolovr_sender_create_shm(shared_memory_name.encode(), WIRE_FORMATS[wire_format])
+        else:
+            self._sender = self._lib.yolovr_sender_create_udp(host.encode(), port, WIRE_FORMATS[wire_format])
+        if not self._sender:
+            raise NativeSenderError(f"Could not open {shared_memory_name or f'{host}:{port}'}")
+        self.max_trackers = self._lib.yolovr_sender_max_trackers()
+        self.set_source(source_id, system_fps, is_calibrated)
+
+    def set_source(self, source_id: int, system_fps: float, is_calibrated: bool):
+        """Frame header fields sent with every following frame"""
+        self._lib.yolovr_sender_set_source(self._sender, source_id, system_fps, int(is_calibrated))
+
+    def set_quantization(self, keyframe_interval: int = 30, position_threshold: float = 0.002,
+                         rotation_threshold: float = 0.0087, velocity_threshold: float = 0.02):
+        """Keyframe interval and delta thresholds of the 'quantized' format"""
+        self._lib.yolovr_sender_set_quantization(self._sender, keyframe_interval, position_threshold,
+                                                 rotation_threshold, velocity_threshold)
+
+    def send(self, positions: np.ndarray, rotations: Optional[np.ndarray] = None,
+             tracker_ids: Optional[np.ndarray] = None, velocities: Optional[np.ndarray] = None,
+             angular_velocities: Optional[np.ndarray] = None, confidences: Optional[np.ndarray] = None,
+             is_tracking: Optional[np.ndarray] = None, timestamp_us: int = 0) -> int:
+        """Send one frame
+
+        Args:
+            positions: (N, 3) positions in meters
+            rotations: (N, 4) quaternions x, y, z, w; identity if omitted
+            tracker_ids: (N,) tracker IDs; 0 .. N-1 if omitted
+            velocities: (N, 3) m/s, if known
+            angular_velocities: (N, 3) rad/s, if known
+            confidences: (N,) in [0, 1]; 1 if omitted
+            is_tracking: (N,) booleans; all tracked if omitted
+            timestamp_us: Frame time in Unix microseconds; now if 0
+
+        float32 C-contiguous arrays are passed without copying.
+
+        Returns:
+            The frame_id of the frame sent
+        """
+        if self._sender is None:
+            raise NativeSenderError("sender is closed")
+        count = len(positions)
+        position_p, positions = _address(positions, np.float32, 3, count, 'positions')
+        rotation_p, rotations = _address(rotations, np.float32, 4, count, 'rotations')
+        id_p, tracker_ids = _address(tracker_ids, np.uint32, 1, count, 'tracker_ids')
+        velocity_p, velocities = _address(velocities, np.float32, 3, count, 'velocities')
+        angular_p, angular_velocities = _address(angular_velocities, np.float32, 3, count, 'angular_velocities')
+        confidence_p, confidences = _address(confidences, np.float32, 1, count, 'confidences')
+        tracking_p, is_tracking = _address(is_tracking, np.uint8, 1, count, 'is_tracking')
+
+        frame_id = self._lib.yolovr_sender_next_frame_id(self._sender)
+        result = self._lib.yolovr_sender_send(self._sender, count, id_p, position_p, rotation_p, velocity_p,
+                                              angular_p, confidence_p, tracking_p, timestamp_us)
+        if result != SEND_OK:
+            raise NativeSenderError(f"send failed: {_SEND_ERRORS.get(result, result)}")
+        return frame_id
+
+    @property
+    def frames_sent(self) -> int:
+        return self._lib.yolovr_sender_frames_sent(self._sender) if self._sender else 0
+
+    @property
+    def bytes_sent(self) -> int:
+        return self._lib.yolovr_sender_bytes_sent(self._sender) if self._sender else 0
+
+    @property
+    def send_errors(self) -> int:
+        return self._lib.yolovr_sender_send_errors(self._sender) if self._sender else 0
+
+    def close(self):
+        if self._sender is not None:
+            self._lib.yolovr_sender_destroy(self._sender)
+            self._sender = None
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+    def __del__(self):
+        if getattr(self, '_sender', None) is not None:
+            self.close()
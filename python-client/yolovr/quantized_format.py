@@ -0,0 +1,305 @@
+"""
+Quantized keyframe/delta frame format for bandwidth-constrained links
+
+Mirrors the quantized format in driver/src/tracker_wire_format.h. Positions and
+velocities are sent as 16-bit fixed point, rotations as 32-bit smallest-three
+quaternions. Keyframes carry every tracker; delta frames in between carry only
+the trackers that moved past a threshold since the last keyframe, and the
+driver takes the rest from that keyframe. A delta frame whose keyframe was lost
+is dropped by the driver, so keyframes are sent periodically.
+"""
+
+import math
+import struct
+from typing import Dict, Iterable, Optional, Tuple
+
+from .binary_format import TRACKING, HAS_VELOCITY, HAS_ANGULAR_VELOCITY
+
+MAGIC = b'YVRQ'
+VERSION = 1
+
+# magic, version, header_size, frame_id, timestamp, keyframe_id, source_id,
+# tracker_count, record_size, system_fps, flags, position step, velocity step,
+# angular velocity step
+HEADER = struct.Struct('<4sHHQQQIHHfIfff')
+
+# tracker_id, flags, confidence, reserved, rotation (smallest three),
+# position[3], velocity[3], angular_velocity[3], timestamp offset (us)
+RECORD = struct.Struct('<BBBBI3h3h3hi')
+
+FRAME_CALIBRATED = 1 << 0
+KEYFRAME = 1 << 1
+
+DEFAULT_POSITION_STEP = 0.001           # m, +-32 m range
+DEFAULT_VELOCITY_STEP = 0.001           # m/s
+DEFAULT_ANGULAR_VELOCITY_STEP = 0.001   # rad/s
+
+MAX_TRACKERS = 32
+
+_SQRT_HALF = math.sqrt(0.5)
+_COMPONENT_MAX = 1023
+_INT16_MAX = 32767
+_ZERO3 = (0.0, 0.0, 0.0)
+
+
+def _quantize(value: float, step: float) -> int:
+    if step <= 0 or math.isnan(value):
+        return 0
+    units = round(value / step)
+    return max(-_INT16_MAX, min(_INT16_MAX, units))
+
+
+def pack_quaternion(rotation: Iterable[float]) -> int:
+    """Pack an (x, y, z, w) quaternion into 32 bits, smallest three"""
+    q = list(rotation)[:4]
+    largest = max(range(4), key=lambda axis: abs(q[axis]))
+    sign = -1.0 if q[largest] < 0 else 1.0
+
+    packed = largest << 30
+    shift = 20
+    for axis in range(4):
+        if axis == largest:
+            continue
+        unit = (sign * q[axis] / _SQRT_HALF + 1.0) * 0.5
+        unit = max(0.0, min(1.0, unit))
+        packed |= int(round(unit * _COMPONENT_MAX)) << shift
+        shift -= 10
+    return packed
+
+
+def unpack_quaternion(packed: int) -> Tuple[float, float, float, float]:
+    """Unpack a smallest-three quaternion into a unit (x, y, z, w)"""
+    largest = packed >> 30
+    q = [0.0, 0.0, 0.0, 0.0]
+    total = 0.0
+    shift = 20
+    for axis in range(4):
+        if axis == largest:
+            continue
+        units = (packed >> shift) & _COMPONENT_MAX
+        q[axis] = (units * (2.0 / _COMPONENT_MAX) - 1.0) * _SQRT_HALF
+        total += q[axis] * q[axis]
+        shift -= 10
+    q[largest] = math.sqrt(1.0 - total) if total < 1.0 else 0.0
+    if total > 1.0:
+        scale = 1.0 / math.sqrt(total)
+        q = [component * scale for component in q]
+    return tuple(q)
+
+
+def encode_quantized_frame(frame_id: int,
+                           timestamp_us: int,
+                           source_id: int,
+                           keyframe_id: int,
+                           trackers: Dict[int, dict],
+                           system_fps: float = 0.0,
+                           is_calibrated: bool = False,
+                           position_step: float = DEFAULT_POSITION_STEP,
+                           velocity_step: float = DEFAULT_VELOCITY_STEP,
+                           angular_velocity_step: float = DEFAULT_ANGULAR_VELOCITY_STEP) -> bytes:
+    """Encode the given trackers as one quantized frame
+
+    It is a keyframe when keyframe_id == frame_id. Use QuantizedFrameEncoder
+    to choose keyframes and changed trackers automatically.
+
+    Args:
+        frame_id: Monotonically increasing frame number
+        timestamp_us: Frame timestamp in Unix microseconds
+        source_id: Identifier for the tracking system
+        keyframe_id: frame_id of the keyframe this frame builds on
+        trackers: Dict mapping tracker_id (0-255) to the dicts TrackerFrameBuilder keeps
+        system_fps: Tracking system frame rate
+        is_calibrated: Whether the tracking system is calibrated
+        position_step, velocity_step, angular_velocity_step: Quantization steps
+
+    Returns:
+        Encoded datagram
+    """
+    if len(trackers) > MAX_TRACKERS:
+        raise ValueError(f"At most {MAX_TRACKERS} trackers per frame, got {len(trackers)}")
+
+    flags = FRAME_CALIBRATED if is_calibrated else 0
+    if keyframe_id == frame_id:
+        flags |= KEYFRAME
+
+    parts = [HEADER.pack(MAGIC, VERSION, HEADER.size, frame_id, timestamp_us, keyframe_id, source_id,
+                         len(trackers), RECORD.size, system_fps, flags,
+                         position_step, velocity_step, angular_velocity_step)]
+
+    for tracker_id, data in trackers.items():
+        if not 0 <= tracker_id <= 255:
+            raise ValueError(f"Quantized frames carry tracker ids 0-255, got {tracker_id}")
+        velocity: Optional[Iterable[float]] = data.get('velocity')
+        angular_velocity: Optional[Iterable[float]] = data.get('angular_velocity')
+
+        record_flags = TRACKING if data.get('is_tracking', True) else 0
+        if velocity is not None:
+            record_flags |= HAS_VELOCITY
+        if angular_velocity is not None:
+            record_flags |= HAS_ANGULAR_VELOCITY
+
+        confidence = max(0.0, min(1.0, data.get('confidence', 1.0)))
+        timestamp_offset = data.get('timestamp', timestamp_us) - timestamp_us
+
+        parts.append(RECORD.pack(tracker_id, record_flags, int(round(confidence * 255)), 0,
+                                 pack_quaternion(data.get('rotation', (0, 0, 0, 1))),
+                                 *(_quantize(v, position_step) for v in data['position'][:3]),
+                                 *(_quantize(v, velocity_step) for v in (velocity if velocity is not None else _ZERO3)),
+                                 *(_quantize(v, angular_velocity_step)
+                                   for v in (angular_velocity if angular_velocity is not None else _ZERO3)),
+                                 timestamp_offset))
+
+    return b''.join(parts)
+
+
+def _distance(a: Optional[Iterable[float]], b: Optional[Iterable[float]]) -> float:
+    if a is None or b is None:
+        return 0.0 if a is None and b is None else math.inf
+    return math.sqrt(sum((x - y) ** 2 for x, y in zip(a, b)))
+
+
+def _rotation_angle(a: Iterable[float], b: Iterable[float]) -> float:
+    dot = abs(sum(x * y for x, y in zip(a, b)))
+    return 2.0 * math.acos(min(1.0, dot))
+
+
+class QuantizedFrameEncoder:
+    """Chooses keyframes and the trackers each delta frame has to carry
+
+    One encoder per stream; it remembers the last keyframe it produced.
+    """
+
+    def __init__(self,
+                 keyframe_interval: int = 30,
+                 position_threshold: float = 0.002,
+                 rotation_threshold_deg: float = 0.5,
+                 velocity_threshold: float = 0.02,
+                 confidence_threshold: float = 0.05,
+                 position_step: float = DEFAULT_POSITION_STEP,
+                 velocity_step: float = DEFAULT_VELOCITY_STEP,
+                 angular_velocity_step: float = DEFAULT_ANGULAR_VELOCITY_STEP):
+        """Initialize the encoder
+
+        Args:
+            keyframe_interval: Frames between keyframes; bounds how long the
+                               driver drops delta frames after losing a keyframe
+            position_threshold: Movement since the keyframe (m) that puts a tracker in a delta frame
+            rotation_threshold_deg: Rotation since the keyframe (degrees) that does the same
+            velocity_threshold: Change in linear (m/s) or angular (rad/s) velocity that does the same
+            confidence_threshold: Change in confidence that does the same
+            position_step, velocity_step, angular_velocity_step: Quantization steps
+        """
+        if keyframe_interval < 1:
+            raise ValueError("keyframe_interval must be at least 1")
+        self.keyframe_interval = keyframe_interval
+        self.position_threshold = position_threshold
+        self.rotation_threshold = math.radians(rotation_threshold_deg)
+        self.velocity_threshold = velocity_threshold
+        self.confidence_threshold = confidence_threshold
+        self.position_step = position_step
+        self.velocity_step = velocity_step
+        self.angular_velocity_step = angular_velocity_step
+        self._keyframe_id: Optional[int] = None
+        self._keyframe: Dict[int, dict] = {}
+
+    def force_keyframe(self):
+        """Make the next encoded frame a keyframe"""
+        self._keyframe_id = None
+
+    def _changed(self, tracker_id: int, data: dict) -> bool:
+        base = self._keyframe.get(tracker_id)
+        if base is None:
+            return True
+        return (data.get('is_tracking', True) != base.get('is_tracking', True)
+                or abs(data.get('confidence', 1.0) - base.get('confidence', 1.0)) > self.confidence_threshold
+                or _distance(data['position'], base['position']) > self.position_threshold
+                or _rotation_angle(data.get('rotation', (0, 0, 0, 1)),
+                                   base.get('rotation', (0, 0, 0, 1))) > self.rotation_threshold
+                or _distance(data.get('velocity'), base.get('velocity')) > self.velocity_threshold
+                or _distance(data.get('angular_velocity'), base.get('angular_velocity')) > self.velocity_threshold)
+
+    def encode(self,
+               frame_id: int,
+               timestamp_us: int,
+               source_id: int,
+               trackers: Dict[int, dict],
+               system_fps: float = 0.0,
+               is_calibrated: bool = False) -> bytes:
+        """Encode a frame as a keyframe or a delta frame against the last keyframe
+
+        Args:
+            frame_id: Monotonically increasing frame number
+            timestamp_us: Frame timestamp in Unix microseconds
+            source_id: Identifier for the tracking system
+            trackers: Dict mapping tracker_id to the dicts TrackerFrameBuilder keeps
+            system_fps: Tracking system frame rate
+            is_calibrated: Whether the tracking system is calibrated
+
+        Returns:
+            Encoded datagram
+        """
+        # A tracker that disappeared can only be dropped by a keyframe
+        keyframe = (self._keyframe_id is None
+                    or frame_id < self._keyframe_id
+                    or frame_id - self._keyframe_id >= self.keyframe_interval
+                    or any(tracker_id not in trackers for tracker_id in self._keyframe))
+
+        if keyframe:
+            self._keyframe_id = frame_id
+            self._keyframe = {tracker_id: dict(data) for tracker_id, data in trackers.items()}
+            sent = trackers
+        else:
+            sent = {tracker_id: data for tracker_id, data in trackers.items() if self._changed(tracker_id, data)}
+
+        return encode_quantized_frame(frame_id, timestamp_us, source_id, self._keyframe_id, sent,
+                                      system_fps, is_calibrated,
+                                      self.position_step, self.velocity_step, self.angular_velocity_step)
+
+
+def is_quantized_frame(data: bytes) -> bool:
+    """Check whether a datagram uses the quantized format"""
+    return data[:len(MAGIC)] == MAGIC
+
+
+def decode_quantized_frame(data: bytes) -> Tuple[dict, Dict[int, dict]]:
+    """Decode one quantized frame, mainly for tests and tooling
+
+    Delta frames only hold the trackers they carry; merge them onto the
+    keyframe named by header['keyframe_id'] to get the full state.
+
+    Returns:
+        (header dict, dict mapping tracker_id to tracker dict)
+    """
+    (magic, version, header_size, frame_id, timestamp_us, keyframe_id, source_id, tracker_count,
+     record_size, system_fps, flags, position_step, velocity_step, angular_velocity_step) = HEADER.unpack_from(data, 0)
+    if magic != MAGIC:
+        raise ValueError("Not a quantized tracker frame")
+    if version != VERSION:
+        raise ValueError(f"Unsupported quantized frame version {version}")
+
+    header = {
+        'frame_id': frame_id,
+        'timestamp': timestamp_us,
+        'keyframe_id': keyframe_id,
+        'is_keyframe': bool(flags & KEYFRAME),
+        'source_id': source_id,
+        'system_fps': system_fps,
+        'is_calibrated': bool(flags & FRAME_CALIBRATED),
+    }
+
+    trackers = {}
+    for i in range(tracker_count):
+        fields = RECORD.unpack_from(data, header_size + i * record_size)
+        tracker_id, record_flags, confidence, _, rotation = fields[0:5]
+        trackers[tracker_id] = {
+            'position': tuple(v * position_step for v in fields[5:8]),
+            'rotation': unpack_quaternion(rotation),
+            'velocity': (tuple(v * velocity_step for v in fields[8:11])
+                         if record_flags & HAS_VELOCITY else None),
+            'angular_velocity': (tuple(v * angular_velocity_step for v in fields[11:14])
+                                 if record_flags & HAS_ANGULAR_VELOCITY else None),
+            'confidence': confidence / 255.0,
+            'is_tracking': bool(record_flags & TRACKING),
+            'timestamp': timestamp_us + fields[14],
+        }
+    return header, trackers